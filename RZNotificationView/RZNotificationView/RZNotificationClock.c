@@ -0,0 +1,56 @@
+//
+//  RZNotificationClock.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#if !defined(__APPLE__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "RZNotificationClock.h"
+
+#include <stddef.h>
+
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+double RZNotificationMonotonicTime(void *context)
+{
+    (void)context;
+#if defined(__APPLE__)
+    // clock_gettime is not available before iOS 10
+    static double secondsPerTick = 0.0;
+    if (secondsPerTick == 0.0) {
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+        secondsPerTick = (double)info.numer / (double)info.denom * 1e-9;
+    }
+    return (double)mach_absolute_time() * secondsPerTick;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+RZNotificationClock RZNotificationSystemClock(void)
+{
+    RZNotificationClock clock;
+    clock.now = RZNotificationMonotonicTime;
+    clock.context = NULL;
+    return clock;
+}
+
+double RZNotificationClockNow(const RZNotificationClock *clock)
+{
+    if (clock == NULL || clock->now == NULL) {
+        return RZNotificationMonotonicTime(NULL);
+    }
+    return clock->now(clock->context);
+}
@@ -0,0 +1,46 @@
+//
+//  RZNotificationClock.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationClock_h
+#define RZNotificationView_RZNotificationClock_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Clock injected in the time based components, in seconds.
+ * Tests drive them with a fake clock, the app with CACurrentMediaTime.
+ */
+typedef double (*RZNotificationClockFunction)(void *context);
+
+typedef struct {
+    RZNotificationClockFunction now;
+    void *context;
+} RZNotificationClock;
+
+/*
+ * Monotonic time in seconds
+ */
+double RZNotificationMonotonicTime(void *context);
+
+/*
+ * Clock based on RZNotificationMonotonicTime
+ */
+RZNotificationClock RZNotificationSystemClock(void);
+
+/*
+ * Read a clock, falling back on the system clock when none is set
+ */
+double RZNotificationClockNow(const RZNotificationClock *clock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+//
+//  RZNotificationColorMath.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationColorMath.h"
+
+#include <math.h>
+
+// MARK: - Kernels
+
+static double clampComponent(double value)
+{
+    return value < 0.0 ? 0.0 : (value > 1.0 ? 1.0 : value);
+}
+
+RZNotificationRGBA RZNotificationRGBAMake(double red, double green, double blue, double alpha)
+{
+    RZNotificationRGBA color = { red, green, blue, alpha };
+    return color;
+}
+
+RZNotificationRGBA RZNotificationRGBAFromHex(uint32_t rgb)
+{
+    return RZNotificationRGBAMake(((rgb >> 16) & 0xFF) / 255.0, ((rgb >> 8) & 0xFF) / 255.0, (rgb & 0xFF) / 255.0, 1.0);
+}
+
+RZNotificationRGBA RZNotificationRGBAFromComponents(const double *components, size_t count)
+{
+    if (count == 2) {
+        return RZNotificationRGBAMake(components[0], components[0], components[0], components[1]);
+    }
+    if (count == 4) {
+        return RZNotificationRGBAMake(components[0], components[1], components[2], components[3]);
+    }
+    return RZNotificationRGBAMake(0.0, 0.0, 0.0, 1.0);
+}
+
+RZNotificationRGBA RZNotificationRGBALighter(RZNotificationRGBA color, double offset, double alphaOffset)
+{
+    return RZNotificationRGBAMake(clampComponent(color.red + offset),
+                                  clampComponent(color.green + offset),
+                                  clampComponent(color.blue + offset),
+                                  clampComponent(color.alpha - alphaOffset));
+}
+
+RZNotificationRGBA RZNotificationRGBADarker(RZNotificationRGBA color, double offset, double alphaOffset)
+{
+    return RZNotificationRGBAMake(clampComponent(color.red - offset),
+                                  clampComponent(color.green - offset),
+                                  clampComponent(color.blue - offset),
+                                  clampComponent(color.alpha + alphaOffset));
+}
+
+double RZNotificationRGBAAlphaOffset(RZNotificationRGBA color, double alpha)
+{
+    return fabs(color.alpha - alpha);
+}
+
+int RZNotificationRGBAEqual(RZNotificationRGBA a, RZNotificationRGBA b)
+{
+    return a.red == b.red && a.green == b.green && a.blue == b.blue && a.alpha == b.alpha;
+}
+
+// MARK: - Palette
+
+// Constant expression versions of the kernels, for the static table
+#define RZComponent(hex, shift) ((((hex) >> (shift)) & 0xFF) / 255.0)
+#define RZUp(value, offset) ((value) + (offset) > 1.0 ? 1.0 : (value) + (offset))
+#define RZDown(value, offset) ((value) - (offset) < 0.0 ? 0.0 : (value) - (offset))
+
+#define RZPaletteColor(hex, op, offset) \
+    { op(RZComponent(hex, 16), offset), op(RZComponent(hex, 8), offset), op(RZComponent(hex, 0), offset), 1.0 }
+
+#define RZPaletteEntry(hex) {                 \
+    RZPaletteColor(hex, RZUp, 0.0),           \
+    RZPaletteColor(hex, RZUp, 0.1),           \
+    RZPaletteColor(hex, RZDown, 0.55),        \
+    RZPaletteColor(hex, RZUp, 0.9)            \
+}
+
+static const RZNotificationRGBA kPalette[RZNotificationPaletteCount][RZNotificationPaletteRoleCount] = {
+    RZPaletteEntry(0xFFBD00), // Yellow
+    RZPaletteEntry(0xB20000), // Red
+    RZPaletteEntry(0x3699C9), // Light blue
+    RZPaletteEntry(0x395799), // Dark blue
+    RZPaletteEntry(0x704081), // Purple
+    RZPaletteEntry(0xD35400), // Orange
+    RZPaletteEntry(0xA29C8E)  // Grey
+};
+
+RZNotificationRGBA RZNotificationPaletteColor(long paletteIndex, RZNotificationPaletteRole role)
+{
+    if (paletteIndex < 0 || paletteIndex >= RZNotificationPaletteCount) {
+        paletteIndex = RZNotificationPaletteCount - 1;
+    }
+    if ((int)role < 0 || role >= RZNotificationPaletteRoleCount) {
+        role = RZNotificationPaletteRoleStart;
+    }
+    return kPalette[paletteIndex][role];
+}
@@ -0,0 +1,84 @@
+//
+//  RZNotificationColorMath.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationColorMath_h
+#define RZNotificationView_RZNotificationColorMath_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Color components in [0, 1], device RGB
+ */
+typedef struct {
+    double red;
+    double green;
+    double blue;
+    double alpha;
+} RZNotificationRGBA;
+
+RZNotificationRGBA RZNotificationRGBAMake(double red, double green, double blue, double alpha);
+
+/*
+ * 0xRRGGBB, opaque
+ */
+RZNotificationRGBA RZNotificationRGBAFromHex(uint32_t rgb);
+
+/*
+ * From CGColorGetComponents: 2 components for greyscale (white, alpha), 4 for RGBA.
+ * Other counts give opaque black
+ */
+RZNotificationRGBA RZNotificationRGBAFromComponents(const double *components, size_t count);
+
+/*
+ * Add offset to red, green and blue, remove alphaOffset from alpha. Results are clamped
+ */
+RZNotificationRGBA RZNotificationRGBALighter(RZNotificationRGBA color, double offset, double alphaOffset);
+
+/*
+ * Remove offset from red, green and blue, add alphaOffset to alpha. Results are clamped
+ */
+RZNotificationRGBA RZNotificationRGBADarker(RZNotificationRGBA color, double offset, double alphaOffset);
+
+/*
+ * Offset turning the color alpha into alpha, as used by the `andAlpha:` UIColor additions
+ */
+double RZNotificationRGBAAlphaOffset(RZNotificationRGBA color, double alpha);
+
+int RZNotificationRGBAEqual(RZNotificationRGBA a, RZNotificationRGBA b);
+
+/*
+ * Colors derived from each RZNotificationColor, computed at compile time
+ */
+typedef enum {
+    RZNotificationPaletteRoleStart = 0,
+    RZNotificationPaletteRoleStroke,              // Start lighter by 0.1
+    RZNotificationPaletteRoleTextAutomaticDark,   // Start darker by 0.55
+    RZNotificationPaletteRoleTextAutomaticLight,  // Start lighter by 0.9
+    RZNotificationPaletteRoleCount
+} RZNotificationPaletteRole;
+
+/*
+ * Same order as RZNotificationColor, the last one is the deprecated grey
+ */
+#define RZNotificationPaletteCount 7
+
+/*
+ * Out of range palette indexes fall back on grey, like the view does for unknown colors
+ */
+RZNotificationRGBA RZNotificationPaletteColor(long paletteIndex, RZNotificationPaletteRole role);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
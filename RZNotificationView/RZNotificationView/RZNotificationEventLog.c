@@ -0,0 +1,278 @@
+//
+//  RZNotificationEventLog.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationEventLog.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define kRZEventLogVersion 1
+#define kRZEventLogHeaderSize 16
+#define kRZEventLogRecordSize 56
+#define kRZEventLogMaxCount (UINT64_C(1) << 32)
+
+static const unsigned char RZEventLogMagic[4] = { 'R', 'Z', 'E', 'L' };
+
+static const char *const RZEventTypeNames[RZNotificationEventTypeCount] = {
+    "Show",
+    "Hide",
+    "Touch",
+    "Rotate"
+};
+
+struct RZNotificationEventLog {
+    RZNotificationEvent *events;
+    size_t count;
+    size_t capacity;
+    RZNotificationClock clock;
+    double start;
+};
+
+const char *RZNotificationEventTypeName(RZNotificationEventType type)
+{
+    return (type >= 0 && type < RZNotificationEventTypeCount) ? RZEventTypeNames[type] : "Unknown";
+}
+
+// MARK: - Lifecycle
+
+RZNotificationEventLog *RZNotificationEventLogCreate(const RZNotificationClock *clock)
+{
+    RZNotificationEventLog *log = calloc(1, sizeof(RZNotificationEventLog));
+    if (log == NULL) {
+        return NULL;
+    }
+    log->clock = (clock != NULL && clock->now != NULL) ? *clock : RZNotificationSystemClock();
+    log->start = RZNotificationClockNow(&log->clock);
+    return log;
+}
+
+void RZNotificationEventLogDestroy(RZNotificationEventLog *log)
+{
+    if (log == NULL) {
+        return;
+    }
+    free(log->events);
+    free(log);
+}
+
+// MARK: - Events
+
+int RZNotificationEventLogAppend(RZNotificationEventLog *log, const RZNotificationEvent *event)
+{
+    if (log->count > 0 && event->timestamp < log->events[log->count - 1].timestamp) {
+        return 0;
+    }
+    if (log->count == log->capacity) {
+        size_t capacity = log->capacity ? log->capacity * 2 : 256;
+        RZNotificationEvent *events = realloc(log->events, capacity * sizeof(RZNotificationEvent));
+        if (events == NULL) {
+            return 0;
+        }
+        log->events = events;
+        log->capacity = capacity;
+    }
+    log->events[log->count++] = *event;
+    return 1;
+}
+
+int RZNotificationEventLogRecord(RZNotificationEventLog *log, const RZNotificationEvent *event)
+{
+    RZNotificationEvent stamped = *event;
+    stamped.timestamp = RZNotificationClockNow(&log->clock) - log->start;
+    if (log->count > 0 && stamped.timestamp < log->events[log->count - 1].timestamp) {
+        // Clocks can be coarse, the order of the calls wins
+        stamped.timestamp = log->events[log->count - 1].timestamp;
+    }
+    return RZNotificationEventLogAppend(log, &stamped);
+}
+
+size_t RZNotificationEventLogCount(const RZNotificationEventLog *log)
+{
+    return log->count;
+}
+
+const RZNotificationEvent *RZNotificationEventLogEvents(const RZNotificationEventLog *log)
+{
+    return log->events;
+}
+
+void RZNotificationEventLogClear(RZNotificationEventLog *log)
+{
+    log->count = 0;
+    log->start = RZNotificationClockNow(&log->clock);
+}
+
+// MARK: - Encoding
+
+static void putUInt16(unsigned char *bytes, uint16_t value)
+{
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+}
+
+static void putUInt32(unsigned char *bytes, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static void putUInt64(unsigned char *bytes, uint64_t value)
+{
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static void putFloat(unsigned char *bytes, double value)
+{
+    float single = (float)value;
+    uint32_t bits;
+    memcpy(&bits, &single, sizeof(bits));
+    putUInt32(bytes, bits);
+}
+
+static void putDouble(unsigned char *bytes, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putUInt64(bytes, bits);
+}
+
+static uint16_t getUInt16(const unsigned char *bytes)
+{
+    return (uint16_t)(bytes[0] | bytes[1] << 8);
+}
+
+static uint32_t getUInt32(const unsigned char *bytes)
+{
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+        value = value << 8 | bytes[i];
+    }
+    return value;
+}
+
+static uint64_t getUInt64(const unsigned char *bytes)
+{
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = value << 8 | bytes[i];
+    }
+    return value;
+}
+
+static double getFloat(const unsigned char *bytes)
+{
+    uint32_t bits = getUInt32(bytes);
+    float single;
+    memcpy(&single, &bits, sizeof(single));
+    return single;
+}
+
+static double getDouble(const unsigned char *bytes)
+{
+    uint64_t bits = getUInt64(bytes);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/*
+ * type, flags, bottom, reserved | priority | timestamp | notification | container |
+ * coalescing key | duration | width | height | reserved
+ */
+static void encodeEvent(const RZNotificationEvent *event, unsigned char *bytes)
+{
+    memset(bytes, 0, kRZEventLogRecordSize);
+    bytes[0] = (unsigned char)event->type;
+    bytes[1] = (unsigned char)event->flags;
+    bytes[2] = event->bottom ? 1 : 0;
+    putUInt32(bytes + 4, (uint32_t)event->priority);
+    putDouble(bytes + 8, event->timestamp);
+    putUInt64(bytes + 16, event->notification);
+    putUInt64(bytes + 24, event->container);
+    putUInt64(bytes + 32, event->coalescingKey);
+    putFloat(bytes + 40, event->duration);
+    putFloat(bytes + 44, event->width);
+    putFloat(bytes + 48, event->height);
+}
+
+static int decodeEvent(const unsigned char *bytes, RZNotificationEvent *event)
+{
+    if (bytes[0] >= RZNotificationEventTypeCount) {
+        return 0;
+    }
+    event->type = (RZNotificationEventType)bytes[0];
+    event->flags = bytes[1];
+    event->bottom = bytes[2] != 0;
+    event->priority = (int)(int32_t)getUInt32(bytes + 4);
+    event->timestamp = getDouble(bytes + 8);
+    event->notification = getUInt64(bytes + 16);
+    event->container = getUInt64(bytes + 24);
+    event->coalescingKey = getUInt64(bytes + 32);
+    event->duration = getFloat(bytes + 40);
+    event->width = getFloat(bytes + 44);
+    event->height = getFloat(bytes + 48);
+    // NaN fails every comparison
+    return event->timestamp >= 0.0;
+}
+
+// MARK: - Files
+
+int RZNotificationEventLogWrite(const RZNotificationEventLog *log, FILE *file)
+{
+    unsigned char header[kRZEventLogHeaderSize];
+    memcpy(header, RZEventLogMagic, sizeof(RZEventLogMagic));
+    putUInt16(header + 4, kRZEventLogVersion);
+    putUInt16(header + 6, kRZEventLogRecordSize);
+    putUInt64(header + 8, log->count);
+    if (fwrite(header, sizeof(header), 1, file) != 1) {
+        return 0;
+    }
+
+    unsigned char record[kRZEventLogRecordSize];
+    for (size_t i = 0; i < log->count; i++) {
+        encodeEvent(&log->events[i], record);
+        if (fwrite(record, sizeof(record), 1, file) != 1) {
+            return 0;
+        }
+    }
+    return fflush(file) == 0;
+}
+
+RZNotificationEventLog *RZNotificationEventLogRead(FILE *file)
+{
+    unsigned char header[kRZEventLogHeaderSize];
+    if (fread(header, sizeof(header), 1, file) != 1
+        || memcmp(header, RZEventLogMagic, sizeof(RZEventLogMagic)) != 0
+        || getUInt16(header + 4) != kRZEventLogVersion
+        || getUInt16(header + 6) != kRZEventLogRecordSize) {
+        return NULL;
+    }
+    uint64_t count = getUInt64(header + 8);
+    if (count > kRZEventLogMaxCount) {
+        return NULL;
+    }
+
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    if (log == NULL) {
+        return NULL;
+    }
+    unsigned char record[kRZEventLogRecordSize];
+    for (uint64_t i = 0; i < count; i++) {
+        RZNotificationEvent event;
+        if (fread(record, sizeof(record), 1, file) != 1
+            || !decodeEvent(record, &event)
+            || !RZNotificationEventLogAppend(log, &event)) {
+            RZNotificationEventLogDestroy(log);
+            return NULL;
+        }
+    }
+    return log;
+}
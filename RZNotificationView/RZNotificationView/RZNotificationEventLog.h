@@ -0,0 +1,107 @@
+//
+//  RZNotificationEventLog.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationEventLog_h
+#define RZNotificationView_RZNotificationEventLog_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "RZNotificationClock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Log of the calls made to the notification manager, to replay them without UIKit
+ * (see RZNotificationReplay.h).
+ *
+ * Unlike the trace, which tells what the views did, the log only keeps what the app asked
+ * for: show, hide, touch and rotate with their parameters. Notifications and containers are
+ * opaque non zero keys. Recording is not thread safe, the manager records on the main thread.
+ *
+ * File format, little endian: a 16 bytes header ("RZEL", version, record size, record count)
+ * followed by fixed size records of 56 bytes.
+ */
+
+typedef enum {
+    RZNotificationEventShow = 0,
+    RZNotificationEventHide,
+    RZNotificationEventTouch,
+    RZNotificationEventRotate,
+    RZNotificationEventTypeCount
+} RZNotificationEventType;
+
+enum {
+    RZNotificationEventFlagExpired = 1 << 0     // Hide: the hide delay elapsed
+};
+
+typedef struct {
+    RZNotificationEventType type;
+    unsigned flags;
+    double timestamp;           // Seconds since the log started
+    uint64_t notification;      // 0 for rotations
+    uint64_t container;
+    uint64_t coalescingKey;     // Show: 0 when not coalesced
+    int priority;               // Show
+    int bottom;                 // Show: shown at the bottom of the container
+    double duration;            // Show: hide delay, 0 when the notification stays
+    double width;               // Show: notification width, rotate: new container width
+    double height;              // Show: notification height, rotate: new container height
+} RZNotificationEvent;
+
+const char *RZNotificationEventTypeName(RZNotificationEventType type);
+
+typedef struct RZNotificationEventLog RZNotificationEventLog;
+
+/*
+ * clock can be NULL for the system clock
+ */
+RZNotificationEventLog *RZNotificationEventLogCreate(const RZNotificationClock *clock);
+void RZNotificationEventLogDestroy(RZNotificationEventLog *log);
+
+/*
+ * Append an event stamped with the log clock. Returns 0 when memory could not be allocated
+ */
+int RZNotificationEventLogRecord(RZNotificationEventLog *log, const RZNotificationEvent *event);
+
+/*
+ * Append an event keeping its timestamp, which must not go back in time.
+ * Returns 0 when memory could not be allocated or the timestamp is out of order
+ */
+int RZNotificationEventLogAppend(RZNotificationEventLog *log, const RZNotificationEvent *event);
+
+size_t RZNotificationEventLogCount(const RZNotificationEventLog *log);
+
+/*
+ * Events in time order, valid until the next append
+ */
+const RZNotificationEvent *RZNotificationEventLogEvents(const RZNotificationEventLog *log);
+
+/*
+ * Forget the events and restart the log clock
+ */
+void RZNotificationEventLogClear(RZNotificationEventLog *log);
+
+/*
+ * Returns 0 on failure
+ */
+int RZNotificationEventLogWrite(const RZNotificationEventLog *log, FILE *file);
+
+/*
+ * Read a whole file. Returns NULL when the file is not a valid log
+ */
+RZNotificationEventLog *RZNotificationEventLogRead(FILE *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,197 @@
+//
+//  RZNotificationHashMap.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationHashMap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint64_t key;
+    void *value;
+    int used;
+} RZNotificationHashMapEntry;
+
+struct RZNotificationHashMap {
+    RZNotificationHashMapEntry *entries;
+    size_t capacity; // Power of two
+    size_t count;
+};
+
+static const size_t kMinimumCapacity = 16;
+
+uint64_t RZNotificationHash64(uint64_t value)
+{
+    // splitmix64 finalizer
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+uint64_t RZNotificationHashBytes(const void *bytes, size_t length, uint64_t seed)
+{
+    const unsigned char *data = bytes;
+    uint64_t hash = 0xcbf29ce484222325ULL ^ seed;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static size_t capacityForCount(size_t count)
+{
+    size_t capacity = kMinimumCapacity;
+    // Keep the load factor under 3/4
+    while (capacity * 3 / 4 <= count) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+RZNotificationHashMap *RZNotificationHashMapCreate(size_t capacityHint)
+{
+    RZNotificationHashMap *map = calloc(1, sizeof(RZNotificationHashMap));
+    if (map == NULL) {
+        return NULL;
+    }
+    map->capacity = capacityForCount(capacityHint);
+    map->entries = calloc(map->capacity, sizeof(RZNotificationHashMapEntry));
+    if (map->entries == NULL) {
+        free(map);
+        return NULL;
+    }
+    return map;
+}
+
+void RZNotificationHashMapDestroy(RZNotificationHashMap *map)
+{
+    if (map == NULL) {
+        return;
+    }
+    free(map->entries);
+    free(map);
+}
+
+size_t RZNotificationHashMapCount(const RZNotificationHashMap *map)
+{
+    return map->count;
+}
+
+static size_t findSlot(const RZNotificationHashMap *map, uint64_t key)
+{
+    size_t mask = map->capacity - 1;
+    size_t index = (size_t)RZNotificationHash64(key) & mask;
+    while (map->entries[index].used && map->entries[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+int RZNotificationHashMapGet(const RZNotificationHashMap *map, uint64_t key, void **value)
+{
+    size_t index = findSlot(map, key);
+    if (!map->entries[index].used) {
+        return 0;
+    }
+    if (value != NULL) {
+        *value = map->entries[index].value;
+    }
+    return 1;
+}
+
+static int grow(RZNotificationHashMap *map)
+{
+    size_t oldCapacity = map->capacity;
+    RZNotificationHashMapEntry *oldEntries = map->entries;
+    size_t newCapacity = oldCapacity << 1;
+    RZNotificationHashMapEntry *newEntries = calloc(newCapacity, sizeof(RZNotificationHashMapEntry));
+    if (newEntries == NULL) {
+        return 0;
+    }
+
+    map->entries = newEntries;
+    map->capacity = newCapacity;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldEntries[i].used) {
+            size_t index = findSlot(map, oldEntries[i].key);
+            map->entries[index] = oldEntries[i];
+        }
+    }
+    free(oldEntries);
+    return 1;
+}
+
+int RZNotificationHashMapSet(RZNotificationHashMap *map, uint64_t key, void *value)
+{
+    size_t index = findSlot(map, key);
+    if (map->entries[index].used) {
+        map->entries[index].value = value;
+        return 1;
+    }
+
+    if ((map->count + 1) > map->capacity * 3 / 4) {
+        if (!grow(map)) {
+            return 0;
+        }
+        index = findSlot(map, key);
+    }
+
+    map->entries[index].key = key;
+    map->entries[index].value = value;
+    map->entries[index].used = 1;
+    map->count++;
+    return 1;
+}
+
+int RZNotificationHashMapRemove(RZNotificationHashMap *map, uint64_t key, void **value)
+{
+    size_t mask = map->capacity - 1;
+    size_t index = findSlot(map, key);
+    if (!map->entries[index].used) {
+        return 0;
+    }
+    if (value != NULL) {
+        *value = map->entries[index].value;
+    }
+
+    // Backward shift deletion keeps probe sequences intact without tombstones
+    size_t hole = index;
+    size_t next = (hole + 1) & mask;
+    while (map->entries[next].used) {
+        size_t home = (size_t)RZNotificationHash64(map->entries[next].key) & mask;
+        // Move the entry back when the hole lies between its home slot and its current slot
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            map->entries[hole] = map->entries[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    map->entries[hole].used = 0;
+    map->entries[hole].value = NULL;
+    map->count--;
+    return 1;
+}
+
+void RZNotificationHashMapRemoveAll(RZNotificationHashMap *map)
+{
+    memset(map->entries, 0, map->capacity * sizeof(RZNotificationHashMapEntry));
+    map->count = 0;
+}
+
+void RZNotificationHashMapApply(const RZNotificationHashMap *map, RZNotificationHashMapApplier applier, void *context)
+{
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->entries[i].used) {
+            applier(map->entries[i].key, map->entries[i].value, context);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+//
+//  RZNotificationHashMap.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationHashMap_h
+#define RZNotificationView_RZNotificationHashMap_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Open addressing hash map from 64 bit keys to pointers.
+ * Pointers can be used as keys through (uintptr_t) casts.
+ */
+typedef struct RZNotificationHashMap RZNotificationHashMap;
+
+typedef void (*RZNotificationHashMapApplier)(uint64_t key, void *value, void *context);
+
+RZNotificationHashMap *RZNotificationHashMapCreate(size_t capacityHint);
+void RZNotificationHashMapDestroy(RZNotificationHashMap *map);
+
+size_t RZNotificationHashMapCount(const RZNotificationHashMap *map);
+
+/*
+ * Returns non zero and fills value when the key is present. value can be NULL
+ */
+int RZNotificationHashMapGet(const RZNotificationHashMap *map, uint64_t key, void **value);
+
+/*
+ * Insert or replace. Returns 0 when memory could not be allocated
+ */
+int RZNotificationHashMapSet(RZNotificationHashMap *map, uint64_t key, void *value);
+
+/*
+ * Returns non zero and fills value when the key was present. value can be NULL
+ */
+int RZNotificationHashMapRemove(RZNotificationHashMap *map, uint64_t key, void **value);
+
+void RZNotificationHashMapRemoveAll(RZNotificationHashMap *map);
+
+/*
+ * Call applier on every entry, in no particular order. The map must not be modified meanwhile
+ */
+void RZNotificationHashMapApply(const RZNotificationHashMap *map, RZNotificationHashMapApplier applier, void *context);
+
+/*
+ * 64 bit mixing function, also useful to build keys
+ */
+uint64_t RZNotificationHash64(uint64_t value);
+
+/*
+ * FNV-1a hash of a byte buffer, seed 0 for the standard offset basis
+ */
+uint64_t RZNotificationHashBytes(const void *bytes, size_t length, uint64_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+//
+//  RZNotificationImageCache.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+#import "RZNotificationView.h"
+
+typedef UIImage * (^RZNotificationImageRenderBlock)(void);
+
+/**
+ Process-wide cache for tinted icon and anchor images.
+
+ Rendering an icon through MOOMaskedIconView is expensive and the result only depends on
+ the image name, the asset color, the base color and the screen scale. Images are kept until
+ the count limit is reached or a memory warning is received.
+ */
+@interface RZNotificationImageCache : NSObject
+
+/**
+ The shared cache used by every RZNotificationView
+ */
++ (instancetype) sharedCache;
+
+/**
+ Return the cached tinted image, rendering it with renderBlock on a miss
+ @param imageName The image name, as given to `+[UIImage imageNamed:]`
+ @param assetColor The asset color used for tinting
+ @param baseColor The notification background color. Only used for automatic asset colors
+ @param scale The screen scale
+ @param renderBlock The block rendering the image on a cache miss
+ @return the tinted image
+ */
+- (UIImage *) imageNamed:(NSString *)imageName assetColor:(RZNotificationContentColor)assetColor baseColor:(UIColor *)baseColor scale:(CGFloat)scale renderBlock:(RZNotificationImageRenderBlock)renderBlock;
+
+/**
+ Fill the opaque pixels of an image with a color. UIKit drawing only, safe on any queue
+ @param image The image used as a mask
+ @param color The fill color
+ @return the tinted image, at the scale of image
+ */
++ (UIImage *) imageByFillingImage:(UIImage *)image withColor:(UIColor *)color;
+
+/**
+ Remove all the cached images. Called automatically on memory warnings
+ */
+- (void) removeAllImages;
+
+/**
+ Reset hits and misses counters
+ */
+- (void) resetCounters;
+
+/**
+ Maximum number of images kept in cache. Default is 32
+ */
+@property (nonatomic) NSUInteger countLimit;
+
+/**
+ Number of lookups served from cache
+ */
+@property (nonatomic, readonly) NSUInteger hits;
+
+/**
+ Number of lookups that needed a render
+ */
+@property (nonatomic, readonly) NSUInteger misses;
+
+@end
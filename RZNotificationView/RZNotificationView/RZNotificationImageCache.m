@@ -0,0 +1,174 @@
+//
+//  RZNotificationImageCache.m
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#import "RZNotificationImageCache.h"
+
+static const NSUInteger kDefaultImageCacheCountLimit = 32;
+
+@interface RZNotificationImageCache ()
+{
+    NSMutableDictionary *_images;
+    NSMutableArray *_keysByUse; // Least recently used first
+}
+@end
+
+@implementation RZNotificationImageCache
+
++ (instancetype) sharedCache
+{
+    static dispatch_once_t pred = 0;
+    __strong static RZNotificationImageCache *_sharedCache = nil;
+    dispatch_once(&pred, ^{
+        _sharedCache = [[self alloc] init];
+    });
+    return _sharedCache;
+}
+
+- (id) init
+{
+    self = [super init];
+    if (self)
+    {
+        _images = [NSMutableDictionary dictionary];
+        _keysByUse = [NSMutableArray array];
+        _countLimit = kDefaultImageCacheCountLimit;
+
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(didReceiveMemoryWarning:)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void) dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+}
+
+#pragma mark - Keys
+
++ (NSString *) keyForImageNamed:(NSString *)imageName assetColor:(RZNotificationContentColor)assetColor baseColor:(UIColor *)baseColor scale:(CGFloat)scale
+{
+    NSString *colorKey = @"";
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    // Light and dark assets do not depend on the background, so all colors share the same entry
+    if (baseColor && (assetColor == RZNotificationContentColorAutomaticLight || assetColor == RZNotificationContentColorAutomaticDark))
+    {
+        CGFloat r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+        if (![baseColor getRed:&r green:&g blue:&b alpha:&a]) {
+            [baseColor getWhite:&r alpha:&a];
+            g = b = r;
+        }
+        colorKey = [NSString stringWithFormat:@"%.3f,%.3f,%.3f,%.3f", r, g, b, a];
+    }
+#pragma GCC diagnostic pop
+
+    return [NSString stringWithFormat:@"%@|%lu|%@|%.1f", imageName, (unsigned long)assetColor, colorKey, scale];
+}
+
+#pragma mark - Lookup
+
+- (UIImage *) imageNamed:(NSString *)imageName assetColor:(RZNotificationContentColor)assetColor baseColor:(UIColor *)baseColor scale:(CGFloat)scale renderBlock:(RZNotificationImageRenderBlock)renderBlock
+{
+    if (!imageName)
+        return nil;
+
+    NSString *key = [[self class] keyForImageNamed:imageName assetColor:assetColor baseColor:baseColor scale:scale];
+
+    @synchronized (self)
+    {
+        UIImage *image = [_images objectForKey:key];
+        if (image) {
+            _hits++;
+            [_keysByUse removeObject:key];
+            [_keysByUse addObject:key];
+            return image;
+        }
+        _misses++;
+    }
+
+    // Render outside of the lock, a concurrent miss on the same key only costs a duplicated render
+    UIImage *image = renderBlock ? renderBlock() : nil;
+    if (!image)
+        return nil;
+
+    @synchronized (self)
+    {
+        if (![_images objectForKey:key]) {
+            [_keysByUse addObject:key];
+        }
+        [_images setObject:image forKey:key];
+        [self evictIfNeeded];
+    }
+    return image;
+}
+
+- (void) evictIfNeeded
+{
+    while ([_keysByUse count] > _countLimit) {
+        NSString *oldestKey = [_keysByUse objectAtIndex:0];
+        [_images removeObjectForKey:oldestKey];
+        [_keysByUse removeObjectAtIndex:0];
+    }
+}
+
+- (void) setCountLimit:(NSUInteger)countLimit
+{
+    @synchronized (self)
+    {
+        _countLimit = countLimit;
+        [self evictIfNeeded];
+    }
+}
+
+#pragma mark - Rendering
+
++ (UIImage *) imageByFillingImage:(UIImage *)image withColor:(UIColor *)color
+{
+    if (!image || !color)
+        return nil;
+
+    CGRect rect = CGRectMake(0.0f, 0.0f, image.size.width, image.size.height);
+    UIGraphicsBeginImageContextWithOptions(rect.size, NO, image.scale);
+    [image drawInRect:rect];
+    [color setFill];
+    UIRectFillUsingBlendMode(rect, kCGBlendModeSourceIn);
+    UIImage *tintedImage = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+    return tintedImage;
+}
+
+#pragma mark - Purge
+
+- (void) removeAllImages
+{
+    @synchronized (self)
+    {
+        [_images removeAllObjects];
+        [_keysByUse removeAllObjects];
+    }
+}
+
+- (void) resetCounters
+{
+    @synchronized (self)
+    {
+        _hits = 0;
+        _misses = 0;
+    }
+}
+
+- (void) didReceiveMemoryWarning:(NSNotification *)notification
+{
+    [self removeAllImages];
+}
+
+@end
@@ -0,0 +1,173 @@
+//
+//  RZNotificationLayout.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationLayout.h"
+
+#include <math.h>
+
+RZNotificationRect RZNotificationRectMake(double x, double y, double width, double height)
+{
+    RZNotificationRect rect;
+    rect.x = x;
+    rect.y = y;
+    rect.width = width;
+    rect.height = height;
+    return rect;
+}
+
+int RZNotificationRectEqual(RZNotificationRect a, RZNotificationRect b)
+{
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+int RZNotificationLayoutInputEqual(const RZNotificationLayoutInput *a, const RZNotificationLayoutInput *b)
+{
+    return RZNotificationRectEqual(a->bounds, b->bounds)
+        && a->topOffset == b->topOffset
+        && a->safeTopInset == b->safeTopInset
+        && a->safeBottomInset == b->safeBottomInset
+        && (a->hasIcon != 0) == (b->hasIcon != 0)
+        && (a->hasAnchor != 0) == (b->hasAnchor != 0)
+        && a->offsetX == b->offsetX
+        && a->contentMarginHeight == b->contentMarginHeight
+        && a->iconWidth == b->iconWidth
+        && a->iconHeight == b->iconHeight;
+}
+
+double RZNotificationLayoutOffsetXLeft(const RZNotificationLayoutInput *input)
+{
+    double offsetX = input->offsetX;
+    if (input->hasIcon) {
+        offsetX += input->iconWidth + input->offsetX;
+    }
+    return offsetX;
+}
+
+double RZNotificationLayoutOffsetXRight(const RZNotificationLayoutInput *input)
+{
+    double offsetX = input->offsetX;
+    if (input->hasAnchor) {
+        offsetX += input->iconWidth + input->offsetX;
+    }
+    return offsetX;
+}
+
+double RZNotificationLayoutContentWidth(const RZNotificationLayoutInput *input)
+{
+    return input->bounds.width - RZNotificationLayoutOffsetXLeft(input) - RZNotificationLayoutOffsetXRight(input);
+}
+
+double RZNotificationLayoutHeightForContentHeight(const RZNotificationLayoutInput *input, double contentHeight, double minHeight)
+{
+    double height = contentHeight + 2.0 * input->contentMarginHeight + input->topOffset + input->safeBottomInset + input->safeTopInset;
+    return height > minHeight ? height : minHeight;
+}
+
+void RZNotificationLayoutCompute(const RZNotificationLayoutInput *input, RZNotificationLayoutResult *result)
+{
+    const RZNotificationRect bounds = input->bounds;
+    const double offsetXLeft = RZNotificationLayoutOffsetXLeft(input);
+
+    // Icon and anchor are vertically centered in the area left by the safe insets
+    const double imagesY = bounds.y + input->topOffset + floor((bounds.height - input->iconHeight - input->safeBottomInset + input->safeTopInset) * 0.5);
+
+    result->iconFrame = RZNotificationRectMake(input->offsetX,
+                                               imagesY,
+                                               input->iconWidth,
+                                               input->iconHeight);
+
+    result->contentFrame = RZNotificationRectMake(bounds.x + offsetXLeft,
+                                                  bounds.y + input->contentMarginHeight + input->topOffset,
+                                                  RZNotificationLayoutContentWidth(input),
+                                                  bounds.height - 2.0 * input->contentMarginHeight - input->safeBottomInset + input->safeTopInset);
+
+    result->anchorFrame = RZNotificationRectMake(bounds.x + bounds.width - input->offsetX - input->iconWidth,
+                                                 imagesY,
+                                                 input->iconWidth,
+                                                 input->iconHeight);
+}
+
+static int isHighSurrogate(uint16_t unit)
+{
+    return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+static int isLowSurrogate(uint16_t unit)
+{
+    return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+size_t RZNotificationLayoutTruncatedLength(const uint16_t *units, size_t length, long maxLength)
+{
+    if (maxLength < 0 || (size_t)maxLength >= length) {
+        return length;
+    }
+    size_t kept = (size_t)maxLength;
+    if (kept > 0 && isHighSurrogate(units[kept - 1]) && isLowSurrogate(units[kept])) {
+        kept--;
+    }
+    return kept;
+}
+
+// MARK: - Insets
+
+void RZNotificationLayoutApplyInsets(const RZNotificationInsetsInput *insets, RZNotificationLayoutInput *input)
+{
+    input->topOffset = (insets->belowStatusBar && !insets->bottom) ? insets->statusBarHeight / 2.0 : 0.0;
+
+    if (insets->bottom) {
+        input->safeBottomInset = insets->containerSafeBottomInset;
+    }
+    else if (!insets->topMostController) {
+        // Below the status bar, the status bar is already part of the safe area
+        input->safeTopInset = insets->containerSafeTopInset - (insets->belowStatusBar ? insets->statusBarHeight : 0.0);
+    }
+}
+
+// MARK: - Vertical position
+
+double RZNotificationLayoutFinalEdge(const RZNotificationOriginInput *input)
+{
+    if (input->hasCustomOrigin) {
+        return input->customOrigin;
+    }
+    if (input->bottom) {
+        return input->containerHeight - input->bottomGuide - input->safeBottomInset;
+    }
+    return input->topGuide;
+}
+
+double RZNotificationLayoutShownY(const RZNotificationOriginInput *input)
+{
+    double edge = RZNotificationLayoutFinalEdge(input);
+    return input->bottom ? edge - input->notificationHeight : edge;
+}
+
+double RZNotificationLayoutHiddenY(const RZNotificationOriginInput *input)
+{
+    if (input->bottom) {
+        return input->containerHeight - input->safeBottomInset;
+    }
+    return -input->notificationHeight;
+}
+
+// MARK: - Windows
+
+RZNotificationRect RZNotificationLayoutWindowFrame(double screenWidth, double screenHeight, int bottom, const double *extents, size_t count)
+{
+    double height = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        if (extents[i] > height) {
+            height = extents[i];
+        }
+    }
+    if (height > screenHeight) {
+        height = screenHeight;
+    }
+    return RZNotificationRectMake(0.0, bottom ? screenHeight - height : 0.0, screenWidth, height);
+}
@@ -0,0 +1,141 @@
+//
+//  RZNotificationLayout.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationLayout_h
+#define RZNotificationView_RZNotificationLayout_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Subview layout of a notification view.
+ * Plain C without UIKit so it can be tested and benchmarked outside of a simulator.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    double x;
+    double y;
+    double width;
+    double height;
+} RZNotificationRect;
+
+typedef struct {
+    RZNotificationRect bounds;
+    double topOffset;            // Below status bar offset
+    double safeTopInset;
+    double safeBottomInset;
+    int hasIcon;
+    int hasAnchor;
+    double offsetX;              // Offset from borders, also used between text and images
+    double contentMarginHeight;  // Margin on top and bottom of the content
+    double iconWidth;
+    double iconHeight;
+} RZNotificationLayoutInput;
+
+typedef struct {
+    RZNotificationRect iconFrame;
+    RZNotificationRect contentFrame;
+    RZNotificationRect anchorFrame;
+} RZNotificationLayoutResult;
+
+RZNotificationRect RZNotificationRectMake(double x, double y, double width, double height);
+int RZNotificationRectEqual(RZNotificationRect a, RZNotificationRect b);
+
+/*
+ * Returns non zero when both inputs produce the same layout
+ */
+int RZNotificationLayoutInputEqual(const RZNotificationLayoutInput *a, const RZNotificationLayoutInput *b);
+
+double RZNotificationLayoutOffsetXLeft(const RZNotificationLayoutInput *input);
+double RZNotificationLayoutOffsetXRight(const RZNotificationLayoutInput *input);
+
+/*
+ * Width available for the text label or the custom view
+ */
+double RZNotificationLayoutContentWidth(const RZNotificationLayoutInput *input);
+
+/*
+ * Height of the notification for a given content height, never below minHeight
+ */
+double RZNotificationLayoutHeightForContentHeight(const RZNotificationLayoutInput *input, double contentHeight, double minHeight);
+
+/*
+ * Compute icon, content and anchor frames in the notification coordinate space
+ */
+void RZNotificationLayoutCompute(const RZNotificationLayoutInput *input, RZNotificationLayoutResult *result);
+
+/*
+ * UTF-16 units of a message kept by its tail truncation to maxLength units. A surrogate pair is
+ * never split, the cut moves before it. Returns length when the message fits, or when maxLength
+ * is negative. units holds at least the first min(length, maxLength + 1) units
+ */
+size_t RZNotificationLayoutTruncatedLength(const uint16_t *units, size_t length, long maxLength);
+
+// MARK: - Insets
+
+typedef struct {
+    int bottom;                  // Shown at the bottom of the container
+    int belowStatusBar;          // RZNotificationContextBelowStatusBar
+    int topMostController;       // RZNotificationContextTopMostController
+    double statusBarHeight;
+    double containerSafeTopInset;
+    double containerSafeBottomInset;
+} RZNotificationInsetsInput;
+
+/*
+ * Update topOffset and the safe insets of a layout input for its container.
+ * Insets that do not apply to the position are left untouched
+ */
+void RZNotificationLayoutApplyInsets(const RZNotificationInsetsInput *insets, RZNotificationLayoutInput *input);
+
+// MARK: - Vertical position
+
+typedef struct {
+    int bottom;                  // Shown at the bottom of the container
+    double containerHeight;
+    double topGuide;             // Top layout guide length, 0 for windows
+    double bottomGuide;          // Bottom layout guide length, 0 for windows
+    double safeBottomInset;      // Container safe area
+    int hasCustomOrigin;         // Origin given by the controller
+    double customOrigin;
+    double notificationHeight;
+} RZNotificationOriginInput;
+
+/*
+ * Edge the notification is attached to once shown
+ */
+double RZNotificationLayoutFinalEdge(const RZNotificationOriginInput *input);
+
+/*
+ * y of the notification once shown
+ */
+double RZNotificationLayoutShownY(const RZNotificationOriginInput *input);
+
+/*
+ * y of the notification before showing and after hiding, just out of the container
+ */
+double RZNotificationLayoutHiddenY(const RZNotificationOriginInput *input);
+
+// MARK: - Windows
+
+/*
+ * Frame of a notification window against the top or bottom edge of the screen, as high as its
+ * farthest notification and never higher than the screen. An extent is the distance from the edge
+ * to the far side of a notification, stack offset included. No extent gives an empty frame
+ */
+RZNotificationRect RZNotificationLayoutWindowFrame(double screenWidth, double screenHeight, int bottom, const double *extents, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
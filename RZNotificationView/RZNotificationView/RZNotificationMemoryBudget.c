@@ -0,0 +1,218 @@
+//
+//  RZNotificationMemoryBudget.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationMemoryBudget.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint64_t item;
+    size_t bytes;
+    int priority;
+    uint64_t sequence;          // Order of the first set, the age
+    int picked;
+    int reported;               // Picked and given by TakeEvictions
+} RZBudgetEntry;
+
+struct RZNotificationMemoryBudget {
+    RZBudgetEntry *entries;
+    size_t count;
+    size_t capacity;
+    size_t limit;
+    size_t usage;
+    size_t pickedBytes;
+    uint64_t nextSequence;
+    RZBudgetEntry **order;      // Eviction order scratch
+    size_t orderCapacity;
+};
+
+size_t RZNotificationMemoryBitmapBytes(double width, double height, double scale)
+{
+    if (!(width > 0.0) || !(height > 0.0) || !(scale > 0.0)) {
+        return 0;
+    }
+    return (size_t)ceil(width * scale) * (size_t)ceil(height * scale) * 4;
+}
+
+// MARK: - Lifecycle
+
+RZNotificationMemoryBudget *RZNotificationMemoryBudgetCreate(size_t limit)
+{
+    RZNotificationMemoryBudget *budget = calloc(1, sizeof(RZNotificationMemoryBudget));
+    if (budget == NULL) {
+        return NULL;
+    }
+    budget->limit = limit;
+    budget->nextSequence = 1;
+    return budget;
+}
+
+void RZNotificationMemoryBudgetDestroy(RZNotificationMemoryBudget *budget)
+{
+    if (budget == NULL) {
+        return;
+    }
+    free(budget->entries);
+    free(budget->order);
+    free(budget);
+}
+
+void RZNotificationMemoryBudgetSetLimit(RZNotificationMemoryBudget *budget, size_t limit)
+{
+    budget->limit = limit;
+}
+
+size_t RZNotificationMemoryBudgetLimit(const RZNotificationMemoryBudget *budget)
+{
+    return budget->limit;
+}
+
+// MARK: - Items
+
+static long indexOfItem(const RZNotificationMemoryBudget *budget, uint64_t item)
+{
+    for (size_t i = 0; i < budget->count; i++) {
+        if (budget->entries[i].item == item) {
+            return (long)i;
+        }
+    }
+    return -1;
+}
+
+int RZNotificationMemoryBudgetSet(RZNotificationMemoryBudget *budget, uint64_t item, size_t bytes, int priority)
+{
+    long index = indexOfItem(budget, item);
+    if (index >= 0) {
+        RZBudgetEntry *entry = &budget->entries[index];
+        budget->usage = budget->usage - entry->bytes + bytes;
+        if (entry->picked) {
+            budget->pickedBytes = budget->pickedBytes - entry->bytes + bytes;
+        }
+        entry->bytes = bytes;
+        entry->priority = priority;
+        return 1;
+    }
+
+    if (budget->count == budget->capacity) {
+        size_t capacity = budget->capacity ? budget->capacity * 2 : 8;
+        RZBudgetEntry *entries = realloc(budget->entries, capacity * sizeof(RZBudgetEntry));
+        if (entries == NULL) {
+            return 0;
+        }
+        budget->entries = entries;
+        budget->capacity = capacity;
+    }
+    RZBudgetEntry *entry = &budget->entries[budget->count++];
+    memset(entry, 0, sizeof(RZBudgetEntry));
+    entry->item = item;
+    entry->bytes = bytes;
+    entry->priority = priority;
+    entry->sequence = budget->nextSequence++;
+    budget->usage += bytes;
+    return 1;
+}
+
+int RZNotificationMemoryBudgetRemove(RZNotificationMemoryBudget *budget, uint64_t item)
+{
+    long index = indexOfItem(budget, item);
+    if (index < 0) {
+        return 0;
+    }
+    RZBudgetEntry *entry = &budget->entries[index];
+    budget->usage -= entry->bytes;
+    if (entry->picked) {
+        budget->pickedBytes -= entry->bytes;
+    }
+    // Order does not matter, the age is in the sequence
+    budget->entries[index] = budget->entries[--budget->count];
+    return 1;
+}
+
+size_t RZNotificationMemoryBudgetCount(const RZNotificationMemoryBudget *budget)
+{
+    return budget->count;
+}
+
+size_t RZNotificationMemoryBudgetUsage(const RZNotificationMemoryBudget *budget)
+{
+    return budget->usage;
+}
+
+size_t RZNotificationMemoryBudgetBytes(const RZNotificationMemoryBudget *budget, uint64_t item)
+{
+    long index = indexOfItem(budget, item);
+    return index >= 0 ? budget->entries[index].bytes : 0;
+}
+
+// MARK: - Eviction
+
+// Lowest priority first, then oldest first
+static int compareEvictionOrder(const void *a, const void *b)
+{
+    const RZBudgetEntry *x = *(RZBudgetEntry *const *)a;
+    const RZBudgetEntry *y = *(RZBudgetEntry *const *)b;
+    if (x->priority != y->priority) {
+        return x->priority < y->priority ? -1 : 1;
+    }
+    return x->sequence < y->sequence ? -1 : (x->sequence > y->sequence);
+}
+
+static void pickEvictions(RZNotificationMemoryBudget *budget)
+{
+    if (budget->limit == 0 || budget->usage - budget->pickedBytes <= budget->limit || budget->count < 2) {
+        return;
+    }
+    if (budget->orderCapacity < budget->count) {
+        RZBudgetEntry **order = realloc(budget->order, budget->capacity * sizeof(RZBudgetEntry *));
+        if (order == NULL) {
+            return;
+        }
+        budget->order = order;
+        budget->orderCapacity = budget->capacity;
+    }
+
+    size_t newest = 0;
+    for (size_t i = 1; i < budget->count; i++) {
+        if (budget->entries[i].sequence > budget->entries[newest].sequence) {
+            newest = i;
+        }
+    }
+    size_t candidates = 0;
+    for (size_t i = 0; i < budget->count; i++) {
+        if (i != newest && !budget->entries[i].picked) {
+            budget->order[candidates++] = &budget->entries[i];
+        }
+    }
+    qsort(budget->order, candidates, sizeof(RZBudgetEntry *), compareEvictionOrder);
+
+    for (size_t i = 0; i < candidates && budget->usage - budget->pickedBytes > budget->limit; i++) {
+        budget->order[i]->picked = 1;
+        budget->pickedBytes += budget->order[i]->bytes;
+    }
+}
+
+size_t RZNotificationMemoryBudgetTakeEvictions(RZNotificationMemoryBudget *budget, uint64_t *items, size_t capacity)
+{
+    pickEvictions(budget);
+
+    size_t count = 0;
+    for (size_t i = 0; i < budget->count; i++) {
+        RZBudgetEntry *entry = &budget->entries[i];
+        if (!entry->picked || entry->reported) {
+            continue;
+        }
+        if (count < capacity) {
+            items[count] = entry->item;
+            entry->reported = 1;
+        }
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,78 @@
+//
+//  RZNotificationMemoryBudget.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationMemoryBudget_h
+#define RZNotificationView_RZNotificationMemoryBudget_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Estimated memory of the live notifications, against a budget in bytes.
+ *
+ * Each item is an opaque non zero key with its bytes and priority. When the usage is over
+ * the budget, the items to evict are picked lowest priority first, then oldest first. The
+ * most recent item, the one the app just asked for, is never picked. Picked items keep
+ * their bytes until removed, they are gone once their hide animation ends, but are not
+ * picked again. Lookups are linear, a budget holds the live notifications.
+ */
+typedef struct RZNotificationMemoryBudget RZNotificationMemoryBudget;
+
+/*
+ * Bytes of a 32 bits bitmap covering a size in points
+ */
+size_t RZNotificationMemoryBitmapBytes(double width, double height, double scale);
+
+/*
+ * budget 0 means no limit
+ */
+RZNotificationMemoryBudget *RZNotificationMemoryBudgetCreate(size_t budget);
+void RZNotificationMemoryBudgetDestroy(RZNotificationMemoryBudget *budget);
+
+void RZNotificationMemoryBudgetSetLimit(RZNotificationMemoryBudget *budget, size_t limit);
+size_t RZNotificationMemoryBudgetLimit(const RZNotificationMemoryBudget *budget);
+
+/*
+ * Add an item, or update the bytes and priority of an item keeping its age.
+ * Returns 0 when memory could not be allocated
+ */
+int RZNotificationMemoryBudgetSet(RZNotificationMemoryBudget *budget, uint64_t item, size_t bytes, int priority);
+
+/*
+ * Return non zero when the item was accounted
+ */
+int RZNotificationMemoryBudgetRemove(RZNotificationMemoryBudget *budget, uint64_t item);
+
+size_t RZNotificationMemoryBudgetCount(const RZNotificationMemoryBudget *budget);
+
+/*
+ * Bytes of every item, picked ones included
+ */
+size_t RZNotificationMemoryBudgetUsage(const RZNotificationMemoryBudget *budget);
+
+/*
+ * Bytes of an item, 0 when not accounted
+ */
+size_t RZNotificationMemoryBudgetBytes(const RZNotificationMemoryBudget *budget, uint64_t item);
+
+/*
+ * Pick the items to evict so that the usage of the items not picked fits the limit, and
+ * mark them as picked. Returns the number of items picked, which can be larger than
+ * capacity: the remaining ones are returned by the next call
+ */
+size_t RZNotificationMemoryBudgetTakeEvictions(RZNotificationMemoryBudget *budget, uint64_t *items, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,302 @@
+//
+//  RZNotificationRegistry.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationRegistry.h"
+#include "RZNotificationHashMap.h"
+
+#include <stdlib.h>
+
+typedef struct RZRegistryEntry RZRegistryEntry;
+
+// Each entry is linked in the list of its container, and of its controller if any
+typedef struct {
+    RZRegistryEntry *previous;
+    RZRegistryEntry *next;
+} RZRegistryLink;
+
+struct RZRegistryEntry {
+    uint64_t notification;
+    uint64_t container;
+    uint64_t controller;
+    RZRegistryLink containerLink;
+    RZRegistryLink controllerLink;
+};
+
+typedef struct {
+    RZRegistryEntry *first;
+    RZRegistryEntry *last;
+    size_t count;
+} RZRegistryList;
+
+struct RZNotificationRegistry {
+    RZNotificationHashMap *entries;      // notification -> RZRegistryEntry
+    RZNotificationHashMap *containers;   // container -> RZRegistryList
+    RZNotificationHashMap *controllers;  // controller -> RZRegistryList
+};
+
+// MARK: - Lists
+
+static RZRegistryLink *linkOf(RZRegistryEntry *entry, int byController)
+{
+    return byController ? &entry->controllerLink : &entry->containerLink;
+}
+
+static RZRegistryList *listForKey(const RZNotificationHashMap *lists, uint64_t key)
+{
+    void *list = NULL;
+    if (key == 0 || !RZNotificationHashMapGet(lists, key, &list)) {
+        return NULL;
+    }
+    return list;
+}
+
+static int appendToList(RZNotificationHashMap *lists, uint64_t key, RZRegistryEntry *entry, int byController)
+{
+    RZRegistryList *list = listForKey(lists, key);
+    if (list == NULL) {
+        list = calloc(1, sizeof(RZRegistryList));
+        if (list == NULL || !RZNotificationHashMapSet(lists, key, list)) {
+            free(list);
+            return 0;
+        }
+    }
+
+    RZRegistryLink *link = linkOf(entry, byController);
+    link->previous = list->last;
+    link->next = NULL;
+    if (list->last != NULL) {
+        linkOf(list->last, byController)->next = entry;
+    } else {
+        list->first = entry;
+    }
+    list->last = entry;
+    list->count++;
+    return 1;
+}
+
+static void removeFromList(RZNotificationHashMap *lists, uint64_t key, RZRegistryEntry *entry, int byController)
+{
+    RZRegistryList *list = listForKey(lists, key);
+    if (list == NULL) {
+        return;
+    }
+
+    RZRegistryLink *link = linkOf(entry, byController);
+    if (link->previous != NULL) {
+        linkOf(link->previous, byController)->next = link->next;
+    } else {
+        list->first = link->next;
+    }
+    if (link->next != NULL) {
+        linkOf(link->next, byController)->previous = link->previous;
+    } else {
+        list->last = link->previous;
+    }
+
+    // Containers and controllers come and go, do not keep empty lists around
+    if (--list->count == 0) {
+        RZNotificationHashMapRemove(lists, key, NULL);
+        free(list);
+    }
+}
+
+static size_t copyList(const RZNotificationHashMap *lists, uint64_t key, int byController, uint64_t *notifications, size_t capacity)
+{
+    RZRegistryList *list = listForKey(lists, key);
+    if (list == NULL) {
+        return 0;
+    }
+    size_t index = 0;
+    for (RZRegistryEntry *entry = list->first; entry != NULL && index < capacity; entry = linkOf(entry, byController)->next) {
+        notifications[index++] = entry->notification;
+    }
+    return list->count;
+}
+
+// MARK: - Lifecycle
+
+RZNotificationRegistry *RZNotificationRegistryCreate(void)
+{
+    RZNotificationRegistry *registry = calloc(1, sizeof(RZNotificationRegistry));
+    if (registry == NULL) {
+        return NULL;
+    }
+    registry->entries = RZNotificationHashMapCreate(16);
+    registry->containers = RZNotificationHashMapCreate(16);
+    registry->controllers = RZNotificationHashMapCreate(16);
+    if (registry->entries == NULL || registry->containers == NULL || registry->controllers == NULL) {
+        RZNotificationRegistryDestroy(registry);
+        return NULL;
+    }
+    return registry;
+}
+
+static void freeValue(uint64_t key, void *value, void *context)
+{
+    (void)key;
+    (void)context;
+    free(value);
+}
+
+void RZNotificationRegistryDestroy(RZNotificationRegistry *registry)
+{
+    if (registry == NULL) {
+        return;
+    }
+    if (registry->entries != NULL) {
+        RZNotificationHashMapApply(registry->entries, freeValue, NULL);
+    }
+    if (registry->containers != NULL) {
+        RZNotificationHashMapApply(registry->containers, freeValue, NULL);
+    }
+    if (registry->controllers != NULL) {
+        RZNotificationHashMapApply(registry->controllers, freeValue, NULL);
+    }
+    RZNotificationHashMapDestroy(registry->entries);
+    RZNotificationHashMapDestroy(registry->containers);
+    RZNotificationHashMapDestroy(registry->controllers);
+    free(registry);
+}
+
+// MARK: - Registration
+
+int RZNotificationRegistryInsert(RZNotificationRegistry *registry, uint64_t notification, uint64_t container, uint64_t controller)
+{
+    if (notification == 0 || container == 0 || RZNotificationHashMapGet(registry->entries, notification, NULL)) {
+        return 0;
+    }
+
+    RZRegistryEntry *entry = calloc(1, sizeof(RZRegistryEntry));
+    if (entry == NULL) {
+        return 0;
+    }
+    entry->notification = notification;
+    entry->container = container;
+    entry->controller = controller;
+
+    if (!RZNotificationHashMapSet(registry->entries, notification, entry)) {
+        free(entry);
+        return 0;
+    }
+    if (!appendToList(registry->containers, container, entry, 0)) {
+        RZNotificationHashMapRemove(registry->entries, notification, NULL);
+        free(entry);
+        return 0;
+    }
+    if (controller != 0 && !appendToList(registry->controllers, controller, entry, 1)) {
+        removeFromList(registry->containers, container, entry, 0);
+        RZNotificationHashMapRemove(registry->entries, notification, NULL);
+        free(entry);
+        return 0;
+    }
+    return 1;
+}
+
+int RZNotificationRegistryRemove(RZNotificationRegistry *registry, uint64_t notification)
+{
+    void *value = NULL;
+    if (!RZNotificationHashMapRemove(registry->entries, notification, &value)) {
+        return 0;
+    }
+    RZRegistryEntry *entry = value;
+    removeFromList(registry->containers, entry->container, entry, 0);
+    if (entry->controller != 0) {
+        removeFromList(registry->controllers, entry->controller, entry, 1);
+    }
+    free(entry);
+    return 1;
+}
+
+size_t RZNotificationRegistryRemoveMany(RZNotificationRegistry *registry, const uint64_t *notifications, size_t count)
+{
+    size_t removed = 0;
+    for (size_t i = 0; i < count; i++) {
+        removed += RZNotificationRegistryRemove(registry, notifications[i]) ? 1 : 0;
+    }
+    return removed;
+}
+
+size_t RZNotificationRegistryRemoveManyEmptying(RZNotificationRegistry *registry, const uint64_t *notifications, size_t count, uint64_t *emptied, size_t *emptiedCount)
+{
+    // The containers of the removed notifications, each once
+    size_t containers = 0;
+    size_t removed = 0;
+    for (size_t i = 0; i < count; i++) {
+        void *value = NULL;
+        if (!RZNotificationHashMapGet(registry->entries, notifications[i], &value)) {
+            continue;
+        }
+        uint64_t container = ((RZRegistryEntry *)value)->container;
+        RZNotificationRegistryRemove(registry, notifications[i]);
+        removed++;
+
+        size_t j = 0;
+        while (j < containers && emptied[j] != container) {
+            j++;
+        }
+        if (j == containers) {
+            emptied[containers++] = container;
+        }
+    }
+
+    // Only the empty ones are kept
+    size_t kept = 0;
+    for (size_t j = 0; j < containers; j++) {
+        if (RZNotificationRegistryCountForContainer(registry, emptied[j]) == 0) {
+            emptied[kept++] = emptied[j];
+        }
+    }
+    *emptiedCount = kept;
+    return removed;
+}
+
+int RZNotificationRegistryContains(const RZNotificationRegistry *registry, uint64_t notification)
+{
+    return RZNotificationHashMapGet(registry->entries, notification, NULL);
+}
+
+// MARK: - Lookup
+
+size_t RZNotificationRegistryCount(const RZNotificationRegistry *registry)
+{
+    return RZNotificationHashMapCount(registry->entries);
+}
+
+size_t RZNotificationRegistryCountForContainer(const RZNotificationRegistry *registry, uint64_t container)
+{
+    RZRegistryList *list = listForKey(registry->containers, container);
+    return list != NULL ? list->count : 0;
+}
+
+size_t RZNotificationRegistryCountForController(const RZNotificationRegistry *registry, uint64_t controller)
+{
+    RZRegistryList *list = listForKey(registry->controllers, controller);
+    return list != NULL ? list->count : 0;
+}
+
+uint64_t RZNotificationRegistryLastForContainer(const RZNotificationRegistry *registry, uint64_t container)
+{
+    RZRegistryList *list = listForKey(registry->containers, container);
+    return list != NULL ? list->last->notification : 0;
+}
+
+uint64_t RZNotificationRegistryLastForController(const RZNotificationRegistry *registry, uint64_t controller)
+{
+    RZRegistryList *list = listForKey(registry->controllers, controller);
+    return list != NULL ? list->last->notification : 0;
+}
+
+size_t RZNotificationRegistryCopyForContainer(const RZNotificationRegistry *registry, uint64_t container, uint64_t *notifications, size_t capacity)
+{
+    return copyList(registry->containers, container, 0, notifications, capacity);
+}
+
+size_t RZNotificationRegistryCopyForController(const RZNotificationRegistry *registry, uint64_t controller, uint64_t *notifications, size_t capacity)
+{
+    return copyList(registry->controllers, controller, 1, notifications, capacity);
+}
@@ -0,0 +1,75 @@
+//
+//  RZNotificationRegistry.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationRegistry_h
+#define RZNotificationView_RZNotificationRegistry_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Index of the visible notifications, by container and by context controller.
+ * Notifications, containers and controllers are opaque non zero keys, usually pointers.
+ * Each container and each controller keeps its notifications in insertion order.
+ * Insert, remove, contains and last lookups are O(1).
+ */
+typedef struct RZNotificationRegistry RZNotificationRegistry;
+
+RZNotificationRegistry *RZNotificationRegistryCreate(void);
+void RZNotificationRegistryDestroy(RZNotificationRegistry *registry);
+
+/*
+ * controller is 0 when the notification has no context controller.
+ * Returns 0 when the notification is already registered or memory could not be allocated
+ */
+int RZNotificationRegistryInsert(RZNotificationRegistry *registry, uint64_t notification, uint64_t container, uint64_t controller);
+
+/*
+ * Returns non zero when the notification was registered
+ */
+int RZNotificationRegistryRemove(RZNotificationRegistry *registry, uint64_t notification);
+
+/*
+ * Remove a batch of notifications, unknown ones are skipped. Returns how many were removed
+ */
+size_t RZNotificationRegistryRemoveMany(RZNotificationRegistry *registry, const uint64_t *notifications, size_t count);
+
+/*
+ * Like RemoveMany, and copy to emptied the containers the batch left without any notification,
+ * each once, in order of first removal. emptied holds at least count keys
+ */
+size_t RZNotificationRegistryRemoveManyEmptying(RZNotificationRegistry *registry, const uint64_t *notifications, size_t count, uint64_t *emptied, size_t *emptiedCount);
+
+int RZNotificationRegistryContains(const RZNotificationRegistry *registry, uint64_t notification);
+
+size_t RZNotificationRegistryCount(const RZNotificationRegistry *registry);
+size_t RZNotificationRegistryCountForContainer(const RZNotificationRegistry *registry, uint64_t container);
+size_t RZNotificationRegistryCountForController(const RZNotificationRegistry *registry, uint64_t controller);
+
+/*
+ * Most recently inserted notification, 0 when there is none
+ */
+uint64_t RZNotificationRegistryLastForContainer(const RZNotificationRegistry *registry, uint64_t container);
+uint64_t RZNotificationRegistryLastForController(const RZNotificationRegistry *registry, uint64_t controller);
+
+/*
+ * Copy up to capacity notifications, oldest first. Returns the total count,
+ * which can be larger than capacity
+ */
+size_t RZNotificationRegistryCopyForContainer(const RZNotificationRegistry *registry, uint64_t container, uint64_t *notifications, size_t capacity);
+size_t RZNotificationRegistryCopyForController(const RZNotificationRegistry *registry, uint64_t controller, uint64_t *notifications, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,659 @@
+//
+//  RZNotificationReplay.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationReplay.h"
+
+#include "RZNotificationHashMap.h"
+#include "RZNotificationLayout.h"
+#include "RZNotificationRegistry.h"
+#include "RZNotificationScheduler.h"
+#include "RZNotificationStack.h"
+#include "RZNotificationTimerWheel.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Metrics of RZNotificationView
+#define kRZReplayOffsetX 16.0
+#define kRZReplayContentMarginHeight 16.0
+#define kRZReplayIconWidth 21.0
+#define kRZReplayIconHeight 22.0
+
+#define kRZReplayMinReadyDelay 1e-6
+
+typedef struct RZReplayNotification RZReplayNotification;
+
+struct RZReplayNotification {
+    uint64_t key;
+    uint64_t container;
+    uint64_t request;               // Scheduler identifier, 0 when shown without scheduler
+    uint64_t timer;                 // 0 when no hide is pending
+    double duration;
+    double width;
+    double height;
+    double contentHeight;
+    int bottom;
+    int visible;
+    RZReplayNotification *nextReusable;
+};
+
+typedef struct {
+    uint64_t key;
+    RZNotificationScheduler *scheduler;
+    RZNotificationHashMap *requests;        // Scheduler identifier to notification
+    RZNotificationStack *stacks[2];         // Top and bottom, NULL when overlapping
+} RZReplayContainer;
+
+typedef struct {
+    double *values;
+    size_t count;
+    size_t capacity;
+} RZReplaySamples;
+
+typedef struct {
+    const RZNotificationReplayConfig *config;
+    RZNotificationReplayReport *report;
+    double now;                             // Full speed clock
+    double wallStart;
+    RZNotificationRegistry *registry;
+    RZNotificationTimerWheel *wheel;
+    RZNotificationHashMap *notifications;   // Recorded key to notification
+    RZNotificationHashMap *timers;          // Timer identifier to notification
+    RZNotificationHashMap *containers;
+    RZReplayNotification *reusable;
+    size_t reusableCount;
+    size_t pendingCount;
+    uint64_t *scratch;                      // Notifications of a rotated container
+    size_t scratchCapacity;
+    RZReplaySamples samples[RZNotificationReplayLatencyCount];
+    int failed;
+} RZReplay;
+
+RZNotificationReplayConfig RZNotificationReplayDefaultConfig(void)
+{
+    RZNotificationReplayConfig config;
+    memset(&config, 0, sizeof(config));
+    config.burst = 1.0;
+    config.stackSpacing = 8.0;
+    config.minHeight = 54.0;
+    return config;
+}
+
+static double replayNow(void *context)
+{
+    RZReplay *replay = context;
+    if (replay->config->realTime) {
+        return RZNotificationMonotonicTime(NULL) - replay->wallStart;
+    }
+    return replay->now;
+}
+
+static void advanceTo(RZReplay *replay, double time)
+{
+    if (!replay->config->realTime) {
+        if (time > replay->now) {
+            replay->now = time;
+        }
+        return;
+    }
+    double delay;
+    while ((delay = time - replayNow(replay)) > 0.0) {
+        struct timespec duration;
+        duration.tv_sec = (time_t)delay;
+        duration.tv_nsec = (long)((delay - (double)duration.tv_sec) * 1e9);
+        nanosleep(&duration, NULL);
+    }
+}
+
+static void addSample(RZReplay *replay, int kind, double begin)
+{
+    RZReplaySamples *samples = &replay->samples[kind];
+    if (samples->count == samples->capacity) {
+        size_t capacity = samples->capacity ? samples->capacity * 2 : 256;
+        double *values = realloc(samples->values, capacity * sizeof(double));
+        if (values == NULL) {
+            replay->failed = 1;
+            return;
+        }
+        samples->values = values;
+        samples->capacity = capacity;
+    }
+    samples->values[samples->count++] = RZNotificationMonotonicTime(NULL) - begin;
+}
+
+// MARK: - Notifications
+
+static RZReplayNotification *dequeueNotification(RZReplay *replay)
+{
+    RZReplayNotification *notification = replay->reusable;
+    if (notification != NULL) {
+        replay->reusable = notification->nextReusable;
+        replay->reusableCount--;
+        replay->report->reuses++;
+    }
+    else {
+        notification = malloc(sizeof(RZReplayNotification));
+        if (notification == NULL) {
+            replay->failed = 1;
+            return NULL;
+        }
+        replay->report->allocations++;
+    }
+    memset(notification, 0, sizeof(RZReplayNotification));
+    return notification;
+}
+
+static void enqueueNotification(RZReplay *replay, RZReplayNotification *notification)
+{
+    if (replay->reusableCount < replay->config->reusePoolSize) {
+        notification->nextReusable = replay->reusable;
+        replay->reusable = notification;
+        replay->reusableCount++;
+    }
+    else {
+        free(notification);
+    }
+}
+
+static void layoutNotification(RZReplay *replay, RZReplayNotification *notification)
+{
+    RZNotificationLayoutInput input;
+    memset(&input, 0, sizeof(input));
+    input.bounds = RZNotificationRectMake(0.0, 0.0, notification->width, notification->height);
+    input.hasIcon = 1;
+    input.hasAnchor = 1;
+    input.offsetX = kRZReplayOffsetX;
+    input.contentMarginHeight = kRZReplayContentMarginHeight;
+    input.iconWidth = kRZReplayIconWidth;
+    input.iconHeight = kRZReplayIconHeight;
+
+    RZNotificationLayoutResult result;
+    RZNotificationLayoutCompute(&input, &result);
+    if (notification->contentHeight <= 0.0) {
+        notification->contentHeight = result.contentFrame.height;
+    }
+    // The text is not measured again, the height follows the margins and the minimum height
+    notification->height = RZNotificationLayoutHeightForContentHeight(&input, notification->contentHeight, replay->config->minHeight);
+    replay->report->layouts++;
+}
+
+static void updatePeaks(RZReplay *replay)
+{
+    size_t live = RZNotificationRegistryCount(replay->registry);
+    if (live > replay->report->peakLiveCount) {
+        replay->report->peakLiveCount = live;
+    }
+    if (replay->pendingCount > replay->report->peakPendingCount) {
+        replay->report->peakPendingCount = replay->pendingCount;
+    }
+}
+
+// MARK: - Containers
+
+static RZReplayContainer *containerForKey(RZReplay *replay, uint64_t key)
+{
+    void *value = NULL;
+    if (RZNotificationHashMapGet(replay->containers, key, &value)) {
+        return value;
+    }
+
+    RZReplayContainer *container = calloc(1, sizeof(RZReplayContainer));
+    if (container == NULL) {
+        replay->failed = 1;
+        return NULL;
+    }
+    container->key = key;
+    RZNotificationSchedulerConfig config = RZNotificationSchedulerDefaultConfig();
+    config.maxVisible = replay->config->maxVisible;
+    config.ratePerSecond = replay->config->ratePerSecond;
+    config.burst = replay->config->burst;
+    config.coalesce = replay->config->coalesce;
+    config.clock.now = replayNow;
+    config.clock.context = replay;
+    container->scheduler = RZNotificationSchedulerCreate(&config);
+    container->requests = RZNotificationHashMapCreate(16);
+    if (replay->config->stack) {
+        container->stacks[0] = RZNotificationStackCreate(replay->config->stackSpacing, replay->config->stackMaxVisible);
+        container->stacks[1] = RZNotificationStackCreate(replay->config->stackSpacing, replay->config->stackMaxVisible);
+    }
+    if (container->scheduler == NULL || container->requests == NULL
+        || (replay->config->stack && (container->stacks[0] == NULL || container->stacks[1] == NULL))
+        || !RZNotificationHashMapSet(replay->containers, key, container)) {
+        RZNotificationSchedulerDestroy(container->scheduler);
+        RZNotificationHashMapDestroy(container->requests);
+        RZNotificationStackDestroy(container->stacks[0]);
+        RZNotificationStackDestroy(container->stacks[1]);
+        free(container);
+        replay->failed = 1;
+        return NULL;
+    }
+    return container;
+}
+
+static void destroyContainer(uint64_t key, void *value, void *context)
+{
+    RZReplayContainer *container = value;
+    (void)key;
+    (void)context;
+    RZNotificationSchedulerDestroy(container->scheduler);
+    RZNotificationHashMapDestroy(container->requests);
+    RZNotificationStackDestroy(container->stacks[0]);
+    RZNotificationStackDestroy(container->stacks[1]);
+    free(container);
+}
+
+// Like the stack layout of the manager, which moves every changed notification
+static void takeStackChanges(RZReplay *replay, RZNotificationStack *stack)
+{
+    RZNotificationStackChange changes[16];
+    size_t remaining;
+    while ((remaining = RZNotificationStackTakeChanges(stack, changes, 16)) > 0) {
+        replay->report->stackMoves += remaining < 16 ? remaining : 16;
+    }
+}
+
+// MARK: - Show and hide
+
+static void showNotification(RZReplay *replay, RZReplayContainer *container, RZReplayNotification *notification)
+{
+    if (!RZNotificationRegistryInsert(replay->registry, notification->key, container->key, 0)) {
+        replay->failed = 1;
+        return;
+    }
+    notification->visible = 1;
+    replay->report->shown++;
+
+    RZNotificationStack *stack = container->stacks[notification->bottom ? 1 : 0];
+    if (stack != NULL && RZNotificationStackInsert(stack, notification->key, 0, notification->height)) {
+        takeStackChanges(replay, stack);
+    }
+
+    if (notification->duration > 0.0) {
+        notification->timer = RZNotificationTimerWheelSchedule(replay->wheel, notification->duration);
+        if (notification->timer == 0 || !RZNotificationHashMapSet(replay->timers, notification->timer, notification)) {
+            replay->failed = 1;
+        }
+    }
+    updatePeaks(replay);
+}
+
+static void drainContainer(RZReplay *replay, RZReplayContainer *container)
+{
+    RZNotificationScheduledRequest request;
+    while (RZNotificationSchedulerNext(container->scheduler, &request)) {
+        void *value = NULL;
+        if (RZNotificationHashMapGet(container->requests, request.identifier, &value)) {
+            replay->pendingCount--;
+            showNotification(replay, container, value);
+        }
+    }
+}
+
+static void drainReadyContainer(uint64_t key, void *value, void *context)
+{
+    (void)key;
+    RZReplay *replay = context;
+    if (replay->pendingCount > 0) {
+        drainContainer(replay, value);
+    }
+}
+
+static void earliestReadyDelay(uint64_t key, void *value, void *context)
+{
+    RZReplayContainer *container = value;
+    double *time = context;
+    (void)key;
+    double delay = RZNotificationSchedulerNextReadyDelay(container->scheduler);
+    if (delay > 0.0 && delay < *time) {
+        *time = delay;
+    }
+}
+
+static void cancelTimer(RZReplay *replay, RZReplayNotification *notification)
+{
+    if (notification->timer != 0) {
+        RZNotificationTimerWheelCancel(replay->wheel, notification->timer);
+        RZNotificationHashMapRemove(replay->timers, notification->timer, NULL);
+        notification->timer = 0;
+    }
+}
+
+static void hideNotification(RZReplay *replay, RZReplayNotification *notification)
+{
+    RZReplayContainer *container = containerForKey(replay, notification->container);
+    if (container == NULL) {
+        return;
+    }
+
+    if (notification->visible) {
+        RZNotificationRegistryRemove(replay->registry, notification->key);
+        for (int edge = 0; edge < 2; edge++) {
+            if (container->stacks[edge] != NULL && RZNotificationStackRemove(container->stacks[edge], notification->key)) {
+                takeStackChanges(replay, container->stacks[edge]);
+            }
+        }
+        cancelTimer(replay, notification);
+        if (notification->request != 0) {
+            RZNotificationSchedulerDidHide(container->scheduler, notification->request);
+        }
+    }
+    else if (RZNotificationSchedulerCancel(container->scheduler, notification->request)) {
+        replay->pendingCount--;
+    }
+
+    if (notification->request != 0) {
+        RZNotificationHashMapRemove(container->requests, notification->request, NULL);
+    }
+    RZNotificationHashMapRemove(replay->notifications, notification->key, NULL);
+    enqueueNotification(replay, notification);
+
+    // A visible slot is free
+    drainContainer(replay, container);
+}
+
+static void timerFired(uint64_t identifier, void *context)
+{
+    RZReplay *replay = context;
+    double begin = RZNotificationMonotonicTime(NULL);
+    void *value = NULL;
+    if (RZNotificationHashMapRemove(replay->timers, identifier, &value)) {
+        RZReplayNotification *notification = value;
+        notification->timer = 0;
+        replay->report->expired++;
+        hideNotification(replay, notification);
+    }
+    addSample(replay, RZNotificationReplayTimerLatency, begin);
+}
+
+// MARK: - Events
+
+static void replayShow(RZReplay *replay, const RZNotificationEvent *event)
+{
+    void *value = NULL;
+    if (RZNotificationHashMapGet(replay->notifications, event->notification, &value)) {
+        // Reused by the app: its previous show ended after the replay timer, finish it first
+        hideNotification(replay, value);
+    }
+
+    RZReplayContainer *container = containerForKey(replay, event->container);
+    RZReplayNotification *notification = container ? dequeueNotification(replay) : NULL;
+    if (notification == NULL) {
+        return;
+    }
+    notification->key = event->notification;
+    notification->container = event->container;
+    notification->duration = event->duration;
+    notification->width = event->width;
+    notification->height = event->height;
+    notification->bottom = event->bottom;
+    layoutNotification(replay, notification);
+
+    uint64_t identifier = 0;
+    uint64_t coalescingKey = replay->config->coalesce ? event->coalescingKey : 0;
+    switch (RZNotificationSchedulerSubmit(container->scheduler, coalescingKey, event->priority, &identifier)) {
+        case RZNotificationScheduleQueued:
+            notification->request = identifier;
+            if (!RZNotificationHashMapSet(container->requests, identifier, notification)
+                || !RZNotificationHashMapSet(replay->notifications, notification->key, notification)) {
+                replay->failed = 1;
+                return;
+            }
+            replay->pendingCount++;
+            drainContainer(replay, container);
+            // Still pending when no slot is free
+            updatePeaks(replay);
+            break;
+
+        case RZNotificationScheduleCoalescedPending:
+        case RZNotificationScheduleCoalescedVisible:
+            replay->report->coalesced++;
+            if (RZNotificationHashMapGet(container->requests, identifier, &value)) {
+                RZReplayNotification *existing = value;
+                if (existing->visible && existing->duration > 0.0) {
+                    // Kept on screen for a full duration
+                    cancelTimer(replay, existing);
+                    existing->timer = RZNotificationTimerWheelSchedule(replay->wheel, existing->duration);
+                    RZNotificationHashMapSet(replay->timers, existing->timer, existing);
+                }
+            }
+            enqueueNotification(replay, notification);
+            break;
+
+        case RZNotificationScheduleFailed:
+        default:
+            if (!RZNotificationHashMapSet(replay->notifications, notification->key, notification)) {
+                replay->failed = 1;
+                return;
+            }
+            showNotification(replay, container, notification);
+            break;
+    }
+}
+
+static void replayHide(RZReplay *replay, const RZNotificationEvent *event)
+{
+    void *value = NULL;
+    if ((event->flags & RZNotificationEventFlagExpired) == 0
+        && RZNotificationHashMapGet(replay->notifications, event->notification, &value)) {
+        hideNotification(replay, value);
+    }
+}
+
+static void replayTouch(RZReplay *replay, const RZNotificationEvent *event)
+{
+    void *value = NULL;
+    if (RZNotificationHashMapGet(replay->notifications, event->notification, &value)) {
+        // The countdown stops under the finger, the hide is recorded next
+        RZReplayNotification *notification = value;
+        if (notification->timer != 0) {
+            RZNotificationTimerWheelPauseTimer(replay->wheel, notification->timer);
+        }
+    }
+}
+
+static void replayRotate(RZReplay *replay, const RZNotificationEvent *event)
+{
+    void *value = NULL;
+    if (!RZNotificationHashMapGet(replay->containers, event->container, &value)) {
+        return;
+    }
+    RZReplayContainer *container = value;
+
+    size_t count = RZNotificationRegistryCopyForContainer(replay->registry, container->key, replay->scratch, replay->scratchCapacity);
+    if (count > replay->scratchCapacity) {
+        uint64_t *scratch = realloc(replay->scratch, count * sizeof(uint64_t));
+        if (scratch == NULL) {
+            replay->failed = 1;
+            return;
+        }
+        replay->scratch = scratch;
+        replay->scratchCapacity = count;
+        RZNotificationRegistryCopyForContainer(replay->registry, container->key, replay->scratch, replay->scratchCapacity);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (!RZNotificationHashMapGet(replay->notifications, replay->scratch[i], &value)) {
+            continue;
+        }
+        RZReplayNotification *notification = value;
+        notification->width = event->width;
+        layoutNotification(replay, notification);
+        RZNotificationStack *stack = container->stacks[notification->bottom ? 1 : 0];
+        if (stack != NULL) {
+            RZNotificationStackResize(stack, notification->key, notification->height);
+        }
+    }
+    // Stacked notifications pushed by the resized ones, in a single pass
+    for (int edge = 0; edge < 2; edge++) {
+        if (container->stacks[edge] != NULL) {
+            takeStackChanges(replay, container->stacks[edge]);
+        }
+    }
+}
+
+static void replayEvent(RZReplay *replay, const RZNotificationEvent *event)
+{
+    double begin = RZNotificationMonotonicTime(NULL);
+    switch (event->type) {
+        case RZNotificationEventShow:
+            replayShow(replay, event);
+            break;
+        case RZNotificationEventHide:
+            replayHide(replay, event);
+            break;
+        case RZNotificationEventTouch:
+            replayTouch(replay, event);
+            break;
+        case RZNotificationEventRotate:
+            replayRotate(replay, event);
+            break;
+        default:
+            return;
+    }
+    addSample(replay, event->type, begin);
+}
+
+// MARK: - Report
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank
+static double percentile(const RZReplaySamples *samples, double fraction)
+{
+    size_t rank = (size_t)ceil(fraction * (double)samples->count);
+    return samples->values[rank > 0 ? rank - 1 : 0];
+}
+
+static void summarize(RZReplaySamples *samples, RZNotificationReplayLatency *latency)
+{
+    memset(latency, 0, sizeof(RZNotificationReplayLatency));
+    latency->count = samples->count;
+    if (samples->count == 0) {
+        return;
+    }
+    qsort(samples->values, samples->count, sizeof(double), compareDoubles);
+    latency->p50 = percentile(samples, 0.50);
+    latency->p90 = percentile(samples, 0.90);
+    latency->p99 = percentile(samples, 0.99);
+    latency->max = samples->values[samples->count - 1];
+}
+
+void RZNotificationReplayReportPrint(const RZNotificationReplayReport *report, FILE *file)
+{
+    for (int kind = 0; kind < RZNotificationReplayLatencyCount; kind++) {
+        const RZNotificationReplayLatency *latency = &report->latencies[kind];
+        const char *name = (kind == RZNotificationReplayTimerLatency) ? "Expire" : RZNotificationEventTypeName((RZNotificationEventType)kind);
+        fprintf(file, "%-8s %8zu events  p50 %8.0f ns  p90 %8.0f ns  p99 %8.0f ns  max %8.0f ns\n",
+                name, latency->count, latency->p50 * 1e9, latency->p90 * 1e9, latency->p99 * 1e9, latency->max * 1e9);
+    }
+    fprintf(file, "shown %zu, coalesced %zu, expired %zu, layouts %zu, stack moves %zu\n",
+            report->shown, report->coalesced, report->expired, report->layouts, report->stackMoves);
+    fprintf(file, "peak live %zu, peak pending %zu, allocations %zu, reuses %zu\n",
+            report->peakLiveCount, report->peakPendingCount, report->allocations, report->reuses);
+    fprintf(file, "replayed %.3f s in %.3f s\n", report->replayedDuration, report->wallDuration);
+}
+
+// MARK: - Run
+
+static void freeNotification(uint64_t key, void *value, void *context)
+{
+    (void)key;
+    (void)context;
+    free(value);
+}
+
+int RZNotificationReplayRun(const RZNotificationEventLog *log, const RZNotificationReplayConfig *config, RZNotificationReplayReport *report)
+{
+    RZReplay replay;
+    memset(&replay, 0, sizeof(replay));
+    memset(report, 0, sizeof(RZNotificationReplayReport));
+    replay.config = config;
+    replay.report = report;
+    replay.wallStart = RZNotificationMonotonicTime(NULL);
+
+    RZNotificationClock clock = { replayNow, &replay };
+    replay.registry = RZNotificationRegistryCreate();
+    replay.wheel = RZNotificationTimerWheelCreate(&clock, 0.0, 0);
+    replay.notifications = RZNotificationHashMapCreate(256);
+    replay.timers = RZNotificationHashMapCreate(256);
+    replay.containers = RZNotificationHashMapCreate(16);
+    replay.failed = (replay.registry == NULL || replay.wheel == NULL || replay.notifications == NULL
+                     || replay.timers == NULL || replay.containers == NULL);
+
+    const RZNotificationEvent *events = RZNotificationEventLogEvents(log);
+    size_t count = RZNotificationEventLogCount(log);
+    size_t index = 0;
+    while (!replay.failed) {
+        // Next thing to happen: an event, a hide deadline, or a rate limited request
+        double next = INFINITY;
+        if (index < count) {
+            next = events[index].timestamp;
+        }
+        double deadline = RZNotificationTimerWheelNextDeadline(replay.wheel);
+        if (deadline >= 0.0 && deadline < next) {
+            next = deadline;
+        }
+        if (replay.pendingCount > 0) {
+            double delay = INFINITY;
+            RZNotificationHashMapApply(replay.containers, earliestReadyDelay, &delay);
+            if (!isinf(delay)) {
+                double ready = replayNow(&replay) + fmax(delay, kRZReplayMinReadyDelay);
+                if (ready < next) {
+                    next = ready;
+                }
+            }
+        }
+        if (isinf(next)) {
+            break;
+        }
+        advanceTo(&replay, next);
+
+        // A notification expiring when an event happens is gone before it
+        RZNotificationTimerWheelAdvance(replay.wheel, timerFired, &replay);
+        if (replay.pendingCount > 0) {
+            RZNotificationHashMapApply(replay.containers, drainReadyContainer, &replay);
+        }
+        double now = replayNow(&replay);
+        while (index < count && events[index].timestamp <= now && !replay.failed) {
+            replayEvent(&replay, &events[index++]);
+        }
+    }
+
+    report->replayedDuration = replayNow(&replay);
+    report->wallDuration = RZNotificationMonotonicTime(NULL) - replay.wallStart;
+    for (int kind = 0; kind < RZNotificationReplayLatencyCount; kind++) {
+        summarize(&replay.samples[kind], &report->latencies[kind]);
+        free(replay.samples[kind].values);
+    }
+
+    if (replay.notifications != NULL) {
+        RZNotificationHashMapApply(replay.notifications, freeNotification, NULL);
+    }
+    while (replay.reusable != NULL) {
+        RZReplayNotification *next = replay.reusable->nextReusable;
+        free(replay.reusable);
+        replay.reusable = next;
+    }
+    if (replay.containers != NULL) {
+        RZNotificationHashMapApply(replay.containers, destroyContainer, NULL);
+    }
+    RZNotificationHashMapDestroy(replay.containers);
+    RZNotificationHashMapDestroy(replay.timers);
+    RZNotificationHashMapDestroy(replay.notifications);
+    RZNotificationTimerWheelDestroy(replay.wheel);
+    RZNotificationRegistryDestroy(replay.registry);
+    free(replay.scratch);
+    return !replay.failed;
+}
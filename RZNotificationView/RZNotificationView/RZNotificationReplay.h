@@ -0,0 +1,92 @@
+//
+//  RZNotificationReplay.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationReplay_h
+#define RZNotificationView_RZNotificationReplay_h
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "RZNotificationEventLog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Headless replay of an event log through the same scheduler, registry, stack, layout and
+ * hide timers as the notification manager, without any view.
+ *
+ * At full speed the replay clock jumps from one event or hide deadline to the next, the
+ * result only depends on the log and the config. In real time the events are replayed at
+ * their recorded pace. Recorded hides of expired notifications are skipped, the replay
+ * timers expire them.
+ */
+
+typedef struct {
+    unsigned maxVisible;        // Per container, 0 for unlimited
+    double ratePerSecond;       // 0 disables rate limiting
+    double burst;
+    int coalesce;
+    int stack;                  // RZNotificationLayoutModeStack, overlap otherwise
+    double stackSpacing;
+    unsigned stackMaxVisible;
+    size_t reusePoolSize;       // Released notifications kept for the next shows
+    double minHeight;
+    int realTime;
+} RZNotificationReplayConfig;
+
+/*
+ * Like the manager defaults: no limit, overlap, no reuse, full speed
+ */
+RZNotificationReplayConfig RZNotificationReplayDefaultConfig(void);
+
+/*
+ * Hides of the replay timers, after the recorded event types
+ */
+#define RZNotificationReplayTimerLatency RZNotificationEventTypeCount
+#define RZNotificationReplayLatencyCount (RZNotificationEventTypeCount + 1)
+
+typedef struct {
+    size_t count;
+    double p50;                 // Seconds of processing, wall clock
+    double p90;
+    double p99;
+    double max;
+} RZNotificationReplayLatency;
+
+typedef struct {
+    RZNotificationReplayLatency latencies[RZNotificationReplayLatencyCount];
+    size_t shown;
+    size_t coalesced;
+    size_t expired;             // Hidden by the replay timers
+    size_t peakLiveCount;       // Visible notifications, every container
+    size_t peakPendingCount;    // Waiting in the schedulers
+    size_t allocations;         // Notifications not found in the reuse pool
+    size_t reuses;
+    size_t layouts;             // Layout passes, shows and rotations
+    size_t stackMoves;          // Stacked notifications moved
+    double replayedDuration;    // Clock time covered, seconds
+    double wallDuration;        // Seconds
+} RZNotificationReplayReport;
+
+/*
+ * Returns 0 when memory could not be allocated
+ */
+int RZNotificationReplayRun(const RZNotificationEventLog *log, const RZNotificationReplayConfig *config, RZNotificationReplayReport *report);
+
+/*
+ * One line per latency kind then the totals
+ */
+void RZNotificationReplayReportPrint(const RZNotificationReplayReport *report, FILE *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,146 @@
+//
+//  RZNotificationRequestQueue.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationRequestQueue.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define kRZCacheLineSize 64
+
+/*
+ * A slot can be written when its sequence equals the producer position, and read when it
+ * equals the consumer position + 1 (bounded queue from D. Vyukov)
+ */
+typedef struct {
+    _Atomic size_t sequence;
+    void *request;
+} RZRequestSlot;
+
+struct RZNotificationRequestQueue {
+    RZRequestSlot *slots;
+    size_t mask;
+    // Producers and consumer positions on their own cache lines
+    _Alignas(kRZCacheLineSize) _Atomic size_t tail;
+    _Alignas(kRZCacheLineSize) size_t head;
+    _Alignas(kRZCacheLineSize) _Atomic int awake;   // Cleared by the consumer before draining
+};
+
+// MARK: - Lifecycle
+
+RZNotificationRequestQueue *RZNotificationRequestQueueCreate(size_t capacity)
+{
+    size_t slotCount = 2;
+    while (slotCount < capacity) {
+        slotCount <<= 1;
+    }
+
+    void *memory = NULL;
+    if (posix_memalign(&memory, kRZCacheLineSize, sizeof(RZNotificationRequestQueue)) != 0) {
+        return NULL;
+    }
+    RZNotificationRequestQueue *queue = memory;
+    queue->slots = calloc(slotCount, sizeof(RZRequestSlot));
+    if (queue->slots == NULL) {
+        free(queue);
+        return NULL;
+    }
+    for (size_t i = 0; i < slotCount; i++) {
+        atomic_init(&queue->slots[i].sequence, i);
+    }
+    queue->mask = slotCount - 1;
+    atomic_init(&queue->tail, 0);
+    queue->head = 0;
+    atomic_init(&queue->awake, 0);
+    return queue;
+}
+
+void RZNotificationRequestQueueDestroy(RZNotificationRequestQueue *queue)
+{
+    if (queue == NULL) {
+        return;
+    }
+    free(queue->slots);
+    free(queue);
+}
+
+size_t RZNotificationRequestQueueCapacity(const RZNotificationRequestQueue *queue)
+{
+    return queue->mask + 1;
+}
+
+// MARK: - Producers
+
+RZNotificationRequestQueuePushResult RZNotificationRequestQueuePush(RZNotificationRequestQueue *queue, void *request)
+{
+    size_t position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    RZRequestSlot *slot;
+    for (;;) {
+        slot = &queue->slots[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+        if (difference == 0) {
+            // On failure position is reloaded with the current tail
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+            // The consumer did not read this slot yet, one lap behind
+            return RZNotificationRequestQueueFull;
+        }
+        else {
+            position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+
+    slot->request = request;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+
+    // Pairs with the fence of the consumer: either it sees the request, or this sees the cleared flag
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&queue->awake, memory_order_relaxed)) {
+        return RZNotificationRequestQueuePushed;
+    }
+    // Only one of the producers racing here wakes the consumer up
+    return atomic_exchange_explicit(&queue->awake, 1, memory_order_relaxed) ? RZNotificationRequestQueuePushed : RZNotificationRequestQueuePushedWake;
+}
+
+// MARK: - Consumer
+
+size_t RZNotificationRequestQueueDrain(RZNotificationRequestQueue *queue, size_t maxCount,
+                                       RZNotificationRequestHandler handler, void *context)
+{
+    // Before reading: a request published later sees a cleared flag and asks for a wake up
+    atomic_store_explicit(&queue->awake, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    size_t count = 0;
+    while (maxCount == 0 || count < maxCount) {
+        RZRequestSlot *slot = &queue->slots[queue->head & queue->mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence != queue->head + 1) {
+            break;
+        }
+        void *request = slot->request;
+        // Free for the producer of the next lap
+        atomic_store_explicit(&slot->sequence, queue->head + queue->mask + 1, memory_order_release);
+        queue->head++;
+        count++;
+        handler(request, context);
+    }
+    return count;
+}
+
+int RZNotificationRequestQueueIsEmpty(const RZNotificationRequestQueue *queue)
+{
+    const RZRequestSlot *slot = &queue->slots[queue->head & queue->mask];
+    return atomic_load_explicit(&slot->sequence, memory_order_acquire) != queue->head + 1;
+}
@@ -0,0 +1,74 @@
+//
+//  RZNotificationRequestQueue.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationRequestQueue_h
+#define RZNotificationView_RZNotificationRequestQueue_h
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bounded lock-free queue of show requests, multiple producers and a single consumer.
+ *
+ * Any thread can push, pushing never blocks and never allocates: a producer claims a slot
+ * with a compare and swap on the tail, then publishes it with the slot sequence. Only the
+ * consumer, the main thread, pops.
+ *
+ * The queue also tells producers when the consumer has to be woken up: the first push after
+ * the consumer started draining asks for a wake up, the following ones do not. A burst of
+ * requests then costs a single wake up, whatever the number of producers.
+ */
+typedef struct RZNotificationRequestQueue RZNotificationRequestQueue;
+
+typedef enum {
+    RZNotificationRequestQueueFull = 0,         // Not pushed
+    RZNotificationRequestQueuePushed,
+    RZNotificationRequestQueuePushedWake        // Pushed, the consumer must be woken up
+} RZNotificationRequestQueuePushResult;
+
+typedef void (*RZNotificationRequestHandler)(void *request, void *context);
+
+/*
+ * capacity is rounded up to a power of 2
+ */
+RZNotificationRequestQueue *RZNotificationRequestQueueCreate(size_t capacity);
+
+/*
+ * Requests still queued are not released, drain the queue first
+ */
+void RZNotificationRequestQueueDestroy(RZNotificationRequestQueue *queue);
+
+size_t RZNotificationRequestQueueCapacity(const RZNotificationRequestQueue *queue);
+
+/*
+ * Any thread. request must not be NULL
+ */
+RZNotificationRequestQueuePushResult RZNotificationRequestQueuePush(RZNotificationRequestQueue *queue, void *request);
+
+/*
+ * Consumer only. Call handler for at most maxCount requests, in push order for each producer,
+ * 0 for no limit. Returns the number of requests handled.
+ * A request whose producer is still writing stops the drain, its producer then asks for
+ * a new wake up
+ */
+size_t RZNotificationRequestQueueDrain(RZNotificationRequestQueue *queue, size_t maxCount,
+                                       RZNotificationRequestHandler handler, void *context);
+
+/*
+ * Consumer only. Non zero when no request is ready
+ */
+int RZNotificationRequestQueueIsEmpty(const RZNotificationRequestQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,371 @@
+//
+//  RZNotificationScheduler.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationScheduler.h"
+#include "RZNotificationHashMap.h"
+
+#include <stdlib.h>
+
+typedef struct {
+    uint64_t identifier;
+    uint64_t coalescingKey;
+    uint64_t sequence;   // FIFO order among same priority
+    int priority;
+    unsigned repeatCount;
+    size_t heapIndex;
+    int visible;
+} RZSchedulerItem;
+
+struct RZNotificationScheduler {
+    RZNotificationSchedulerConfig config;
+
+    RZSchedulerItem **heap;  // Pending items, highest priority first
+    size_t heapCount;
+    size_t heapCapacity;
+
+    RZNotificationHashMap *itemsByIdentifier;
+    RZNotificationHashMap *pendingByKey;
+    RZNotificationHashMap *visibleByKey;
+    size_t visibleCount;
+
+    uint64_t nextIdentifier;
+    uint64_t nextSequence;
+
+    double tokens;
+    double lastRefill;
+};
+
+// MARK: - Heap
+
+static int itemBefore(const RZSchedulerItem *a, const RZSchedulerItem *b)
+{
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    return a->sequence < b->sequence;
+}
+
+static void heapSwap(RZNotificationScheduler *scheduler, size_t i, size_t j)
+{
+    RZSchedulerItem *tmp = scheduler->heap[i];
+    scheduler->heap[i] = scheduler->heap[j];
+    scheduler->heap[j] = tmp;
+    scheduler->heap[i]->heapIndex = i;
+    scheduler->heap[j]->heapIndex = j;
+}
+
+static void heapSiftUp(RZNotificationScheduler *scheduler, size_t index)
+{
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!itemBefore(scheduler->heap[index], scheduler->heap[parent])) {
+            break;
+        }
+        heapSwap(scheduler, index, parent);
+        index = parent;
+    }
+}
+
+static void heapSiftDown(RZNotificationScheduler *scheduler, size_t index)
+{
+    for (;;) {
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        size_t best = index;
+        if (left < scheduler->heapCount && itemBefore(scheduler->heap[left], scheduler->heap[best])) {
+            best = left;
+        }
+        if (right < scheduler->heapCount && itemBefore(scheduler->heap[right], scheduler->heap[best])) {
+            best = right;
+        }
+        if (best == index) {
+            break;
+        }
+        heapSwap(scheduler, index, best);
+        index = best;
+    }
+}
+
+static int heapPush(RZNotificationScheduler *scheduler, RZSchedulerItem *item)
+{
+    if (scheduler->heapCount == scheduler->heapCapacity) {
+        size_t capacity = scheduler->heapCapacity ? scheduler->heapCapacity * 2 : 16;
+        RZSchedulerItem **heap = realloc(scheduler->heap, capacity * sizeof(RZSchedulerItem *));
+        if (heap == NULL) {
+            return 0;
+        }
+        scheduler->heap = heap;
+        scheduler->heapCapacity = capacity;
+    }
+    item->heapIndex = scheduler->heapCount;
+    scheduler->heap[scheduler->heapCount++] = item;
+    heapSiftUp(scheduler, item->heapIndex);
+    return 1;
+}
+
+static void heapRemove(RZNotificationScheduler *scheduler, size_t index)
+{
+    size_t last = --scheduler->heapCount;
+    if (index != last) {
+        heapSwap(scheduler, index, last);
+        heapSiftDown(scheduler, index);
+        heapSiftUp(scheduler, index);
+    }
+}
+
+// MARK: - Token bucket
+
+static double burstOf(const RZNotificationSchedulerConfig *config)
+{
+    return config->burst < 1.0 ? 1.0 : config->burst;
+}
+
+static void refill(RZNotificationScheduler *scheduler)
+{
+    if (scheduler->config.ratePerSecond <= 0.0) {
+        return;
+    }
+    double now = RZNotificationClockNow(&scheduler->config.clock);
+    double elapsed = now - scheduler->lastRefill;
+    if (elapsed > 0.0) {
+        double burst = burstOf(&scheduler->config);
+        scheduler->tokens += elapsed * scheduler->config.ratePerSecond;
+        if (scheduler->tokens > burst) {
+            scheduler->tokens = burst;
+        }
+    }
+    scheduler->lastRefill = now;
+}
+
+// MARK: - Lifecycle
+
+RZNotificationSchedulerConfig RZNotificationSchedulerDefaultConfig(void)
+{
+    RZNotificationSchedulerConfig config;
+    config.maxVisible = 0;
+    config.ratePerSecond = 0.0;
+    config.burst = 1.0;
+    config.coalesce = 0;
+    config.clock = RZNotificationSystemClock();
+    return config;
+}
+
+RZNotificationScheduler *RZNotificationSchedulerCreate(const RZNotificationSchedulerConfig *config)
+{
+    RZNotificationScheduler *scheduler = calloc(1, sizeof(RZNotificationScheduler));
+    if (scheduler == NULL) {
+        return NULL;
+    }
+    scheduler->itemsByIdentifier = RZNotificationHashMapCreate(16);
+    scheduler->pendingByKey = RZNotificationHashMapCreate(16);
+    scheduler->visibleByKey = RZNotificationHashMapCreate(16);
+    if (scheduler->itemsByIdentifier == NULL || scheduler->pendingByKey == NULL || scheduler->visibleByKey == NULL) {
+        RZNotificationSchedulerDestroy(scheduler);
+        return NULL;
+    }
+    scheduler->nextIdentifier = 1;
+    RZNotificationSchedulerSetConfig(scheduler, config);
+    scheduler->tokens = burstOf(&scheduler->config);
+    scheduler->lastRefill = RZNotificationClockNow(&scheduler->config.clock);
+    return scheduler;
+}
+
+static void freeItem(uint64_t key, void *value, void *context)
+{
+    (void)key;
+    (void)context;
+    free(value);
+}
+
+void RZNotificationSchedulerDestroy(RZNotificationScheduler *scheduler)
+{
+    if (scheduler == NULL) {
+        return;
+    }
+    if (scheduler->itemsByIdentifier != NULL) {
+        RZNotificationHashMapApply(scheduler->itemsByIdentifier, freeItem, NULL);
+    }
+    RZNotificationHashMapDestroy(scheduler->itemsByIdentifier);
+    RZNotificationHashMapDestroy(scheduler->pendingByKey);
+    RZNotificationHashMapDestroy(scheduler->visibleByKey);
+    free(scheduler->heap);
+    free(scheduler);
+}
+
+void RZNotificationSchedulerSetConfig(RZNotificationScheduler *scheduler, const RZNotificationSchedulerConfig *config)
+{
+    scheduler->config = config != NULL ? *config : RZNotificationSchedulerDefaultConfig();
+    if (scheduler->tokens > burstOf(&scheduler->config)) {
+        scheduler->tokens = burstOf(&scheduler->config);
+    }
+}
+
+// MARK: - Scheduling
+
+RZNotificationScheduleResult RZNotificationSchedulerSubmit(RZNotificationScheduler *scheduler, uint64_t coalescingKey, int priority, uint64_t *identifier)
+{
+    if (scheduler->config.coalesce && coalescingKey != 0) {
+        void *existing = NULL;
+        if (RZNotificationHashMapGet(scheduler->visibleByKey, coalescingKey, &existing)
+            || RZNotificationHashMapGet(scheduler->pendingByKey, coalescingKey, &existing)) {
+            RZSchedulerItem *item = existing;
+            item->repeatCount++;
+            if (!item->visible && priority > item->priority) {
+                // The merged request keeps its place but takes the highest priority
+                item->priority = priority;
+                heapSiftUp(scheduler, item->heapIndex);
+            }
+            if (identifier != NULL) {
+                *identifier = item->identifier;
+            }
+            return item->visible ? RZNotificationScheduleCoalescedVisible : RZNotificationScheduleCoalescedPending;
+        }
+    }
+
+    RZSchedulerItem *item = calloc(1, sizeof(RZSchedulerItem));
+    if (item == NULL) {
+        return RZNotificationScheduleFailed;
+    }
+    item->identifier = scheduler->nextIdentifier++;
+    item->coalescingKey = coalescingKey;
+    item->sequence = scheduler->nextSequence++;
+    item->priority = priority;
+    item->repeatCount = 1;
+
+    if (!RZNotificationHashMapSet(scheduler->itemsByIdentifier, item->identifier, item)) {
+        free(item);
+        return RZNotificationScheduleFailed;
+    }
+    if (!heapPush(scheduler, item)) {
+        RZNotificationHashMapRemove(scheduler->itemsByIdentifier, item->identifier, NULL);
+        free(item);
+        return RZNotificationScheduleFailed;
+    }
+    if (scheduler->config.coalesce && coalescingKey != 0) {
+        RZNotificationHashMapSet(scheduler->pendingByKey, coalescingKey, item);
+    }
+
+    if (identifier != NULL) {
+        *identifier = item->identifier;
+    }
+    return RZNotificationScheduleQueued;
+}
+
+static void removeKey(RZNotificationHashMap *map, const RZSchedulerItem *item)
+{
+    void *existing = NULL;
+    if (item->coalescingKey != 0 && RZNotificationHashMapGet(map, item->coalescingKey, &existing) && existing == item) {
+        RZNotificationHashMapRemove(map, item->coalescingKey, NULL);
+    }
+}
+
+int RZNotificationSchedulerNext(RZNotificationScheduler *scheduler, RZNotificationScheduledRequest *request)
+{
+    if (scheduler->heapCount == 0) {
+        return 0;
+    }
+    if (scheduler->config.maxVisible != 0 && scheduler->visibleCount >= scheduler->config.maxVisible) {
+        return 0;
+    }
+    if (scheduler->config.ratePerSecond > 0.0) {
+        refill(scheduler);
+        if (scheduler->tokens < 1.0) {
+            return 0;
+        }
+        scheduler->tokens -= 1.0;
+    }
+
+    RZSchedulerItem *item = scheduler->heap[0];
+    heapRemove(scheduler, 0);
+    removeKey(scheduler->pendingByKey, item);
+
+    item->visible = 1;
+    scheduler->visibleCount++;
+    if (scheduler->config.coalesce && item->coalescingKey != 0) {
+        RZNotificationHashMapSet(scheduler->visibleByKey, item->coalescingKey, item);
+    }
+
+    if (request != NULL) {
+        request->identifier = item->identifier;
+        request->coalescingKey = item->coalescingKey;
+        request->priority = item->priority;
+        request->repeatCount = item->repeatCount;
+    }
+    return 1;
+}
+
+int RZNotificationSchedulerCancel(RZNotificationScheduler *scheduler, uint64_t identifier)
+{
+    void *value = NULL;
+    if (!RZNotificationHashMapGet(scheduler->itemsByIdentifier, identifier, &value)) {
+        return 0;
+    }
+    RZSchedulerItem *item = value;
+    if (item->visible) {
+        return 0;
+    }
+    heapRemove(scheduler, item->heapIndex);
+    removeKey(scheduler->pendingByKey, item);
+    RZNotificationHashMapRemove(scheduler->itemsByIdentifier, identifier, NULL);
+    free(item);
+    return 1;
+}
+
+int RZNotificationSchedulerDidHide(RZNotificationScheduler *scheduler, uint64_t identifier)
+{
+    void *value = NULL;
+    if (!RZNotificationHashMapGet(scheduler->itemsByIdentifier, identifier, &value)) {
+        return 0;
+    }
+    RZSchedulerItem *item = value;
+    if (!item->visible) {
+        return 0;
+    }
+    removeKey(scheduler->visibleByKey, item);
+    RZNotificationHashMapRemove(scheduler->itemsByIdentifier, identifier, NULL);
+    scheduler->visibleCount--;
+    free(item);
+    return 1;
+}
+
+unsigned RZNotificationSchedulerRepeatCount(const RZNotificationScheduler *scheduler, uint64_t identifier)
+{
+    void *value = NULL;
+    if (!RZNotificationHashMapGet(scheduler->itemsByIdentifier, identifier, &value)) {
+        return 0;
+    }
+    return ((RZSchedulerItem *)value)->repeatCount;
+}
+
+double RZNotificationSchedulerNextReadyDelay(RZNotificationScheduler *scheduler)
+{
+    if (scheduler->heapCount == 0) {
+        return 0.0;
+    }
+    if (scheduler->config.maxVisible != 0 && scheduler->visibleCount >= scheduler->config.maxVisible) {
+        return -1.0;
+    }
+    if (scheduler->config.ratePerSecond <= 0.0) {
+        return 0.0;
+    }
+    refill(scheduler);
+    if (scheduler->tokens >= 1.0) {
+        return 0.0;
+    }
+    return (1.0 - scheduler->tokens) / scheduler->config.ratePerSecond;
+}
+
+size_t RZNotificationSchedulerPendingCount(const RZNotificationScheduler *scheduler)
+{
+    return scheduler->heapCount;
+}
+
+size_t RZNotificationSchedulerVisibleCount(const RZNotificationScheduler *scheduler)
+{
+    return scheduler->visibleCount;
+}
@@ -0,0 +1,100 @@
+//
+//  RZNotificationScheduler.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationScheduler_h
+#define RZNotificationView_RZNotificationScheduler_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "RZNotificationClock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Show queue of one container.
+ * Requests wait by priority then FIFO, at most maxVisible are shown together, a token
+ * bucket limits the show rate and identical requests are merged into a repeat counter.
+ */
+typedef struct RZNotificationScheduler RZNotificationScheduler;
+
+typedef struct {
+    unsigned maxVisible;    // 0 for unlimited
+    double ratePerSecond;   // Token refill rate, 0 disables rate limiting
+    double burst;           // Token bucket capacity, at least 1
+    int coalesce;           // Merge requests sharing a non zero coalescing key
+    RZNotificationClock clock;
+} RZNotificationSchedulerConfig;
+
+typedef enum {
+    RZNotificationScheduleQueued = 0,
+    RZNotificationScheduleCoalescedPending,
+    RZNotificationScheduleCoalescedVisible,
+    RZNotificationScheduleFailed
+} RZNotificationScheduleResult;
+
+typedef struct {
+    uint64_t identifier;
+    uint64_t coalescingKey;
+    int priority;
+    unsigned repeatCount;
+} RZNotificationScheduledRequest;
+
+/*
+ * Unlimited, no rate limit, no coalescing, system clock: every request is ready right away
+ */
+RZNotificationSchedulerConfig RZNotificationSchedulerDefaultConfig(void);
+
+RZNotificationScheduler *RZNotificationSchedulerCreate(const RZNotificationSchedulerConfig *config);
+void RZNotificationSchedulerDestroy(RZNotificationScheduler *scheduler);
+
+void RZNotificationSchedulerSetConfig(RZNotificationScheduler *scheduler, const RZNotificationSchedulerConfig *config);
+
+/*
+ * Queue a request. identifier receives the new request identifier, or the identifier of the
+ * pending or visible request it was merged into
+ */
+RZNotificationScheduleResult RZNotificationSchedulerSubmit(RZNotificationScheduler *scheduler, uint64_t coalescingKey, int priority, uint64_t *identifier);
+
+/*
+ * Pop the next request allowed to be shown now and count it as visible.
+ * Returns 0 when nothing is pending, maxVisible is reached or the bucket is empty
+ */
+int RZNotificationSchedulerNext(RZNotificationScheduler *scheduler, RZNotificationScheduledRequest *request);
+
+/*
+ * Drop a pending request. Returns 0 when it is not pending
+ */
+int RZNotificationSchedulerCancel(RZNotificationScheduler *scheduler, uint64_t identifier);
+
+/*
+ * Release the slot of a visible request. Returns 0 when it is not visible
+ */
+int RZNotificationSchedulerDidHide(RZNotificationScheduler *scheduler, uint64_t identifier);
+
+/*
+ * Number of submissions merged in the request, 1 when nothing was merged, 0 when unknown
+ */
+unsigned RZNotificationSchedulerRepeatCount(const RZNotificationScheduler *scheduler, uint64_t identifier);
+
+/*
+ * Seconds to wait before Next can succeed because of the rate limit.
+ * 0 when a request is ready or nothing is pending, negative when waiting for a visible slot
+ */
+double RZNotificationSchedulerNextReadyDelay(RZNotificationScheduler *scheduler);
+
+size_t RZNotificationSchedulerPendingCount(const RZNotificationScheduler *scheduler);
+size_t RZNotificationSchedulerVisibleCount(const RZNotificationScheduler *scheduler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+//
+//  RZNotificationSoundRegistry.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <AudioToolbox/AudioToolbox.h>
+
+/**
+ Process-wide registry of the system sounds played by notifications.
+
+ Creating a SystemSoundID looks the file up in the main bundle and sets up a decoder, so each
+ sound resource gets a single ID shared by every notification. IDs are reference counted and
+ disposed when the last notification using them releases them.
+ Sounds and vibration are throttled: within the throttle interval, a cue only plays once.
+ */
+@interface RZNotificationSoundRegistry : NSObject
+
+/**
+ The shared registry used by every RZNotificationView
+ */
++ (instancetype) sharedRegistry;
+
+/**
+ Create the sound IDs on a background queue, typically at launch.
+ Preloaded sounds are kept until `removePreloadedSounds`
+ @param soundNames The sound file names, as given to `-[RZNotificationView setSound:]`
+ */
+- (void) preloadSounds:(NSArray *)soundNames;
+
+/**
+ Release the sounds kept by `preloadSounds:`. Sounds still used by a notification stay loaded
+ */
+- (void) removePreloadedSounds;
+
+/**
+ Take a reference on a sound, creating its ID if needed
+ @param soundName The sound file name in the main bundle
+ @return the sound ID, 0 if the file could not be loaded
+ */
+- (SystemSoundID) retainSoundNamed:(NSString *)soundName;
+
+/**
+ Give back a reference taken with `retainSoundNamed:`. The ID is disposed with the last reference
+ @param soundName The sound file name
+ */
+- (void) releaseSoundNamed:(NSString *)soundName;
+
+/**
+ Play a sound, unless it already played within the throttle interval
+ @param soundName The sound file name, it must be retained
+ @return YES if the sound was played
+ */
+- (BOOL) playSoundNamed:(NSString *)soundName;
+
+/**
+ Vibrate, unless the device already vibrated within the throttle interval
+ @return YES if the device vibrated
+ */
+- (BOOL) vibrate;
+
+/**
+ Number of sound IDs currently loaded
+ */
+@property (nonatomic, readonly) NSUInteger numberOfLoadedSounds;
+
+/**
+ Minimum time between two plays of the same cue. Default is 0, no throttling
+ */
+@property (atomic) NSTimeInterval throttleInterval;
+
+@end
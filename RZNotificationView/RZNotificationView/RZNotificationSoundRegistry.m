@@ -0,0 +1,225 @@
+//
+//  RZNotificationSoundRegistry.m
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#import "RZNotificationSoundRegistry.h"
+
+@import QuartzCore;
+
+/**
+ *  A loaded sound and the references on it
+ */
+@interface RZNotificationSound : NSObject
+{
+@public
+    SystemSoundID _soundID;
+    NSUInteger _retainCount;
+    BOOL _preloaded;
+    CFTimeInterval _lastPlayTime; // 0 until played
+}
+@end
+
+@implementation RZNotificationSound
+@end
+
+@interface RZNotificationSoundRegistry ()
+{
+    NSMutableDictionary *_sounds; // Sound name -> RZNotificationSound
+    CFTimeInterval _lastVibrationTime; // 0 until vibrated
+}
+@end
+
+@implementation RZNotificationSoundRegistry
+
++ (instancetype) sharedRegistry
+{
+    static dispatch_once_t pred = 0;
+    __strong static RZNotificationSoundRegistry *_sharedRegistry = nil;
+    dispatch_once(&pred, ^{
+        _sharedRegistry = [[self alloc] init];
+    });
+    return _sharedRegistry;
+}
+
+- (id) init
+{
+    self = [super init];
+    if (self)
+    {
+        _sounds = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (void) dealloc
+{
+    for (RZNotificationSound *sound in [_sounds allValues]) {
+        AudioServicesDisposeSystemSoundID(sound->_soundID);
+    }
+}
+
+#pragma mark - Loading
+
++ (SystemSoundID) createSoundIDNamed:(NSString *)soundName
+{
+    NSURL *soundURL = [[NSBundle mainBundle] URLForResource:[soundName stringByDeletingPathExtension]
+                                              withExtension:[soundName pathExtension]];
+    SystemSoundID soundID = 0;
+    if (!soundURL || AudioServicesCreateSystemSoundID((__bridge CFURLRef)soundURL, &soundID) != kAudioServicesNoError) {
+        return 0;
+    }
+    return soundID;
+}
+
+// Must be called with the registry locked
+- (RZNotificationSound *) soundNamed:(NSString *)soundName createdSoundID:(SystemSoundID)soundID
+{
+    RZNotificationSound *sound = _sounds[soundName];
+    if (sound) {
+        // Loaded by another thread in the meantime
+        if (soundID) {
+            AudioServicesDisposeSystemSoundID(soundID);
+        }
+        return sound;
+    }
+    if (!soundID) {
+        return nil;
+    }
+
+    sound = [[RZNotificationSound alloc] init];
+    sound->_soundID = soundID;
+    _sounds[soundName] = sound;
+    return sound;
+}
+
+// Must be called with the registry locked
+- (void) unloadSoundIfUnused:(NSString *)soundName
+{
+    RZNotificationSound *sound = _sounds[soundName];
+    if (sound && sound->_retainCount == 0 && !sound->_preloaded) {
+        AudioServicesDisposeSystemSoundID(sound->_soundID);
+        [_sounds removeObjectForKey:soundName];
+    }
+}
+
+- (void) preloadSounds:(NSArray *)soundNames
+{
+    NSArray *names = [soundNames copy];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+        for (NSString *soundName in names) {
+            BOOL loaded;
+            @synchronized (self) {
+                loaded = (_sounds[soundName] != nil);
+                if (loaded) {
+                    ((RZNotificationSound *)_sounds[soundName])->_preloaded = YES;
+                }
+            }
+            if (loaded)
+                continue;
+
+            // File lookup and decoder set up, out of the lock
+            SystemSoundID soundID = [RZNotificationSoundRegistry createSoundIDNamed:soundName];
+            @synchronized (self) {
+                RZNotificationSound *sound = [self soundNamed:soundName createdSoundID:soundID];
+                if (sound) {
+                    sound->_preloaded = YES;
+                }
+            }
+        }
+    });
+}
+
+- (void) removePreloadedSounds
+{
+    @synchronized (self) {
+        for (NSString *soundName in [_sounds allKeys]) {
+            ((RZNotificationSound *)_sounds[soundName])->_preloaded = NO;
+            [self unloadSoundIfUnused:soundName];
+        }
+    }
+}
+
+#pragma mark - References
+
+- (SystemSoundID) retainSoundNamed:(NSString *)soundName
+{
+    if (!soundName)
+        return 0;
+
+    @synchronized (self) {
+        RZNotificationSound *sound = _sounds[soundName];
+        if (sound) {
+            sound->_retainCount++;
+            return sound->_soundID;
+        }
+    }
+
+    SystemSoundID soundID = [RZNotificationSoundRegistry createSoundIDNamed:soundName];
+    @synchronized (self) {
+        RZNotificationSound *sound = [self soundNamed:soundName createdSoundID:soundID];
+        if (!sound)
+            return 0;
+        sound->_retainCount++;
+        return sound->_soundID;
+    }
+}
+
+- (void) releaseSoundNamed:(NSString *)soundName
+{
+    if (!soundName)
+        return;
+
+    @synchronized (self) {
+        RZNotificationSound *sound = _sounds[soundName];
+        if (sound && sound->_retainCount > 0) {
+            sound->_retainCount--;
+            [self unloadSoundIfUnused:soundName];
+        }
+    }
+}
+
+- (NSUInteger) numberOfLoadedSounds
+{
+    @synchronized (self) {
+        return [_sounds count];
+    }
+}
+
+#pragma mark - Playing
+
+- (BOOL) playSoundNamed:(NSString *)soundName
+{
+    SystemSoundID soundID = 0;
+    CFTimeInterval now = CACurrentMediaTime();
+
+    @synchronized (self) {
+        RZNotificationSound *sound = _sounds[soundName];
+        if (!sound || (sound->_lastPlayTime > 0.0 && now - sound->_lastPlayTime < self.throttleInterval))
+            return NO;
+        sound->_lastPlayTime = now;
+        soundID = sound->_soundID;
+    }
+
+    AudioServicesPlaySystemSound(soundID);
+    return YES;
+}
+
+- (BOOL) vibrate
+{
+    CFTimeInterval now = CACurrentMediaTime();
+
+    @synchronized (self) {
+        if (_lastVibrationTime > 0.0 && now - _lastVibrationTime < self.throttleInterval)
+            return NO;
+        _lastVibrationTime = now;
+    }
+
+    AudioServicesPlaySystemSound(kSystemSoundID_Vibrate);
+    return YES;
+}
+
+@end
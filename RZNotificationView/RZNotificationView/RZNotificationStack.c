@@ -0,0 +1,222 @@
+//
+//  RZNotificationStack.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationStack.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint64_t item;
+    double height;
+    double offset;
+    int visible;
+    // Last state given by RZNotificationStackTakeChanges
+    int reported;
+    double reportedOffset;
+    int reportedVisible;
+} RZStackEntry;
+
+struct RZNotificationStack {
+    RZStackEntry *entries;
+    size_t count;
+    size_t capacity;
+    double spacing;
+    unsigned maxVisible;
+};
+
+// MARK: - Lifecycle
+
+RZNotificationStack *RZNotificationStackCreate(double spacing, unsigned maxVisible)
+{
+    RZNotificationStack *stack = calloc(1, sizeof(RZNotificationStack));
+    if (stack == NULL) {
+        return NULL;
+    }
+    stack->spacing = spacing;
+    stack->maxVisible = maxVisible;
+    return stack;
+}
+
+void RZNotificationStackDestroy(RZNotificationStack *stack)
+{
+    if (stack == NULL) {
+        return;
+    }
+    free(stack->entries);
+    free(stack);
+}
+
+// MARK: - Layout
+
+static long indexOfItem(const RZNotificationStack *stack, uint64_t item)
+{
+    for (size_t i = 0; i < stack->count; i++) {
+        if (stack->entries[i].item == item) {
+            return (long)i;
+        }
+    }
+    return -1;
+}
+
+// Items before start keep their offset
+static void layoutFrom(RZNotificationStack *stack, size_t start)
+{
+    for (size_t i = start; i < stack->count; i++) {
+        RZStackEntry *entry = &stack->entries[i];
+        if (i == 0) {
+            entry->offset = 0.0;
+        }
+        else {
+            const RZStackEntry *previous = &stack->entries[i - 1];
+            entry->offset = previous->offset + previous->height + stack->spacing;
+        }
+        entry->visible = (stack->maxVisible == 0 || i < stack->maxVisible);
+    }
+}
+
+void RZNotificationStackSetSpacing(RZNotificationStack *stack, double spacing)
+{
+    stack->spacing = spacing;
+    layoutFrom(stack, 1);
+}
+
+void RZNotificationStackSetMaxVisible(RZNotificationStack *stack, unsigned maxVisible)
+{
+    stack->maxVisible = maxVisible;
+    layoutFrom(stack, 0);
+}
+
+// MARK: - Updates
+
+int RZNotificationStackInsert(RZNotificationStack *stack, uint64_t item, size_t index, double height)
+{
+    if (item == 0 || indexOfItem(stack, item) >= 0) {
+        return 0;
+    }
+    if (stack->count == stack->capacity) {
+        size_t capacity = stack->capacity ? stack->capacity * 2 : 8;
+        RZStackEntry *entries = realloc(stack->entries, capacity * sizeof(RZStackEntry));
+        if (entries == NULL) {
+            return 0;
+        }
+        stack->entries = entries;
+        stack->capacity = capacity;
+    }
+
+    if (index > stack->count) {
+        index = stack->count;
+    }
+    memmove(&stack->entries[index + 1], &stack->entries[index], (stack->count - index) * sizeof(RZStackEntry));
+    stack->count++;
+
+    RZStackEntry *entry = &stack->entries[index];
+    memset(entry, 0, sizeof(RZStackEntry));
+    entry->item = item;
+    entry->height = height;
+    layoutFrom(stack, index);
+    return 1;
+}
+
+int RZNotificationStackRemove(RZNotificationStack *stack, uint64_t item)
+{
+    long index = indexOfItem(stack, item);
+    if (index < 0) {
+        return 0;
+    }
+    memmove(&stack->entries[index], &stack->entries[index + 1], (stack->count - (size_t)index - 1) * sizeof(RZStackEntry));
+    stack->count--;
+    layoutFrom(stack, (size_t)index);
+    return 1;
+}
+
+int RZNotificationStackResize(RZNotificationStack *stack, uint64_t item, double height)
+{
+    long index = indexOfItem(stack, item);
+    if (index < 0) {
+        return 0;
+    }
+    if (stack->entries[index].height != height) {
+        stack->entries[index].height = height;
+        // The item itself does not move
+        layoutFrom(stack, (size_t)index + 1);
+    }
+    return 1;
+}
+
+// MARK: - Lookup
+
+size_t RZNotificationStackCount(const RZNotificationStack *stack)
+{
+    return stack->count;
+}
+
+int RZNotificationStackIndex(const RZNotificationStack *stack, uint64_t item, size_t *index)
+{
+    long found = indexOfItem(stack, item);
+    if (found < 0) {
+        return 0;
+    }
+    if (index != NULL) {
+        *index = (size_t)found;
+    }
+    return 1;
+}
+
+int RZNotificationStackOffset(const RZNotificationStack *stack, uint64_t item, double *offset)
+{
+    long index = indexOfItem(stack, item);
+    if (index < 0) {
+        return 0;
+    }
+    if (offset != NULL) {
+        *offset = stack->entries[index].offset;
+    }
+    return 1;
+}
+
+int RZNotificationStackIsVisible(const RZNotificationStack *stack, uint64_t item)
+{
+    long index = indexOfItem(stack, item);
+    return index >= 0 && stack->entries[index].visible;
+}
+
+double RZNotificationStackVisibleHeight(const RZNotificationStack *stack)
+{
+    size_t visibleCount = stack->count;
+    if (stack->maxVisible != 0 && visibleCount > stack->maxVisible) {
+        visibleCount = stack->maxVisible;
+    }
+    if (visibleCount == 0) {
+        return 0.0;
+    }
+    const RZStackEntry *last = &stack->entries[visibleCount - 1];
+    return last->offset + last->height;
+}
+
+size_t RZNotificationStackTakeChanges(RZNotificationStack *stack, RZNotificationStackChange *changes, size_t capacity)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < stack->count; i++) {
+        RZStackEntry *entry = &stack->entries[i];
+        if (entry->reported && entry->reportedOffset == entry->offset && entry->reportedVisible == entry->visible) {
+            continue;
+        }
+        if (count < capacity) {
+            changes[count].item = entry->item;
+            changes[count].offset = entry->offset;
+            changes[count].visible = entry->visible;
+            changes[count].inserted = !entry->reported;
+            entry->reported = 1;
+            entry->reportedOffset = entry->offset;
+            entry->reportedVisible = entry->visible;
+        }
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,83 @@
+//
+//  RZNotificationStack.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationStack_h
+#define RZNotificationView_RZNotificationStack_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Vertical stack of the notifications shown at one edge of a container.
+ * Index 0 is against the edge, each item is offset by the heights of the items before it
+ * plus the spacing. Items past maxVisible are hidden.
+ *
+ * Insert, remove and resize only recompute the items after the changed one, and record
+ * which items moved so the caller only animates those. Items are opaque non zero keys.
+ * Lookups are linear, a stack holds a handful of notifications.
+ */
+typedef struct RZNotificationStack RZNotificationStack;
+
+typedef struct {
+    uint64_t item;
+    double offset;              // Distance from the container edge
+    int visible;
+    int inserted;               // First change reported for this item
+} RZNotificationStackChange;
+
+/*
+ * maxVisible 0 means no limit
+ */
+RZNotificationStack *RZNotificationStackCreate(double spacing, unsigned maxVisible);
+void RZNotificationStackDestroy(RZNotificationStack *stack);
+
+void RZNotificationStackSetSpacing(RZNotificationStack *stack, double spacing);
+void RZNotificationStackSetMaxVisible(RZNotificationStack *stack, unsigned maxVisible);
+
+/*
+ * index is clamped to the item count. Returns 0 when the item is already stacked
+ * or memory could not be allocated
+ */
+int RZNotificationStackInsert(RZNotificationStack *stack, uint64_t item, size_t index, double height);
+
+/*
+ * Return non zero when the item was stacked
+ */
+int RZNotificationStackRemove(RZNotificationStack *stack, uint64_t item);
+int RZNotificationStackResize(RZNotificationStack *stack, uint64_t item, double height);
+
+size_t RZNotificationStackCount(const RZNotificationStack *stack);
+
+/*
+ * Position of an item. Return 0 when the item is not stacked
+ */
+int RZNotificationStackIndex(const RZNotificationStack *stack, uint64_t item, size_t *index);
+int RZNotificationStackOffset(const RZNotificationStack *stack, uint64_t item, double *offset);
+int RZNotificationStackIsVisible(const RZNotificationStack *stack, uint64_t item);
+
+/*
+ * Height covered by the visible items, spacing included
+ */
+double RZNotificationStackVisibleHeight(const RZNotificationStack *stack);
+
+/*
+ * Copy the items whose offset or visibility changed since the last call, in stack order,
+ * and mark them as reported. Returns the number of changed items, which can be larger
+ * than capacity: the remaining ones are reported by the next call
+ */
+size_t RZNotificationStackTakeChanges(RZNotificationStack *stack, RZNotificationStackChange *changes, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
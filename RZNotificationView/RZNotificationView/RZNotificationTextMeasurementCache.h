@@ -0,0 +1,68 @@
+//
+//  RZNotificationTextMeasurementCache.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#import <UIKit/UIKit.h>
+
+typedef CGFloat (^RZNotificationTextMeasureBlock)(void);
+
+/**
+ LRU cache of measured message heights.
+
+ Apps show the same few messages over and over, and every rotation measures them again.
+ Heights are keyed by message, font, available width and max length, so a repeated message
+ skips text shaping entirely.
+ */
+@interface RZNotificationTextMeasurementCache : NSObject
+
+/**
+ The shared cache used by every RZNotificationView
+ */
++ (instancetype) sharedCache;
+
+/**
+ Return the cached height, measuring it with measureBlock on a miss
+ @param message The full message, before truncation
+ @param font The label font
+ @param width The width available for the text
+ @param maxLength The max length used for tail truncation
+ @param measureBlock The block measuring the text on a cache miss
+ @return the text height
+ */
+- (CGFloat) heightForMessage:(NSString *)message font:(UIFont *)font width:(CGFloat)width maxLength:(NSInteger)maxLength measureBlock:(RZNotificationTextMeasureBlock)measureBlock;
+
+/**
+ Remove all the cached heights. Called automatically on memory warnings
+ */
+- (void) removeAllHeights;
+
+/**
+ Reset hits and misses counters
+ */
+- (void) resetCounters;
+
+/**
+ Maximum number of heights kept in cache. Default is 128
+ */
+@property (nonatomic) NSUInteger countLimit;
+
+/**
+ Number of measurements served from cache
+ */
+@property (nonatomic, readonly) NSUInteger hits;
+
+/**
+ Number of measurements that needed text shaping
+ */
+@property (nonatomic, readonly) NSUInteger misses;
+
+/**
+ hits / (hits + misses), 0 when nothing has been measured yet
+ */
+@property (nonatomic, readonly) double hitRate;
+
+@end
@@ -0,0 +1,230 @@
+//
+//  RZNotificationTextMeasurementCache.m
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#import "RZNotificationTextMeasurementCache.h"
+
+static const NSUInteger kDefaultTextMeasurementCacheCountLimit = 128;
+
+#pragma mark - Key
+
+@interface RZTextMeasurementKey : NSObject <NSCopying>
+@property (nonatomic, copy) NSString *message;
+@property (nonatomic, strong) UIFont *font;
+@property (nonatomic) CGFloat width;
+@property (nonatomic) NSInteger maxLength;
+@end
+
+@implementation RZTextMeasurementKey
+
+- (id) copyWithZone:(NSZone *)zone
+{
+    // Immutable once inserted
+    return self;
+}
+
+- (NSUInteger) hash
+{
+    return [_message hash] ^ ([_font hash] << 1) ^ ((NSUInteger)(_width * 100.0f) << 2) ^ (NSUInteger)_maxLength;
+}
+
+- (BOOL) isEqual:(id)object
+{
+    if (![object isKindOfClass:[RZTextMeasurementKey class]])
+        return NO;
+    
+    RZTextMeasurementKey *other = object;
+    return _width == other.width
+        && _maxLength == other.maxLength
+        && [_font isEqual:other.font]
+        && [_message isEqualToString:other.message];
+}
+
+@end
+
+#pragma mark - Entry
+
+@interface RZTextMeasurementEntry : NSObject
+@property (nonatomic, strong) RZTextMeasurementKey *key;
+@property (nonatomic) CGFloat height;
+@property (nonatomic, strong) RZTextMeasurementEntry *next;
+@property (nonatomic, weak) RZTextMeasurementEntry *previous;
+@end
+
+@implementation RZTextMeasurementEntry
+@end
+
+#pragma mark - Cache
+
+@interface RZNotificationTextMeasurementCache ()
+{
+    NSMutableDictionary *_entries;
+    RZTextMeasurementEntry *_mostRecent;
+    RZTextMeasurementEntry *_leastRecent;
+}
+@end
+
+@implementation RZNotificationTextMeasurementCache
+
++ (instancetype) sharedCache
+{
+    static dispatch_once_t pred = 0;
+    __strong static RZNotificationTextMeasurementCache *_sharedCache = nil;
+    dispatch_once(&pred, ^{
+        _sharedCache = [[self alloc] init];
+    });
+    return _sharedCache;
+}
+
+- (id) init
+{
+    self = [super init];
+    if (self)
+    {
+        _entries = [NSMutableDictionary dictionary];
+        _countLimit = kDefaultTextMeasurementCacheCountLimit;
+        
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(didReceiveMemoryWarning:)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+    }
+    return self;
+}
+
+- (void) dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+}
+
+#pragma mark - LRU list
+
+- (void) unlinkEntry:(RZTextMeasurementEntry *)entry
+{
+    RZTextMeasurementEntry *previous = entry.previous;
+    RZTextMeasurementEntry *next = entry.next;
+    
+    if (previous)
+        previous.next = next;
+    else
+        _mostRecent = next;
+    
+    if (next)
+        next.previous = previous;
+    else
+        _leastRecent = previous;
+    
+    entry.next = nil;
+    entry.previous = nil;
+}
+
+- (void) pushEntry:(RZTextMeasurementEntry *)entry
+{
+    entry.next = _mostRecent;
+    _mostRecent.previous = entry;
+    _mostRecent = entry;
+    if (!_leastRecent)
+        _leastRecent = entry;
+}
+
+- (void) evictIfNeeded
+{
+    while ([_entries count] > _countLimit && _leastRecent) {
+        RZTextMeasurementEntry *entry = _leastRecent;
+        [self unlinkEntry:entry];
+        [_entries removeObjectForKey:entry.key];
+    }
+}
+
+#pragma mark - Lookup
+
+- (CGFloat) heightForMessage:(NSString *)message font:(UIFont *)font width:(CGFloat)width maxLength:(NSInteger)maxLength measureBlock:(RZNotificationTextMeasureBlock)measureBlock
+{
+    if (!message || !font)
+        return measureBlock ? measureBlock() : 0.0f;
+    
+    RZTextMeasurementKey *key = [[RZTextMeasurementKey alloc] init];
+    key.message = message;
+    key.font = font;
+    key.width = width;
+    key.maxLength = maxLength;
+    
+    @synchronized (self)
+    {
+        RZTextMeasurementEntry *entry = [_entries objectForKey:key];
+        if (entry) {
+            _hits++;
+            [self unlinkEntry:entry];
+            [self pushEntry:entry];
+            return entry.height;
+        }
+        _misses++;
+    }
+    
+    CGFloat height = measureBlock ? measureBlock() : 0.0f;
+    
+    @synchronized (self)
+    {
+        if (![_entries objectForKey:key]) {
+            RZTextMeasurementEntry *entry = [[RZTextMeasurementEntry alloc] init];
+            entry.key = key;
+            entry.height = height;
+            [_entries setObject:entry forKey:key];
+            [self pushEntry:entry];
+            [self evictIfNeeded];
+        }
+    }
+    return height;
+}
+
+- (void) setCountLimit:(NSUInteger)countLimit
+{
+    @synchronized (self)
+    {
+        _countLimit = countLimit;
+        [self evictIfNeeded];
+    }
+}
+
+- (double) hitRate
+{
+    @synchronized (self)
+    {
+        NSUInteger total = _hits + _misses;
+        return total ? (double)_hits / (double)total : 0.0;
+    }
+}
+
+#pragma mark - Purge
+
+- (void) removeAllHeights
+{
+    @synchronized (self)
+    {
+        // Break the strong next chain before dropping the entries
+        while (_leastRecent) {
+            [self unlinkEntry:_leastRecent];
+        }
+        [_entries removeAllObjects];
+    }
+}
+
+- (void) resetCounters
+{
+    @synchronized (self)
+    {
+        _hits = 0;
+        _misses = 0;
+    }
+}
+
+- (void) didReceiveMemoryWarning:(NSNotification *)notification
+{
+    [self removeAllHeights];
+}
+
+@end
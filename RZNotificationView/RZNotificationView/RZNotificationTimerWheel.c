@@ -0,0 +1,447 @@
+//
+//  RZNotificationTimerWheel.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationTimerWheel.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define RZTimerNil UINT32_MAX
+
+static const double kDefaultResolution = 1.0 / 30.0;
+static const unsigned kDefaultSlotCount = 256;
+
+enum {
+    RZTimerStateFree = 0,
+    RZTimerStateScheduled,
+    RZTimerStatePaused
+};
+
+typedef struct {
+    uint64_t tick;       // Deadline, in ticks of wheel time
+    uint64_t sequence;   // Scheduling order among same tick
+    double remaining;    // Paused timers only
+    uint32_t next;       // Slot list, or free list
+    uint32_t previous;
+    uint32_t generation;
+    uint32_t state;
+} RZTimerEntry;
+
+typedef struct {
+    uint64_t identifier;
+    uint64_t tick;
+    uint64_t sequence;
+} RZExpiredTimer;
+
+struct RZNotificationTimerWheel {
+    RZNotificationClock clock;
+    double resolution;
+
+    uint32_t *slots;     // Head entry of each slot
+    uint64_t slotMask;
+    uint64_t currentTick; // Every tick up to this one has been processed
+
+    RZTimerEntry *entries;
+    uint32_t entryCount;
+    uint32_t entryCapacity;
+    uint32_t freeList;
+    size_t count;
+    uint64_t nextSequence;
+
+    int paused;
+    double pausedAt;
+    double pausedTotal;
+
+    RZExpiredTimer *expired;
+    size_t expiredCapacity;
+};
+
+// MARK: - Time
+
+static double wheelTime(const RZNotificationTimerWheel *wheel)
+{
+    double now = wheel->paused ? wheel->pausedAt : RZNotificationClockNow(&wheel->clock);
+    return now - wheel->pausedTotal;
+}
+
+// Time at which a tick is reached
+static double tickTime(const RZNotificationTimerWheel *wheel, uint64_t tick)
+{
+    return (double)tick * wheel->resolution;
+}
+
+// Last tick reached at time. The quotient can round either way, the tick times decide
+static uint64_t tickFloor(const RZNotificationTimerWheel *wheel, double time)
+{
+    if (time <= 0.0) {
+        return 0;
+    }
+    uint64_t tick = (uint64_t)floor(time / wheel->resolution);
+    if (tick > 0 && tickTime(wheel, tick) > time) {
+        tick--;
+    }
+    else if (tickTime(wheel, tick + 1) <= time) {
+        tick++;
+    }
+    return tick;
+}
+
+static uint64_t tickCeil(const RZNotificationTimerWheel *wheel, double time)
+{
+    return time <= 0.0 ? 0 : (uint64_t)ceil(time / wheel->resolution);
+}
+
+// MARK: - Entries
+
+static uint64_t makeIdentifier(uint32_t index, uint32_t generation)
+{
+    return ((uint64_t)generation << 32) | index;
+}
+
+static RZTimerEntry *entryForIdentifier(const RZNotificationTimerWheel *wheel, uint64_t identifier)
+{
+    uint32_t index = (uint32_t)(identifier & 0xffffffffu);
+    uint32_t generation = (uint32_t)(identifier >> 32);
+    if (index >= wheel->entryCount) {
+        return NULL;
+    }
+    RZTimerEntry *entry = &wheel->entries[index];
+    if (entry->state == RZTimerStateFree || entry->generation != generation) {
+        return NULL;
+    }
+    return entry;
+}
+
+static uint32_t allocateEntry(RZNotificationTimerWheel *wheel)
+{
+    if (wheel->freeList != RZTimerNil) {
+        uint32_t index = wheel->freeList;
+        wheel->freeList = wheel->entries[index].next;
+        return index;
+    }
+    if (wheel->entryCount == wheel->entryCapacity) {
+        uint32_t capacity = wheel->entryCapacity ? wheel->entryCapacity * 2 : 16;
+        RZTimerEntry *entries = realloc(wheel->entries, capacity * sizeof(RZTimerEntry));
+        if (entries == NULL) {
+            return RZTimerNil;
+        }
+        wheel->entries = entries;
+        wheel->entryCapacity = capacity;
+    }
+    uint32_t index = wheel->entryCount++;
+    wheel->entries[index].generation = 0;
+    wheel->entries[index].state = RZTimerStateFree;
+    return index;
+}
+
+static void freeEntry(RZNotificationTimerWheel *wheel, uint32_t index)
+{
+    RZTimerEntry *entry = &wheel->entries[index];
+    entry->state = RZTimerStateFree;
+    // Identifiers of the previous use of this entry become invalid
+    entry->generation++;
+    if (entry->generation == 0) {
+        entry->generation = 1;
+    }
+    entry->next = wheel->freeList;
+    wheel->freeList = index;
+    wheel->count--;
+}
+
+static void linkEntry(RZNotificationTimerWheel *wheel, uint32_t index)
+{
+    RZTimerEntry *entry = &wheel->entries[index];
+    uint32_t *head = &wheel->slots[entry->tick & wheel->slotMask];
+    entry->previous = RZTimerNil;
+    entry->next = *head;
+    if (*head != RZTimerNil) {
+        wheel->entries[*head].previous = index;
+    }
+    *head = index;
+    entry->state = RZTimerStateScheduled;
+}
+
+static void unlinkEntry(RZNotificationTimerWheel *wheel, uint32_t index)
+{
+    RZTimerEntry *entry = &wheel->entries[index];
+    if (entry->previous != RZTimerNil) {
+        wheel->entries[entry->previous].next = entry->next;
+    } else {
+        wheel->slots[entry->tick & wheel->slotMask] = entry->next;
+    }
+    if (entry->next != RZTimerNil) {
+        wheel->entries[entry->next].previous = entry->previous;
+    }
+}
+
+static void scheduleEntry(RZNotificationTimerWheel *wheel, uint32_t index, double delay)
+{
+    RZTimerEntry *entry = &wheel->entries[index];
+    uint64_t tick = tickCeil(wheel, wheelTime(wheel) + (delay > 0.0 ? delay : 0.0));
+    // Ticks up to currentTick are already processed
+    entry->tick = tick > wheel->currentTick ? tick : wheel->currentTick + 1;
+    linkEntry(wheel, index);
+}
+
+// MARK: - Life cycle
+
+RZNotificationTimerWheel *RZNotificationTimerWheelCreate(const RZNotificationClock *clock, double resolution, unsigned slotCount)
+{
+    RZNotificationTimerWheel *wheel = calloc(1, sizeof(RZNotificationTimerWheel));
+    if (wheel == NULL) {
+        return NULL;
+    }
+
+    unsigned count = 1;
+    while (count < (slotCount ? slotCount : kDefaultSlotCount)) {
+        count <<= 1;
+    }
+    wheel->slots = malloc(count * sizeof(uint32_t));
+    if (wheel->slots == NULL) {
+        free(wheel);
+        return NULL;
+    }
+    for (unsigned i = 0; i < count; i++) {
+        wheel->slots[i] = RZTimerNil;
+    }
+
+    if (clock) {
+        wheel->clock = *clock;
+    }
+    wheel->resolution = resolution > 0.0 ? resolution : kDefaultResolution;
+    wheel->slotMask = count - 1;
+    wheel->freeList = RZTimerNil;
+    wheel->currentTick = tickFloor(wheel, wheelTime(wheel));
+    return wheel;
+}
+
+void RZNotificationTimerWheelDestroy(RZNotificationTimerWheel *wheel)
+{
+    if (wheel == NULL) {
+        return;
+    }
+    free(wheel->slots);
+    free(wheel->entries);
+    free(wheel->expired);
+    free(wheel);
+}
+
+// MARK: - Timers
+
+uint64_t RZNotificationTimerWheelSchedule(RZNotificationTimerWheel *wheel, double delay)
+{
+    uint32_t index = allocateEntry(wheel);
+    if (index == RZTimerNil) {
+        return 0;
+    }
+    RZTimerEntry *entry = &wheel->entries[index];
+    if (entry->generation == 0) {
+        entry->generation = 1;
+    }
+    entry->sequence = wheel->nextSequence++;
+    wheel->count++;
+    scheduleEntry(wheel, index, delay);
+    return makeIdentifier(index, entry->generation);
+}
+
+int RZNotificationTimerWheelCancel(RZNotificationTimerWheel *wheel, uint64_t identifier)
+{
+    RZTimerEntry *entry = entryForIdentifier(wheel, identifier);
+    if (entry == NULL) {
+        return 0;
+    }
+    uint32_t index = (uint32_t)(entry - wheel->entries);
+    if (entry->state == RZTimerStateScheduled) {
+        unlinkEntry(wheel, index);
+    }
+    freeEntry(wheel, index);
+    return 1;
+}
+
+int RZNotificationTimerWheelPauseTimer(RZNotificationTimerWheel *wheel, uint64_t identifier)
+{
+    RZTimerEntry *entry = entryForIdentifier(wheel, identifier);
+    if (entry == NULL || entry->state != RZTimerStateScheduled) {
+        return 0;
+    }
+    entry->remaining = RZNotificationTimerWheelRemaining(wheel, identifier);
+    unlinkEntry(wheel, (uint32_t)(entry - wheel->entries));
+    entry->state = RZTimerStatePaused;
+    return 1;
+}
+
+int RZNotificationTimerWheelResumeTimer(RZNotificationTimerWheel *wheel, uint64_t identifier)
+{
+    RZTimerEntry *entry = entryForIdentifier(wheel, identifier);
+    if (entry == NULL || entry->state != RZTimerStatePaused) {
+        return 0;
+    }
+    scheduleEntry(wheel, (uint32_t)(entry - wheel->entries), entry->remaining);
+    return 1;
+}
+
+double RZNotificationTimerWheelRemaining(const RZNotificationTimerWheel *wheel, uint64_t identifier)
+{
+    const RZTimerEntry *entry = entryForIdentifier(wheel, identifier);
+    if (entry == NULL) {
+        return -1.0;
+    }
+    if (entry->state == RZTimerStatePaused) {
+        return entry->remaining;
+    }
+    double remaining = tickTime(wheel, entry->tick) - wheelTime(wheel);
+    return remaining > 0.0 ? remaining : 0.0;
+}
+
+size_t RZNotificationTimerWheelCount(const RZNotificationTimerWheel *wheel)
+{
+    return wheel->count;
+}
+
+// MARK: - Pause
+
+void RZNotificationTimerWheelPause(RZNotificationTimerWheel *wheel)
+{
+    if (wheel->paused) {
+        return;
+    }
+    wheel->pausedAt = RZNotificationClockNow(&wheel->clock);
+    wheel->paused = 1;
+}
+
+void RZNotificationTimerWheelResume(RZNotificationTimerWheel *wheel)
+{
+    if (!wheel->paused) {
+        return;
+    }
+    wheel->pausedTotal += RZNotificationClockNow(&wheel->clock) - wheel->pausedAt;
+    wheel->paused = 0;
+}
+
+int RZNotificationTimerWheelIsPaused(const RZNotificationTimerWheel *wheel)
+{
+    return wheel->paused;
+}
+
+// MARK: - Firing
+
+static int compareExpired(const void *a, const void *b)
+{
+    const RZExpiredTimer *x = a;
+    const RZExpiredTimer *y = b;
+    if (x->tick != y->tick) {
+        return x->tick < y->tick ? -1 : 1;
+    }
+    return x->sequence < y->sequence ? -1 : (x->sequence > y->sequence);
+}
+
+static int appendExpired(RZNotificationTimerWheel *wheel, size_t count, uint32_t index)
+{
+    if (count == wheel->expiredCapacity) {
+        size_t capacity = wheel->expiredCapacity ? wheel->expiredCapacity * 2 : 16;
+        RZExpiredTimer *expired = realloc(wheel->expired, capacity * sizeof(RZExpiredTimer));
+        if (expired == NULL) {
+            return 0;
+        }
+        wheel->expired = expired;
+        wheel->expiredCapacity = capacity;
+    }
+    RZTimerEntry *entry = &wheel->entries[index];
+    wheel->expired[count].identifier = makeIdentifier(index, entry->generation);
+    wheel->expired[count].tick = entry->tick;
+    wheel->expired[count].sequence = entry->sequence;
+    return 1;
+}
+
+size_t RZNotificationTimerWheelAdvance(RZNotificationTimerWheel *wheel, RZNotificationTimerCallback callback, void *context)
+{
+    uint64_t target = tickFloor(wheel, wheelTime(wheel));
+    if (target <= wheel->currentTick) {
+        return 0;
+    }
+
+    // A full turn visits every slot, no need to go further
+    uint64_t steps = target - wheel->currentTick;
+    if (steps > wheel->slotMask + 1) {
+        steps = wheel->slotMask + 1;
+    }
+
+    size_t count = 0;
+    for (uint64_t step = 1; step <= steps; step++) {
+        uint32_t *head = &wheel->slots[(wheel->currentTick + step) & wheel->slotMask];
+        uint32_t index = *head;
+        while (index != RZTimerNil) {
+            RZTimerEntry *entry = &wheel->entries[index];
+            uint32_t next = entry->next;
+            // Later turns stay in the slot
+            if (entry->tick <= target) {
+                if (!appendExpired(wheel, count, index)) {
+                    // Out of memory, fire the rest on the next advance
+                    target = wheel->currentTick + step - 1;
+                    goto fire;
+                }
+                count++;
+                unlinkEntry(wheel, index);
+                freeEntry(wheel, index);
+            }
+            index = next;
+        }
+    }
+
+fire:
+    wheel->currentTick = target;
+    if (count > 1) {
+        qsort(wheel->expired, count, sizeof(RZExpiredTimer), compareExpired);
+    }
+    if (callback) {
+        for (size_t i = 0; i < count; i++) {
+            callback(wheel->expired[i].identifier, context);
+        }
+    }
+    return count;
+}
+
+double RZNotificationTimerWheelNextDeadline(const RZNotificationTimerWheel *wheel)
+{
+    if (wheel->paused || wheel->count == 0) {
+        return -1.0;
+    }
+
+    // Nearest tick within one turn
+    uint64_t nextTick = 0;
+    for (uint64_t step = 1; step <= wheel->slotMask + 1 && nextTick == 0; step++) {
+        uint64_t tick = wheel->currentTick + step;
+        for (uint32_t index = wheel->slots[tick & wheel->slotMask]; index != RZTimerNil; index = wheel->entries[index].next) {
+            if (wheel->entries[index].tick <= tick) {
+                nextTick = tick;
+                break;
+            }
+        }
+    }
+
+    // Only long delays left, look at every timer
+    if (nextTick == 0) {
+        for (uint32_t index = 0; index < wheel->entryCount; index++) {
+            const RZTimerEntry *entry = &wheel->entries[index];
+            if (entry->state == RZTimerStateScheduled && (nextTick == 0 || entry->tick < nextTick)) {
+                nextTick = entry->tick;
+            }
+        }
+        if (nextTick == 0) {
+            // Every timer is paused
+            return -1.0;
+        }
+    }
+
+    // Adding the paused time can round down, the wheel time must reach the tick
+    double deadline = tickTime(wheel, nextTick) + wheel->pausedTotal;
+    while (deadline - wheel->pausedTotal < tickTime(wheel, nextTick)) {
+        deadline = nextafter(deadline, INFINITY);
+    }
+    return deadline;
+}
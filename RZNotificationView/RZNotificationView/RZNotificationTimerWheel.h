@@ -0,0 +1,90 @@
+//
+//  RZNotificationTimerWheel.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationTimerWheel_h
+#define RZNotificationView_RZNotificationTimerWheel_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "RZNotificationClock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Hashed timing wheel holding the hide deadlines of every notification.
+ * Schedule, cancel, pause and resume are O(1). Deadlines are rounded up to the
+ * wheel resolution, so a timer never fires early and at most one tick late.
+ *
+ * The whole wheel can be paused (app in background): its clock stops and every
+ * countdown resumes where it was. A single timer can be paused too (touched notification).
+ */
+typedef struct RZNotificationTimerWheel RZNotificationTimerWheel;
+
+typedef void (*RZNotificationTimerCallback)(uint64_t identifier, void *context);
+
+/*
+ * resolution in seconds, slotCount is rounded up to a power of two.
+ * 0 for either picks a default (1/30 s, 256 slots). clock can be NULL for the system clock
+ */
+RZNotificationTimerWheel *RZNotificationTimerWheelCreate(const RZNotificationClock *clock, double resolution, unsigned slotCount);
+void RZNotificationTimerWheelDestroy(RZNotificationTimerWheel *wheel);
+
+/*
+ * Returns the timer identifier, never 0. 0 when memory could not be allocated
+ */
+uint64_t RZNotificationTimerWheelSchedule(RZNotificationTimerWheel *wheel, double delay);
+
+/*
+ * Returns non zero when the timer was scheduled or paused
+ */
+int RZNotificationTimerWheelCancel(RZNotificationTimerWheel *wheel, uint64_t identifier);
+
+/*
+ * Freeze or restart the countdown of a single timer. Return non zero on success
+ */
+int RZNotificationTimerWheelPauseTimer(RZNotificationTimerWheel *wheel, uint64_t identifier);
+int RZNotificationTimerWheelResumeTimer(RZNotificationTimerWheel *wheel, uint64_t identifier);
+
+/*
+ * Seconds left before the timer fires, negative when the identifier is unknown
+ */
+double RZNotificationTimerWheelRemaining(const RZNotificationTimerWheel *wheel, uint64_t identifier);
+
+/*
+ * Freeze or restart every countdown. Nested calls are not counted
+ */
+void RZNotificationTimerWheelPause(RZNotificationTimerWheel *wheel);
+void RZNotificationTimerWheelResume(RZNotificationTimerWheel *wheel);
+int RZNotificationTimerWheelIsPaused(const RZNotificationTimerWheel *wheel);
+
+/*
+ * Fire every expired timer, in deadline tick order. Returns the number of timers fired.
+ * callback can cancel or schedule timers, but must not advance the wheel.
+ * Timers expiring in the same advance are already collected and fire anyway
+ */
+size_t RZNotificationTimerWheelAdvance(RZNotificationTimerWheel *wheel, RZNotificationTimerCallback callback, void *context);
+
+/*
+ * Clock time of the next tick having a timer, to arm a single timer source.
+ * Negative when nothing is scheduled or the wheel is paused
+ */
+double RZNotificationTimerWheelNextDeadline(const RZNotificationTimerWheel *wheel);
+
+/*
+ * Scheduled and paused timers
+ */
+size_t RZNotificationTimerWheelCount(const RZNotificationTimerWheel *wheel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,283 @@
+//
+//  RZNotificationTrace.c
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationTrace.h"
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Every field is atomic so a reader racing a writer is well defined,
+ * the sequence tells whether the copy is consistent (seqlock)
+ */
+typedef struct {
+    _Atomic uint64_t sequence;      // index + 1 once written, 0 while being written
+    _Atomic uint64_t kind;          // phase << 32 | event
+    _Atomic uint64_t timestamp;     // double bits
+    _Atomic uint64_t duration;      // double bits
+    _Atomic uint64_t notification;
+    _Atomic uint64_t value;
+} RZTraceSlot;
+
+struct RZNotificationTraceBuffer {
+    RZTraceSlot *slots;
+    uint64_t mask;
+    RZNotificationClock clock;
+    _Atomic uint64_t head;          // Next index to write
+    _Atomic uint64_t start;         // First index not cleared
+};
+
+static const char *const RZTraceEventNames[RZNotificationTraceEventCount] = {
+    "Created",
+    "Measured",
+    "AddedToHierarchy",
+    "ShowAnimationStarted",
+    "ShowAnimationEnded",
+    "HideRequested",
+    "HideAnimationStarted",
+    "HideAnimationEnded",
+    "Removed",
+    "Draw",
+    "IconRender",
+    "TextMeasurement"
+};
+
+static const char *const RZTraceCounterNames[RZNotificationTraceCounterCount] = {
+    "Draws",
+    "IconRenders",
+    "TextMeasurements",
+    "LiveViews"
+};
+
+static _Atomic(RZNotificationTraceBuffer *) RZTraceInstalledBuffer = NULL;
+static _Atomic long RZTraceCounters[RZNotificationTraceCounterCount];
+
+const char *RZNotificationTraceEventName(RZNotificationTraceEvent event)
+{
+    return (event >= 0 && event < RZNotificationTraceEventCount) ? RZTraceEventNames[event] : "Unknown";
+}
+
+const char *RZNotificationTraceCounterName(RZNotificationTraceCounter counter)
+{
+    return (counter >= 0 && counter < RZNotificationTraceCounterCount) ? RZTraceCounterNames[counter] : "Unknown";
+}
+
+static uint64_t bitsOfDouble(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double doubleOfBits(uint64_t bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// MARK: - Buffer
+
+RZNotificationTraceBuffer *RZNotificationTraceBufferCreate(size_t capacity, const RZNotificationClock *clock)
+{
+    size_t slotCount = 16;
+    while (slotCount < capacity) {
+        slotCount <<= 1;
+    }
+
+    RZNotificationTraceBuffer *buffer = calloc(1, sizeof(RZNotificationTraceBuffer));
+    if (buffer == NULL) {
+        return NULL;
+    }
+    buffer->slots = calloc(slotCount, sizeof(RZTraceSlot));
+    if (buffer->slots == NULL) {
+        free(buffer);
+        return NULL;
+    }
+    for (size_t i = 0; i < slotCount; i++) {
+        atomic_init(&buffer->slots[i].sequence, 0);
+    }
+    buffer->mask = slotCount - 1;
+    buffer->clock = (clock != NULL && clock->now != NULL) ? *clock : RZNotificationSystemClock();
+    atomic_init(&buffer->head, 0);
+    atomic_init(&buffer->start, 0);
+    return buffer;
+}
+
+void RZNotificationTraceBufferDestroy(RZNotificationTraceBuffer *buffer)
+{
+    if (buffer == NULL) {
+        return;
+    }
+    free(buffer->slots);
+    free(buffer);
+}
+
+double RZNotificationTraceBufferNow(const RZNotificationTraceBuffer *buffer)
+{
+    return RZNotificationClockNow(&buffer->clock);
+}
+
+void RZNotificationTraceBufferRecord(RZNotificationTraceBuffer *buffer, const RZNotificationTraceRecord *record)
+{
+    uint64_t index = atomic_fetch_add_explicit(&buffer->head, 1, memory_order_relaxed);
+    RZTraceSlot *slot = &buffer->slots[index & buffer->mask];
+
+    atomic_store_explicit(&slot->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->kind, (uint64_t)record->phase << 32 | (uint32_t)record->event, memory_order_relaxed);
+    atomic_store_explicit(&slot->timestamp, bitsOfDouble(record->timestamp), memory_order_relaxed);
+    atomic_store_explicit(&slot->duration, bitsOfDouble(record->duration), memory_order_relaxed);
+    atomic_store_explicit(&slot->notification, record->notification, memory_order_relaxed);
+    atomic_store_explicit(&slot->value, (uint64_t)record->value, memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence, index + 1, memory_order_release);
+}
+
+void RZNotificationTraceBufferClear(RZNotificationTraceBuffer *buffer)
+{
+    atomic_store_explicit(&buffer->start, atomic_load_explicit(&buffer->head, memory_order_acquire), memory_order_release);
+}
+
+size_t RZNotificationTraceBufferCopy(const RZNotificationTraceBuffer *buffer, RZNotificationTraceRecord *records, size_t capacity)
+{
+    RZNotificationTraceBuffer *mutableBuffer = (RZNotificationTraceBuffer *)buffer;
+    uint64_t head = atomic_load_explicit(&mutableBuffer->head, memory_order_acquire);
+    uint64_t first = atomic_load_explicit(&mutableBuffer->start, memory_order_acquire);
+    uint64_t slotCount = buffer->mask + 1;
+    if (head - first > slotCount) {
+        first = head - slotCount;
+    }
+
+    size_t count = 0;
+    for (uint64_t index = first; index < head && count < capacity; index++) {
+        RZTraceSlot *slot = &buffer->slots[index & buffer->mask];
+        if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != index + 1) {
+            continue; // Being written, or already overwritten
+        }
+
+        uint64_t kind = atomic_load_explicit(&slot->kind, memory_order_relaxed);
+        RZNotificationTraceRecord *record = &records[count];
+        record->phase = (RZNotificationTracePhase)(kind >> 32);
+        record->event = (int)(uint32_t)kind;
+        record->timestamp = doubleOfBits(atomic_load_explicit(&slot->timestamp, memory_order_relaxed));
+        record->duration = doubleOfBits(atomic_load_explicit(&slot->duration, memory_order_relaxed));
+        record->notification = atomic_load_explicit(&slot->notification, memory_order_relaxed);
+        record->value = (long)atomic_load_explicit(&slot->value, memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) == index + 1) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int RZNotificationTraceBufferWriteChromeJSON(const RZNotificationTraceBuffer *buffer, FILE *file)
+{
+    size_t capacity = (size_t)buffer->mask + 1;
+    RZNotificationTraceRecord *records = malloc(capacity * sizeof(RZNotificationTraceRecord));
+    if (records == NULL) {
+        return 0;
+    }
+    size_t count = RZNotificationTraceBufferCopy(buffer, records, capacity);
+
+    // Timestamps and durations are in microseconds
+    fprintf(file, "{\"traceEvents\":[");
+    for (size_t i = 0; i < count; i++) {
+        const RZNotificationTraceRecord *record = &records[i];
+        double ts = record->timestamp * 1e6;
+        fprintf(file, "%s\n", i == 0 ? "" : ",");
+        switch (record->phase) {
+            case RZNotificationTracePhaseInstant:
+                fprintf(file, "{\"name\":\"%s\",\"cat\":\"lifecycle\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":1,"
+                        "\"args\":{\"notification\":\"0x%" PRIx64 "\"}}",
+                        RZNotificationTraceEventName((RZNotificationTraceEvent)record->event), ts, record->notification);
+                break;
+            case RZNotificationTracePhaseInterval:
+                fprintf(file, "{\"name\":\"%s\",\"cat\":\"render\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1,"
+                        "\"args\":{\"notification\":\"0x%" PRIx64 "\"}}",
+                        RZNotificationTraceEventName((RZNotificationTraceEvent)record->event), ts, record->duration * 1e6, record->notification);
+                break;
+            case RZNotificationTracePhaseCounter: {
+                const char *name = RZNotificationTraceCounterName((RZNotificationTraceCounter)record->event);
+                fprintf(file, "{\"name\":\"%s\",\"cat\":\"counter\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"%s\":%ld}}",
+                        name, ts, name, record->value);
+                break;
+            }
+        }
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    free(records);
+    return ferror(file) == 0;
+}
+
+// MARK: - Recording
+
+RZNotificationTraceBuffer *RZNotificationTraceInstallBuffer(RZNotificationTraceBuffer *buffer)
+{
+    return atomic_exchange_explicit(&RZTraceInstalledBuffer, buffer, memory_order_acq_rel);
+}
+
+RZNotificationTraceBuffer *RZNotificationTraceInstalledBuffer(void)
+{
+    return atomic_load_explicit(&RZTraceInstalledBuffer, memory_order_acquire);
+}
+
+void RZNotificationTraceInstant(RZNotificationTraceEvent event, uint64_t notification)
+{
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceInstalledBuffer();
+    if (buffer == NULL) {
+        return;
+    }
+    RZNotificationTraceRecord record = { RZNotificationTracePhaseInstant, event, RZNotificationTraceBufferNow(buffer), 0.0, notification, 0 };
+    RZNotificationTraceBufferRecord(buffer, &record);
+}
+
+double RZNotificationTraceBegin(void)
+{
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceInstalledBuffer();
+    return buffer != NULL ? RZNotificationTraceBufferNow(buffer) : -1.0;
+}
+
+void RZNotificationTraceEnd(RZNotificationTraceEvent event, uint64_t notification, double begin)
+{
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceInstalledBuffer();
+    if (buffer == NULL || begin < 0.0) {
+        return;
+    }
+    double duration = RZNotificationTraceBufferNow(buffer) - begin;
+    RZNotificationTraceRecord record = { RZNotificationTracePhaseInterval, event, begin, duration > 0.0 ? duration : 0.0, notification, 0 };
+    RZNotificationTraceBufferRecord(buffer, &record);
+}
+
+long RZNotificationTraceCounterAdd(RZNotificationTraceCounter counter, long delta)
+{
+    long value = atomic_fetch_add_explicit(&RZTraceCounters[counter], delta, memory_order_relaxed) + delta;
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceInstalledBuffer();
+    if (buffer != NULL) {
+        RZNotificationTraceRecord record = { RZNotificationTracePhaseCounter, counter, RZNotificationTraceBufferNow(buffer), 0.0, 0, value };
+        RZNotificationTraceBufferRecord(buffer, &record);
+    }
+    return value;
+}
+
+long RZNotificationTraceCounterValue(RZNotificationTraceCounter counter)
+{
+    return atomic_load_explicit(&RZTraceCounters[counter], memory_order_relaxed);
+}
+
+void RZNotificationTraceResetCounters(void)
+{
+    for (int counter = 0; counter < RZNotificationTraceCounterCount; counter++) {
+        if (counter != RZNotificationTraceCounterLiveViews) {
+            atomic_store_explicit(&RZTraceCounters[counter], 0, memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,146 @@
+//
+//  RZNotificationTrace.h
+//  RZNotificationView
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationView_RZNotificationTrace_h
+#define RZNotificationView_RZNotificationTrace_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "RZNotificationClock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Opt-in instrumentation of the notification lifecycle.
+ *
+ * Events go to a fixed size lock-free ring buffer, any thread can record. When the ring is
+ * full the oldest events are overwritten. No buffer is installed by default: recording is
+ * then a single atomic load. Counters are always maintained, they are a single atomic add.
+ */
+
+typedef enum {
+    // Lifecycle instants, one per notification
+    RZNotificationTraceEventCreated = 0,
+    RZNotificationTraceEventMeasured,
+    RZNotificationTraceEventAddedToHierarchy,
+    RZNotificationTraceEventShowAnimationStarted,
+    RZNotificationTraceEventShowAnimationEnded,
+    RZNotificationTraceEventHideRequested,
+    RZNotificationTraceEventHideAnimationStarted,
+    RZNotificationTraceEventHideAnimationEnded,
+    RZNotificationTraceEventRemoved,
+    // Intervals
+    RZNotificationTraceEventDraw,
+    RZNotificationTraceEventIconRender,
+    RZNotificationTraceEventTextMeasurement,
+    RZNotificationTraceEventCount
+} RZNotificationTraceEvent;
+
+typedef enum {
+    RZNotificationTraceCounterDraws = 0,
+    RZNotificationTraceCounterIconRenders,
+    RZNotificationTraceCounterTextMeasurements,
+    RZNotificationTraceCounterLiveViews,
+    RZNotificationTraceCounterCount
+} RZNotificationTraceCounter;
+
+typedef enum {
+    RZNotificationTracePhaseInstant = 0,
+    RZNotificationTracePhaseInterval,
+    RZNotificationTracePhaseCounter
+} RZNotificationTracePhase;
+
+typedef struct {
+    RZNotificationTracePhase phase;
+    int event;                  // RZNotificationTraceEvent, RZNotificationTraceCounter for counters
+    double timestamp;           // Seconds on the buffer clock, start of intervals
+    double duration;            // Intervals only
+    uint64_t notification;      // 0 when not tied to a notification
+    long value;                 // Counters only
+} RZNotificationTraceRecord;
+
+const char *RZNotificationTraceEventName(RZNotificationTraceEvent event);
+const char *RZNotificationTraceCounterName(RZNotificationTraceCounter counter);
+
+// MARK: - Buffer
+
+typedef struct RZNotificationTraceBuffer RZNotificationTraceBuffer;
+
+/*
+ * capacity is rounded up to a power of two. clock can be NULL for the system clock
+ */
+RZNotificationTraceBuffer *RZNotificationTraceBufferCreate(size_t capacity, const RZNotificationClock *clock);
+
+/*
+ * The buffer must not be installed, nor used by another thread
+ */
+void RZNotificationTraceBufferDestroy(RZNotificationTraceBuffer *buffer);
+
+double RZNotificationTraceBufferNow(const RZNotificationTraceBuffer *buffer);
+
+/*
+ * Lock-free, safe from any thread. A writer preempted for a whole lap of the ring
+ * can leave one corrupted event, size the ring above the expected bursts
+ */
+void RZNotificationTraceBufferRecord(RZNotificationTraceBuffer *buffer, const RZNotificationTraceRecord *record);
+
+/*
+ * Forget the recorded events
+ */
+void RZNotificationTraceBufferClear(RZNotificationTraceBuffer *buffer);
+
+/*
+ * Copy up to capacity events, oldest first. Events being written are skipped.
+ * Returns the number of events copied
+ */
+size_t RZNotificationTraceBufferCopy(const RZNotificationTraceBuffer *buffer, RZNotificationTraceRecord *records, size_t capacity);
+
+/*
+ * Write the events in the Chrome trace event format, to load in chrome://tracing or Perfetto.
+ * Returns 0 on failure
+ */
+int RZNotificationTraceBufferWriteChromeJSON(const RZNotificationTraceBuffer *buffer, FILE *file);
+
+// MARK: - Recording
+
+/*
+ * Install the buffer every event goes to, NULL stops recording. Returns the previous buffer,
+ * which can only be destroyed once no thread records into it anymore
+ */
+RZNotificationTraceBuffer *RZNotificationTraceInstallBuffer(RZNotificationTraceBuffer *buffer);
+RZNotificationTraceBuffer *RZNotificationTraceInstalledBuffer(void);
+
+void RZNotificationTraceInstant(RZNotificationTraceEvent event, uint64_t notification);
+
+/*
+ * Start time to give to RZNotificationTraceEnd, negative when nothing is recording
+ */
+double RZNotificationTraceBegin(void);
+void RZNotificationTraceEnd(RZNotificationTraceEvent event, uint64_t notification, double begin);
+
+/*
+ * Update a counter, also recorded as an event when a buffer is installed.
+ * Returns the new value
+ */
+long RZNotificationTraceCounterAdd(RZNotificationTraceCounter counter, long delta);
+long RZNotificationTraceCounterValue(RZNotificationTraceCounter counter);
+
+/*
+ * Reset the draws, renders and measurements counters. Live views are left untouched
+ */
+void RZNotificationTraceResetCounters(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
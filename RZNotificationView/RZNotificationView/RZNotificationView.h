@@ -109,9 +109,87 @@ typedef NS_ENUM(NSUInteger, RZNotificationContext) {
     RZNotificationContextAboveStatusBar
 };
 
+/**
+ @enum RZNotificationBackgroundRendering
+ How the notification background is rendered
+ */
+typedef NS_ENUM(NSUInteger, RZNotificationBackgroundRendering) {
+    /** Background is drawn in drawRect: */
+    RZNotificationBackgroundRenderingDrawRect = 0,
+    /** Background is a gradient layer, no backing store is allocated for the view */
+    RZNotificationBackgroundRenderingLayer
+};
+
+/**
+ @enum RZNotificationLayoutMode
+ How the notifications visible at the same edge of a container are laid out
+ */
+typedef NS_ENUM(NSUInteger, RZNotificationLayoutMode) {
+    /** Every notification is placed against the edge, the last one covers the others */
+    RZNotificationLayoutModeOverlap = 0,
+    /** The last notification is placed against the edge, the previous ones are stacked after it */
+    RZNotificationLayoutModeStack
+};
+
+/**
+ @enum RZNotificationAnimationMode
+ How notifications slide in and out
+ */
+typedef NS_ENUM(NSUInteger, RZNotificationAnimationMode) {
+    /** The frame is animated */
+    RZNotificationAnimationModeFrame = 0,
+    /** The frame stays at its final position and the layer transform is animated, the layer is rasterized while sliding */
+    RZNotificationAnimationModeTransform
+};
+
+/**
+ @enum RZNotificationLifecycleEvent
+ The steps of a notification life reported to the metrics observer
+ */
+typedef NS_ENUM(NSUInteger, RZNotificationLifecycleEvent) {
+    /** The notification is initialized, or dequeued from the reuse pool */
+    RZNotificationLifecycleEventCreated = 0,
+    /** The notification height is computed for its content */
+    RZNotificationLifecycleEventMeasured,
+    /** The notification is added to its container */
+    RZNotificationLifecycleEventAddedToHierarchy,
+    /** The show animation starts */
+    RZNotificationLifecycleEventShowAnimationStarted,
+    /** The show animation ends */
+    RZNotificationLifecycleEventShowAnimationEnded,
+    /** The notification is asked to hide */
+    RZNotificationLifecycleEventHideRequested,
+    /** The hide animation starts */
+    RZNotificationLifecycleEventHideAnimationStarted,
+    /** The hide animation ends */
+    RZNotificationLifecycleEventHideAnimationEnded,
+    /** The notification is removed from its container */
+    RZNotificationLifecycleEventRemoved
+};
+
+/**
+ @enum RZNotificationCounter
+ The counters maintained by RZNotificationView
+ */
+typedef NS_ENUM(NSUInteger, RZNotificationCounter) {
+    /** Number of drawRect: calls */
+    RZNotificationCounterDraws = 0,
+    /** Number of icons and anchors tinted, cache hits are not counted */
+    RZNotificationCounterIconRenders,
+    /** Number of messages measured, cache hits are not counted */
+    RZNotificationCounterTextMeasurements,
+    /** Number of notifications currently visible */
+    RZNotificationCounterLiveViews
+};
+
 @class RZNotificationView;
+@class RZNotificationDescription;
+@class RZPreparedNotification;
+@class RZNotificationStyle;
 
 typedef void (^RZNotificationCompletion)(BOOL touched);
+typedef void (^RZNotificationBatchCompletion)(NSUInteger count);
+typedef void (^RZNotificationPrepareCompletion)(RZPreparedNotification *prepared);
 
 @protocol RZNotificationViewProtocol
 
@@ -121,6 +199,19 @@ typedef void (^RZNotificationCompletion)(BOOL touched);
 
 @end
 
+@protocol RZNotificationViewMetricsObserver <NSObject>
+
+/**
+ *  Called on the main thread at each step of a notification life
+ *
+ *  @param notification the notification
+ *  @param event the lifecycle step
+ *  @param timestamp the time of the step, in CACurrentMediaTime() base
+ */
+- (void)notificationView:(RZNotificationView*)notification didReachLifecycleEvent:(RZNotificationLifecycleEvent)event atTime:(CFTimeInterval)timestamp;
+
+@end
+
 /** Display a Notification easily
  
  This view allow you to display in app notification with a few lines of code
@@ -270,6 +361,22 @@ typedef void (^RZNotificationCompletion)(BOOL touched);
  */
 + (NSUInteger) hideAllNotificationsForController:(UIViewController*)controller;
 
+/**
+ Hide all notifications view for a specific controller in a single animation
+ @param controller The controller expected to display a notification
+ @param completion Called once every notification is off screen, with the number of notifications hidden. Can be nil
+ @return number of notifications hidden
+ */
++ (NSUInteger) hideAllNotificationsForController:(UIViewController*)controller completion:(RZNotificationBatchCompletion)completion;
+
+/**
+ Hide several notifications in a single animation.
+ Notifications still waiting in the queue are cancelled, notifications already hiding are skipped
+ @param notifications The notifications to hide
+ @param completion Called once every notification is off screen, with the number of notifications hidden. Can be nil
+ */
++ (void) hideNotifications:(NSArray*)notifications completion:(RZNotificationBatchCompletion)completion;
+
 /**---------------------------------------------------------------------------------------
  * @name Init methods
  *  ---------------------------------------------------------------------------------------
@@ -313,13 +420,117 @@ typedef void (^RZNotificationCompletion)(BOOL touched);
  */
 - (id) initWithContext:(RZNotificationContext)context icon:(RZNotificationIcon)icon anchor:(RZNotificationAnchor)anchor position:(RZNotificationPosition)position color:(RZNotificationColor)color assetColor:(RZNotificationContentColor)assetColor textColor:(RZNotificationContentColor)textColor duration:(NSTimeInterval)delay completion:(RZNotificationCompletion)completionBlock;
 
+/**---------------------------------------------------------------------------------------
+ * @name Prepared notifications
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ Measure the message, render the icon and the anchor and load the sound on a background queue.
+ Showing the prepared notification then finds all of them in the shared caches, and only
+ inserts the view and starts its animation on the main thread.
+ Must be called on the main thread, the container and its width are resolved immediately
+ @param description The notification to prepare, copied
+ @param completion Called on the main thread with the prepared notification
+ */
++ (void) prepareNotification:(RZNotificationDescription*)description completion:(RZNotificationPrepareCompletion)completion;
+
+/**
+ Show a notification prepared by `prepareNotification:completion:`
+ @param prepared The prepared notification
+ @param completionBlock The completionBlock to execute
+ @return the notification, or the notification it was merged into
+ */
++ (RZNotificationView*) showPreparedNotification:(RZPreparedNotification*)prepared withCompletion:(RZNotificationCompletion)completionBlock;
+
+/**
+ Show a notification from any thread.
+ The request goes to a lock-free queue that the main thread drains once per frame, a burst of
+ requests costs a single main queue block. When the queue is full the request is sent to
+ the main queue on its own, and can then be shown before requests submitted earlier
+ @param description The notification to show, copied
+ @param completionBlock The completionBlock to execute, on the main thread
+ */
++ (void) submitNotification:(RZNotificationDescription*)description withCompletion:(RZNotificationCompletion)completionBlock;
+
+/**---------------------------------------------------------------------------------------
+ * @name In place updates
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ Show a notification, or update the one shown with the same identifier while it is visible or waiting to be shown.
+ An update changes the message, maximum length, icon, anchor, colors, duration and priority in place:
+ only the changed parts are rendered again, the text is measured again, the height change is animated
+ and the hide delay starts over. A waiting notification is queued again at its new priority.
+ The sound and the vibration are taken too, but played at most once, when shown.
+ An update ignores the context and the position: the notification stays where it is.
+ Notifications with an identifier are never merged by `registerCoalescing:`
+ @param description The notification to show, or its new content
+ @param identifier The identifier, for example @"messages"
+ @param completionBlock The completionBlock to execute, replaces the one of an updated notification when not nil
+ @return the notification shown or updated
+ */
++ (RZNotificationView*) showOrUpdateNotification:(RZNotificationDescription*)description identifier:(NSString*)identifier withCompletion:(RZNotificationCompletion)completionBlock;
+
+/**
+ @param identifier The identifier given to `showOrUpdateNotification:identifier:withCompletion:`
+ @return the notification visible or waiting to be shown with this identifier, nil if there is none
+ */
++ (RZNotificationView*) notificationWithIdentifier:(NSString*)identifier;
+
+/**---------------------------------------------------------------------------------------
+ * @name Styles
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ Register a style preset. The style is copied and resolved once: its palette colors and its
+ tinted icon and anchor are computed here, notifications using it do not compute them again.
+ Registering another style for the same identifier replaces it, notifications already styled
+ keep the previous one. Main thread only
+ @param style The style, copied
+ @param identifier The identifier given to `applyStyleWithIdentifier:`
+ */
++ (void) registerStyle:(RZNotificationStyle*)style forIdentifier:(NSString*)identifier;
+
+/**
+ @param identifier The identifier of a registered style
+ @return a copy of the registered style, nil if there is none
+ */
++ (RZNotificationStyle*) styleForIdentifier:(NSString*)identifier;
+
+/**
+ Show a notification with a registered style
+ @param context The context where the notification will be displayed
+ @param message The message to display
+ @param identifier The identifier of a registered style
+ @param completionBlock The completionBlock to execute
+ @return the notification, or the notification it was merged into
+ */
++ (RZNotificationView*) showNotificationOn:(RZNotificationContext)context message:(NSString*)message style:(NSString*)identifier withCompletion:(RZNotificationCompletion)completionBlock;
+
+/**
+ Apply every property of a registered style, in a single batch update
+ @param identifier The identifier of a registered style
+ */
+- (void) applyStyleWithIdentifier:(NSString*)identifier;
+
+/**
+ Change several properties at once: the message is measured, and the notification resized,
+ only once at the end of the outermost batch. Batches can be nested
+ @param updates The property changes
+ */
+- (void) performBatchUpdates:(void (^)(void))updates;
+
 /**---------------------------------------------------------------------------------------
  * @name Other methods
  *  ---------------------------------------------------------------------------------------
  */
 
 /**
- Allow to show the notification
+ Allow to show the notification.
+ The notification may wait in the container queue, see `registerMaxVisibleNotifications:`
  */
 - (void) show;
 
@@ -329,7 +540,8 @@ typedef void (^RZNotificationCompletion)(BOOL touched);
 - (void) hide;
 
 /**
- Allow to hide the notification after a delay
+ Allow to hide the notification after a delay.
+ The countdown stops while the notification is touched and while the app is in background
  @param delay delay in seconds
  */
 - (void) hideAfterDelay:(NSTimeInterval)delay;
@@ -373,6 +585,265 @@ typedef void (^RZNotificationCompletion)(BOOL touched);
  */
 + (void) registerDefaultOffsetOnX:(CGFloat)defaultXOffset;
 
+/**
+ *  Register the background rendering for new notifications. Default is RZNotificationBackgroundRenderingDrawRect
+ *
+ *  @param backgroundRendering the background rendering
+ */
++ (void) registerBackgroundRendering:(RZNotificationBackgroundRendering)backgroundRendering;
+
+/**---------------------------------------------------------------------------------------
+ * @name Scheduling
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ *  Register how many notifications can be visible at once in a container.
+ *  Extra notifications wait in a queue ordered by priority, then submission order.
+ *  Default is 0, no limit
+ *
+ *  @param maxVisible the maximum number of visible notifications per container
+ */
++ (void) registerMaxVisibleNotifications:(NSUInteger)maxVisible;
+
+/**
+ *  Register a token bucket rate limit applied to each container.
+ *  Default is 0, no rate limit
+ *
+ *  @param notificationsPerSecond the sustained rate, 0 disables the limit
+ *  @param burst how many notifications can be shown back to back
+ */
++ (void) registerRateLimit:(double)notificationsPerSecond burst:(NSUInteger)burst;
+
+/**
+ *  Register whether identical notifications (same message, icon and color) in a container are merged.
+ *  The merged notification repeatCount is incremented and, when visible, its hide delay restarts.
+ *  The completion of a merged notification is kept, it is called when the merged notification hides.
+ *  repeatCount is data only, it is not drawn: include it in the message to show it.
+ *  Only the class methods showing a notification merge it, they return the merged notification.
+ *  `-show` always shows the notification it is called on.
+ *  Default is NO
+ *
+ *  @param coalesce YES to merge identical notifications
+ */
++ (void) registerCoalescing:(BOOL)coalesce;
+
+/**---------------------------------------------------------------------------------------
+ * @name Stacking
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ *  Register how notifications of the same container and position are laid out.
+ *  Applies to the notifications shown afterwards. Notifications shown in a window
+ *  (RZNotificationContextBelowStatusBar and RZNotificationContextAboveStatusBar) get one window
+ *  per context and position, sized to the notifications it shows.
+ *  Default is RZNotificationLayoutModeOverlap
+ *
+ *  @param layoutMode the layout mode
+ */
++ (void) registerLayoutMode:(RZNotificationLayoutMode)layoutMode;
+
+/**
+ *  Register the stack layout parameters. Only the notifications that moved are animated.
+ *  Notifications past maxVisible fade out but stay shown, unlike `registerMaxVisibleNotifications:`
+ *  which keeps them in the queue. Default is an 8 points spacing and no limit
+ *
+ *  @param spacing the space between two stacked notifications
+ *  @param maxVisible the maximum number of visible notifications per stack, 0 for no limit
+ */
++ (void) registerStackSpacing:(CGFloat)spacing maxVisible:(NSUInteger)maxVisible;
+
+/**---------------------------------------------------------------------------------------
+ * @name Animations
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ *  Register how notifications slide in and out. With RZNotificationAnimationModeTransform no
+ *  layout happens during the slide, and the content is composited from a single rasterized
+ *  bitmap. Default is RZNotificationAnimationModeFrame
+ *
+ *  @param animationMode the animation mode
+ */
++ (void) registerAnimationMode:(RZNotificationAnimationMode)animationMode;
+
+/**
+ *  Register the duration and the curve of the show, hide and stack animations.
+ *  Default is 0.4 seconds and UIViewAnimationOptionCurveEaseInOut
+ *
+ *  @param duration the duration in seconds
+ *  @param options the curve, and any other animation option
+ */
++ (void) registerAnimationDuration:(NSTimeInterval)duration options:(UIViewAnimationOptions)options;
+
+/**
+ *  Register a spring for the show, hide and stack animations, see
+ *  `+[UIView animateWithDuration:delay:usingSpringWithDamping:initialSpringVelocity:options:animations:completion:]`.
+ *  Default is no spring
+ *
+ *  @param damping the damping ratio between 0 and 1, 0 for no spring
+ *  @param velocity the initial velocity
+ */
++ (void) registerAnimationSpringDamping:(CGFloat)damping initialVelocity:(CGFloat)velocity;
+
+/**---------------------------------------------------------------------------------------
+ * @name Sounds
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ *  Load sounds on a background queue, so the first notification playing them does not pay for it.
+ *  Typically called at launch
+ *
+ *  @param soundNames the sound file names, as given to `setSound:`
+ */
++ (void) preloadSounds:(NSArray*)soundNames;
+
+/**
+ *  Register the minimum time between two plays of the same sound, or two vibrations.
+ *  A burst of notifications then plays each cue once. Default is 0, no throttling
+ *
+ *  @param interval the throttle interval in seconds
+ */
++ (void) registerSoundThrottleInterval:(NSTimeInterval)interval;
+
+/**---------------------------------------------------------------------------------------
+ * @name Metrics
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ *  Register the observer notified of every lifecycle step. It is not retained.
+ *  Default is nil
+ *
+ *  @param observer the metrics observer, nil to remove it
+ */
++ (void) registerMetricsObserver:(id<RZNotificationViewMetricsObserver>)observer;
+
+/**
+ *  Start or stop recording lifecycle steps, draws, icon renders and text measurements,
+ *  in a ring buffer and as os_signpost intervals (iOS 12+). Recording costs close to nothing when stopped.
+ *  Default is NO
+ *
+ *  @param enabled YES to record
+ *  @param capacity the number of events kept, the oldest are overwritten. Only used by the first start
+ */
++ (void) setTracingEnabled:(BOOL)enabled capacity:(NSUInteger)capacity;
+
+/**
+ *  Write the recorded events as a Chrome trace JSON file, for chrome://tracing or Perfetto.
+ *  Nothing is written before the tracing is started once
+ *
+ *  @param path the file path
+ *
+ *  @return YES if the file was written
+ */
++ (BOOL) writeTraceToPath:(NSString*)path;
+
+/**
+ *  Start or stop recording the shows, hides, touches and rotations handled by the manager,
+ *  with their parameters, to replay them without UIKit (see RZNotificationReplay.h).
+ *  Default is NO
+ *
+ *  @param enabled YES to record
+ */
++ (void) setEventRecordingEnabled:(BOOL)enabled;
+
+/**
+ *  Write the recorded shows, hides, touches and rotations as a binary event log
+ *
+ *  @param path the file path
+ *
+ *  @return YES if the file was written
+ */
++ (BOOL) writeEventLogToPath:(NSString*)path;
+
+/**
+ *  Forget the recorded events and reset the counters, except live views
+ */
++ (void) resetMetrics;
+
+/**
+ *  Current value of a counter. Counters are maintained even when tracing is stopped
+ *
+ *  @param counter the counter
+ *
+ *  @return the counter value
+ */
++ (NSInteger) valueForCounter:(RZNotificationCounter)counter;
+
+/**---------------------------------------------------------------------------------------
+ * @name Reuse
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ *  Register how many hidden notifications are kept for reuse by the `show...` class methods.
+ *  Default is 0, reuse disabled.
+ *  When enabled, a notification returned by a `show...` class method must not be used once hidden:
+ *  it goes back to the pool and may already be showing another message, so a caller keeping
+ *  the pointer would change someone else's notification. Do not keep it past its completion block.
+ *
+ *  @param poolSize the maximum number of notifications kept in the pool
+ */
++ (void) registerReusePoolSize:(NSUInteger)poolSize;
+
+/**
+ *  @return number of RZNotificationView allocated so far
+ */
++ (NSUInteger) numberOfAllocatedNotifications;
+
+/**
+ *  @return number of notifications shown from the reuse pool instead of being allocated
+ */
++ (NSUInteger) numberOfReusedNotifications;
+
+/**
+ *  @return number of notifications currently waiting in the reuse pool
+ */
++ (NSUInteger) numberOfReusableNotifications;
+
+/**
+ Called before a hidden notification goes back to the reuse pool.
+ - cancels the pending hide
+ - releases the completion block and the custom view
+ - clears message, custom colors, custom icon and label font
+ - disposes the sound and resets vibration
+ - removes the highlight overlay
+ - forgets the container and the context
+ Icon, anchor, position, colors and duration are set again by the `show...` method reusing the view.
+ Subclasses overriding this method must call super
+ */
+- (void) prepareForReuse;
+
+/**---------------------------------------------------------------------------------------
+ * @name Memory
+ *  ---------------------------------------------------------------------------------------
+ */
+
+/**
+ *  Register the estimated memory the visible notifications may use, in bytes.
+ *  A notification is estimated from its bounds and the screen scale for its backing store,
+ *  its text label and highlight overlay, plus its icon and anchor bitmaps.
+ *  When a new notification goes over the budget, the lowest priority then oldest visible ones are hidden early.
+ *  On memory warnings, the reuse pool and the unused highlight overlays are released too.
+ *  Default is 0, no budget
+ *
+ *  @param bytes the memory budget
+ */
++ (void) registerMemoryBudget:(NSUInteger)bytes;
+
+/**
+ *  @return the estimated memory of the visible notifications, in bytes
+ */
++ (NSUInteger) estimatedMemoryUsage;
+
+/**
+ *  @return number of notifications hidden early to fit the memory budget
+ */
++ (NSUInteger) numberOfMemoryEvictions;
+
 /**---------------------------------------------------------------------------------------
  * @name Properties
  *  ---------------------------------------------------------------------------------------
@@ -408,6 +879,17 @@ typedef void (^RZNotificationCompletion)(BOOL touched);
  */
 @property (nonatomic) RZNotificationPosition position;
 
+/**
+ Priority used when notifications are queued, higher is shown first. Default is 0
+ */
+@property (nonatomic) NSInteger priority;
+
+/**
+ Number of identical notifications merged into this one, see `registerCoalescing:`.
+ Not drawn by the notification
+ */
+@property (nonatomic, readonly) NSUInteger repeatCount;
+
 /**
  Background color of notification view if customTopColor and customBottomColor are not used
  */
@@ -423,6 +905,12 @@ typedef void (^RZNotificationCompletion)(BOOL touched);
  */
 @property (nonatomic, strong) UIColor *customBottomColor;
 
+/**
+ How the background is rendered.
+ With RZNotificationBackgroundRenderingLayer, color and size changes only update a CAGradientLayer and never re-rasterize the view
+ */
+@property (nonatomic) RZNotificationBackgroundRendering backgroundRendering;
+
 /**
  Sound file name
  */
@@ -496,4 +984,102 @@ typedef void (^RZNotificationCompletion)(BOOL touched);
 
 @end
 
+/**
+ What a notification shows, without any view. Given to `+[RZNotificationView prepareNotification:completion:]`.
+ Defaults are the ones of `showNotificationOn:message:...`
+ */
+@interface RZNotificationDescription : NSObject <NSCopying>
+
++ (instancetype) descriptionWithMessage:(NSString*)message context:(RZNotificationContext)context;
+
+@property (nonatomic, copy) NSString *message;
+@property (nonatomic) RZNotificationContext context;
+@property (nonatomic) RZNotificationIcon icon;
+@property (nonatomic, copy) NSString *customIcon;
+@property (nonatomic) RZNotificationAnchor anchor;
+@property (nonatomic) RZNotificationPosition position;
+@property (nonatomic) RZNotificationColor color;
+@property (nonatomic) RZNotificationContentColor assetColor;
+@property (nonatomic) RZNotificationContentColor textColor;
+@property (nonatomic) NSTimeInterval duration;
+@property (nonatomic) NSInteger priority;
+
+/**
+ Sound file name, loaded while preparing
+ */
+@property (nonatomic, copy) NSString *sound;
+@property (nonatomic) BOOL vibrate;
+
+/**
+ 0 for the default max length
+ */
+@property (nonatomic) NSInteger messageMaxLenght;
+
+@end
+
+/**
+ A notification whose expensive work is done, see `+[RZNotificationView prepareNotification:completion:]`.
+ Custom views are not prepared, they can only be measured on the main thread
+ */
+@interface RZPreparedNotification : NSObject
+
+@property (nonatomic, readonly, copy) RZNotificationDescription *notificationDescription;
+
+/**
+ Height of the message, for the screen width when it was prepared
+ */
+@property (nonatomic, readonly) CGFloat messageHeight;
+
+@property (nonatomic, readonly, strong) UIImage *iconImage;
+@property (nonatomic, readonly, strong) UIImage *anchorImage;
+
+@end
+
+/**
+ A style preset, see `+[RZNotificationView registerStyle:forIdentifier:]`.
+ Defaults are the ones of `showNotificationOn:message:...`
+ */
+@interface RZNotificationStyle : NSObject <NSCopying>
+
+@property (nonatomic) RZNotificationColor color;
+
+/**
+ Override color, like `-[RZNotificationView customTopColor]`
+ */
+@property (nonatomic, strong) UIColor *customTopColor;
+@property (nonatomic, strong) UIColor *customBottomColor;
+
+@property (nonatomic) RZNotificationContentColor assetColor;
+@property (nonatomic) RZNotificationContentColor textColor;
+
+/**
+ nil for the default font
+ */
+@property (nonatomic, strong) UIFont *labelFont;
+
+@property (nonatomic) RZNotificationIcon icon;
+@property (nonatomic, copy) NSString *customIcon;
+@property (nonatomic) RZNotificationAnchor anchor;
+@property (nonatomic) RZNotificationPosition position;
+
+/**
+ Margin on top and bottom of the text, negative for the registered one (the default)
+ */
+@property (nonatomic) CGFloat contentMarginHeight;
+
+@property (nonatomic) NSTimeInterval duration;
+
+/**
+ Sound file name, loaded when the style is registered
+ */
+@property (nonatomic, copy) NSString *sound;
+@property (nonatomic) BOOL vibrate;
+
+/**
+ 0 for the default max length
+ */
+@property (nonatomic) NSInteger messageMaxLenght;
+
+@end
+
 #define RZSystemVersionGreaterOrEqualThan(version) ([[[UIDevice currentDevice] systemVersion] floatValue] >= version)
@@ -9,25 +9,32 @@
 #import "RZNotificationView.h"
 
 @import AudioToolbox.AudioServices;
-@import ObjectiveC.runtime;
+@import QuartzCore;
+@import os.signpost;
 
 #import "UIColor+RZAdditions.h"
+#import "RZNotificationImageCache.h"
+#import "RZNotificationLayout.h"
+#import "RZNotificationTextMeasurementCache.h"
+#import "RZNotificationSoundRegistry.h"
+#import "RZNotificationScheduler.h"
+#import "RZNotificationHashMap.h"
+#import "RZNotificationTimerWheel.h"
+#import "RZNotificationRegistry.h"
+#import "RZNotificationTrace.h"
+#import "RZNotificationEventLog.h"
+#import "RZNotificationStack.h"
+#import "RZNotificationRequestQueue.h"
+#import "RZNotificationMemoryBudget.h"
 
 #import <MOOMaskedIconView/MOOMaskedIconView.h>
 #import <MOOMaskedIconView/MOOStyleTrait.h>
 
 #import <PPHelpMe/PPHelpMe.h>
 
-#define RZUIColorFromRGB(rgbValue) [UIColor               \
-colorWithRed:((CGFloat)((rgbValue & 0xFF0000) >> 16))/255.0f \
-green:((CGFloat)((rgbValue & 0xFF00) >> 8))/255.0f           \
-blue:((CGFloat)(rgbValue & 0xFF))/255.0f                     \
-alpha:1.0f]
-
 #pragma mark -
 
 @protocol RZNotificationViewManagerProtocol <NSObject>
-@property (nonatomic, strong) NSMutableArray *rzNotifications;
 @end
 
 /**
@@ -39,16 +46,72 @@ alpha:1.0f]
 @interface UIWindow (RZNotificationViewManager) <RZNotificationViewManagerProtocol>
 @end
 
+/**
+ *  One window per context and position, only as large as the notifications it shows
+ */
+@interface RZNotificationWindow : UIWindow
+@property (nonatomic, readonly) RZNotificationContext context;
+@property (nonatomic, readonly) RZNotificationPosition position;
+- (id) initWithContext:(RZNotificationContext)context position:(RZNotificationPosition)position;
+- (UIWindow *) screenWindow;
+@end
+
 #pragma mark -
 
 @interface RZNotificationViewManager : NSObject
 
-+ (UIWindow *) notificationWindow;
++ (RZNotificationWindow *) notificationWindowForContext:(RZNotificationContext)context position:(RZNotificationPosition)position;
++ (void) fitNotificationWindow:(RZNotificationWindow*)window including:(RZNotificationView*)notification;
++ (void) fitWindowOfNotification:(RZNotificationView*)notification;
 
 + (void) registerNotification:(RZNotificationView*)notification;
 + (void) removeNotification:(RZNotificationView*)notification;
++ (NSUInteger) removeNotifications:(NSArray*)notifications;
 + (RZNotificationView *) notificationForContainer:(id<RZNotificationViewManagerProtocol>)container;
 +(NSArray *) allNotificationsForContainer:(id<RZNotificationViewManagerProtocol>)container;
+
++ (RZNotificationView *) scheduleNotification:(RZNotificationView*)notification;
++ (RZNotificationView *) scheduleNotification:(RZNotificationView*)notification coalesce:(BOOL)coalesce;
++ (BOOL) cancelScheduledNotification:(RZNotificationView*)notification;
++ (void) updatePriorityOfNotification:(RZNotificationView*)notification;
++ (void) notificationDidHide:(RZNotificationView*)notification;
++ (NSArray *) pendingNotificationsForContainer:(id<RZNotificationViewManagerProtocol>)container;
++ (void) updateSchedulerConfiguration;
+
++ (void) stackNotification:(RZNotificationView*)notification;
++ (void) unstackNotification:(RZNotificationView*)notification;
++ (void) resizeStackedNotification:(RZNotificationView*)notification;
++ (CGFloat) stackOffsetOfNotification:(RZNotificationView*)notification;
++ (BOOL) isStackVisibleNotification:(RZNotificationView*)notification;
++ (void) updateStackConfiguration;
++ (void) setNeedsStackLayout;
++ (void) layoutStacksAnimated:(BOOL)animated;
+
++ (void) observeOrientationChanges;
+
++ (void) scheduleHideOfNotification:(RZNotificationView*)notification afterDelay:(NSTimeInterval)delay;
++ (void) cancelHideOfNotification:(RZNotificationView*)notification;
++ (void) pauseHideOfNotification:(RZNotificationView*)notification;
++ (void) resumeHideOfNotification:(RZNotificationView*)notification;
+
++ (RZNotificationView *) dequeueReusableNotification;
++ (void) enqueueReusableNotification:(RZNotificationView*)notification;
++ (NSUInteger) numberOfReusableNotifications;
+
++ (RZNotificationView *) notificationWithIdentifier:(NSString*)identifier;
++ (void) setNotification:(RZNotificationView*)notification forIdentifier:(NSString*)identifier;
+
++ (void) updateMemoryOfNotification:(RZNotificationView*)notification;
++ (void) updateMemoryBudget;
++ (void) enforceMemoryBudget;
++ (NSUInteger) memoryUsage;
+
++ (RZNotificationTraceBuffer *) traceBufferWithCapacity:(NSUInteger)capacity;
++ (RZNotificationTraceBuffer *) traceBuffer;
++ (RZNotificationEventLog *) eventLog;
++ (void) recordEvent:(RZNotificationEvent *)event;
+
++ (void) submitNotification:(RZNotificationDescription*)description completion:(RZNotificationCompletion)completionBlock;
 @end
 
 static const NSInteger kDefaultMaxMessageLength            = 150;
@@ -67,6 +130,44 @@ static CGFloat kMinHeight                                  = 54.0f;
 static CGFloat kDefaultContentMarginHeight                 = 16.0f;
 static CGFloat kDefaultOffsetX                             = 16.0f;
 
+static RZNotificationBackgroundRendering kDefaultBackgroundRendering = RZNotificationBackgroundRenderingDrawRect;
+
+static NSUInteger kMaxVisibleNotifications                = 0;
+static double kRateLimitPerSecond                          = 0.0;
+static NSUInteger kRateLimitBurst                          = 1;
+static BOOL kCoalesceNotifications                         = NO;
+
+static RZNotificationLayoutMode kLayoutMode                = RZNotificationLayoutModeOverlap;
+static CGFloat kStackSpacing                               = 8.0f;
+static NSUInteger kStackMaxVisible                         = 0;
+static BOOL sStackLayoutScheduled                          = NO;
+
+static RZNotificationAnimationMode kAnimationMode          = RZNotificationAnimationModeFrame;
+static NSTimeInterval kAnimationDuration                   = 0.4;
+static UIViewAnimationOptions kAnimationOptions            = UIViewAnimationOptionCurveEaseInOut;
+static CGFloat kAnimationSpringDamping                     = 0.0f;
+static CGFloat kAnimationSpringVelocity                    = 0.0f;
+
+static NSUInteger kReusePoolSize                           = 0;
+static NSUInteger sAllocatedNotifications                  = 0;
+static NSUInteger sReusedNotifications                     = 0;
+
+static NSUInteger kMemoryBudget                            = 0;
+static NSUInteger sMemoryEvictions                         = 0;
+static const NSUInteger kEvictionBatchSize                 = 16;
+
+static __weak id<RZNotificationViewMetricsObserver> sMetricsObserver = nil;
+static const NSUInteger kDefaultTraceCapacity              = 4096;
+static RZNotificationTraceBuffer *sTraceBuffer             = NULL;
+static BOOL sEventRecordingEnabled                         = NO;
+static BOOL sHidingExpiredNotifications                    = NO;
+
+static const NSUInteger kRequestQueueCapacity             = 256;
+static const NSUInteger kMaxRequestsPerFrame               = 32;
+
+static const NSTimeInterval kOrientationDebounceDelay      = 0.15;
+static NSUInteger sOrientationChangeCount                  = 0;
+
 //static CGFloat kOffsetBetweenTextAndImages           = 16.0f; // If you change this value, please consider add it as static
 #define kOffsetBetweenTextAndImages                        kDefaultOffsetX
 
@@ -75,6 +176,131 @@ static const CGFloat kIconHeight                           = 22.0f;
 
 static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask, UIDeviceOrientation orientation);
 
+static inline UIFont *RZDefaultLabelFont(void)
+{
+    return [UIFont fontWithName:@"Avenir" size:15.0];
+}
+
+static NSString *RZTruncatedMessage(NSString *message, NSInteger maxLength)
+{
+    NSUInteger length = [message length];
+    if (maxLength < 0 || (NSUInteger)maxLength >= length)
+        return message;
+    
+    // The unit after the cut tells whether it splits a surrogate pair
+    unichar *units = malloc((maxLength + 1) * sizeof(unichar));
+    [message getCharacters:units range:NSMakeRange(0, maxLength + 1)];
+    size_t kept = RZNotificationLayoutTruncatedLength(units, length, maxLength);
+    free(units);
+    return [[message substringToIndex:kept] stringByAppendingString:@"..."]; // Tail truncation
+}
+
+// RZNotificationContentColorManual is not supported for assets
+static RZNotificationContentColor RZResolvedAssetColor(RZNotificationContentColor assetColor, RZNotificationContentColor textColor)
+{
+    if (assetColor != RZNotificationContentColorManual)
+        return assetColor;
+    return (textColor != RZNotificationContentColorManual) ? textColor : RZNotificationContentColorLight;
+}
+
+static inline CGRect CGRectFromRZNotificationRect(RZNotificationRect rect)
+{
+    return CGRectMake(rect.x, rect.y, rect.width, rect.height);
+}
+
+static inline RZNotificationRect RZNotificationRectFromCGRect(CGRect rect)
+{
+    return RZNotificationRectMake(CGRectGetMinX(rect), CGRectGetMinY(rect), CGRectGetWidth(rect), CGRectGetHeight(rect));
+}
+
+// Key of an object in the C core: registry, scheduler and trace
+static inline uint64_t RZRegistryKey(id object)
+{
+    return (uint64_t)(uintptr_t)(__bridge void *)object;
+}
+
+#pragma mark - Tracing
+
+_Static_assert((int)RZNotificationLifecycleEventRemoved == (int)RZNotificationTraceEventRemoved, "Lifecycle events map to trace events");
+_Static_assert((int)RZNotificationCounterLiveViews == (int)RZNotificationTraceCounterLiveViews, "Counters map to trace counters");
+
+static os_log_t RZSignpostLog(void) API_AVAILABLE(ios(12.0))
+{
+    static dispatch_once_t pred = 0;
+    __strong static os_log_t _log = nil;
+    dispatch_once(&pred, ^{
+        _log = os_log_create("com.rezzza.RZNotificationView", OS_LOG_CATEGORY_POINTS_OF_INTEREST);
+    });
+    return _log;
+}
+
+// Signpost names must be string literals
+static void RZSignpostInterval(BOOL begin, RZNotificationTraceEvent event, id object)
+{
+    if (@available(iOS 12.0, *)) {
+        os_log_t log = RZSignpostLog();
+        os_signpost_id_t signpost = os_signpost_id_make_with_pointer(log, (__bridge const void *)object);
+        switch (event) {
+            case RZNotificationTraceEventDraw:
+                if (begin) os_signpost_interval_begin(log, signpost, "Draw");
+                else os_signpost_interval_end(log, signpost, "Draw");
+                break;
+            case RZNotificationTraceEventIconRender:
+                if (begin) os_signpost_interval_begin(log, signpost, "IconRender");
+                else os_signpost_interval_end(log, signpost, "IconRender");
+                break;
+            case RZNotificationTraceEventTextMeasurement:
+                if (begin) os_signpost_interval_begin(log, signpost, "TextMeasurement");
+                else os_signpost_interval_end(log, signpost, "TextMeasurement");
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Negative when not tracing, RZTraceIntervalEnd is then a no-op
+static double RZTraceIntervalBegin(RZNotificationTraceEvent event, id object)
+{
+    double begin = RZNotificationTraceBegin();
+    if (begin >= 0.0) {
+        RZSignpostInterval(YES, event, object);
+    }
+    return begin;
+}
+
+static void RZTraceIntervalEnd(RZNotificationTraceEvent event, id object, double begin)
+{
+    if (begin < 0.0) {
+        return;
+    }
+    RZSignpostInterval(NO, event, object);
+    RZNotificationTraceEnd(event, RZRegistryKey(object), begin);
+}
+
+typedef NS_ENUM(NSUInteger, RZNotificationHideStep) {
+    RZNotificationHideStepNone,      // Already hiding
+    RZNotificationHideStepCancelled, // Was waiting in the queue, nothing to animate
+    RZNotificationHideStepAnimate    // Visible, the caller animates it out then calls finishHide
+};
+
+/**
+ *  A registered style, with everything that does not depend on the notification computed once
+ */
+@interface RZNotificationResolvedStyle : NSObject
+{
+@public
+    RZNotificationStyle *_style;
+    RZNotificationContentColor _assetColor; // Resolved
+    UIColor *_startColor;
+    UIColor *_strokeColor;
+    UIImage *_iconImage;
+    UIImage *_anchorImage;
+    BOOL _hasImages; // Automatic asset colors depend on the background, they are not pre-rendered
+}
+- (id) initWithStyle:(RZNotificationStyle*)style;
+@end
+
 @interface RZNotificationView ()
 {
     BOOL _isShowing;
@@ -85,10 +311,73 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     
     CGFloat _topOffset; // For below status bar
     CGFloat _safeTopInset, _safeBottomInset;
+    
+    CAGradientLayer *_backgroundLayer;
+    
+    RZNotificationLayoutInput _layoutInput; // Inputs of the frames currently applied
+    BOOL _hasLayout;
+    BOOL _needsAppearanceUpdate;
+    
+    BOOL _reusable; // Created by a show method, can go back to the reuse pool once hidden
+    BOOL _isHiding;
+    
+    uint64_t _scheduledIdentifier; // 0 when not scheduled
+    NSMutableArray *_mergedCompletions; // Of the identical notifications merged into this one
+    uint64_t _hideTimer; // 0 when no hide is pending
+    
+    RZNotificationResolvedStyle *_resolvedStyle; // Last applied style, nil when none
+    CGFloat _styleContentMarginHeight; // Negative for the registered margin
+    
+    NSUInteger _batchUpdateDepth;
+    BOOL _needsMessageMeasurement; // Deferred until the end of the batch
+    BOOL _needsHeightAdjustment;
+    CGFloat _pendingContentHeight;
+    
+    NSUInteger _slideCount; // Running slide animations, the layer is rasterized while not 0
+    
+    BOOL _isUpdatingInPlace; // The height change is animated, the background is only redrawn when resized
 }
 @property (nonatomic, weak) id <RZNotificationViewManagerProtocol> container;
 @property (nonatomic, strong) UIViewController *contextController;
 @property (nonatomic, assign) RZNotificationContext context;
+@property (nonatomic, readwrite) NSUInteger repeatCount;
+@property (nonatomic, assign) uint64_t scheduledIdentifier;
+@property (nonatomic, readonly, getter = isReusable) BOOL reusable;
+@property (nonatomic, assign) uint64_t hideTimer;
+@property (nonatomic, assign) BOOL stackHidden; // Stacked past the max visible, the view is hidden
+@property (nonatomic, copy) NSString *notificationIdentifier; // Given to `showOrUpdateNotification:...`, nil otherwise
+
+- (void) performShow;
+- (uint64_t) coalescingKey;
+- (void) addMergedCompletion:(RZNotificationCompletion)completion;
+
+- (RZNotificationHideStep) beginHide;
+- (void) finishHide;
+
+- (void) recordLifecycleEvent:(RZNotificationLifecycleEvent)event;
+- (void) recordEvent:(RZNotificationEventType)type;
+
+- (void) placeToFinalPosition;
+- (void) relayoutForWidth:(CGFloat)width;
+
+- (BOOL) isLive;
+- (void) updateWithDescription:(RZNotificationDescription*)description;
+- (void) animateHeightChangeToFrame:(CGRect)frame;
+
+- (size_t) estimatedMemoryBytes;
+- (void) releaseUnusedHighlightOverlay;
+
++ (id<RZNotificationViewManagerProtocol>)containerForContext:(RZNotificationContext)context position:(RZNotificationPosition)position;
++ (RZNotificationView*) reusableNotificationWithDescription:(RZNotificationDescription*)description container:(id<RZNotificationViewManagerProtocol>)container completion:(RZNotificationCompletion)completionBlock;
+@end
+
+@interface RZPreparedNotification ()
+{
+@public
+    __weak id<RZNotificationViewManagerProtocol> _container; // Resolved when prepared
+    SystemSoundID _soundID; // Reference taken on the sound registry, 0 without sound
+}
+- (id) initWithDescription:(RZNotificationDescription*)description container:(id<RZNotificationViewManagerProtocol>)container width:(CGFloat)width scale:(CGFloat)scale;
 @end
 
 @implementation RZNotificationView
@@ -97,26 +386,122 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 
 - (CGFloat) getOffsetXLeft
 {
-    CGFloat offsetX = kDefaultOffsetX;
-    if ([self getImageForIcon:_icon]) {
-        offsetX += (kIconWidth + kOffsetBetweenTextAndImages);
+    RZNotificationLayoutInput input = [self layoutInputForBounds:self.bounds];
+    return RZNotificationLayoutOffsetXLeft(&input);
+}
+
+- (CGFloat) getOffsetXRight
+{
+    RZNotificationLayoutInput input = [self layoutInputForBounds:self.bounds];
+    return RZNotificationLayoutOffsetXRight(&input);
+}
+
+#pragma mark - Layout
+
+- (RZNotificationLayoutInput) layoutInputForBounds:(CGRect)bounds
+{
+    RZNotificationLayoutInput input;
+    input.bounds = RZNotificationRectFromCGRect(bounds);
+    input.topOffset = _topOffset;
+    input.safeTopInset = _safeTopInset;
+    input.safeBottomInset = _safeBottomInset;
+    // From the names, no image lookup: the layout runs on every frame change
+    input.hasIcon = [self imageNameForIcon:_icon] != nil;
+    input.hasAnchor = [self imageNameForAnchor:_anchor] != nil;
+    input.offsetX = kDefaultOffsetX; // kOffsetBetweenTextAndImages is the same value
+    input.contentMarginHeight = _styleContentMarginHeight >= 0.0f ? _styleContentMarginHeight : kDefaultContentMarginHeight;
+    input.iconWidth = kIconWidth;
+    input.iconHeight = kIconHeight;
+    return input;
+}
+
+- (void) invalidateLayout
+{
+    _hasLayout = NO;
+    [self setNeedsLayout];
+}
+
+- (void) setNeedsAppearanceUpdate
+{
+    _needsAppearanceUpdate = YES;
+    [self setNeedsLayout];
+}
+
+- (void) layoutSubviews
+{
+    [super layoutSubviews];
+    
+    if (_backgroundLayer) {
+        [CATransaction begin];
+        [CATransaction setDisableActions:YES];
+        _backgroundLayer.frame = self.bounds;
+        [CATransaction commit];
     }
     
-    return offsetX;
+    RZNotificationLayoutInput input = [self layoutInputForBounds:self.bounds];
+    if (!_hasLayout || !RZNotificationLayoutInputEqual(&input, &_layoutInput)) {
+        RZNotificationLayoutResult layout;
+        RZNotificationLayoutCompute(&input, &layout);
+        
+        CGRect contentFrame = CGRectFromRZNotificationRect(layout.contentFrame);
+        _iconView.frame = CGRectFromRZNotificationRect(layout.iconFrame);
+        _textLabel.frame = contentFrame;
+        [_customView setFrame:contentFrame];
+        _anchorView.frame = CGRectFromRZNotificationRect(layout.anchorFrame);
+        
+        _layoutInput = input;
+        _hasLayout = YES;
+    }
+    
+    if (_needsAppearanceUpdate) {
+        [self updateContentAppearance];
+    }
 }
 
-- (CGFloat) getOffsetXRight
+- (void) updateContentAppearance
 {
-    CGFloat offsetX = kDefaultOffsetX;
-    if ([self getImageForAnchor:_anchor]) {
-        offsetX += (kIconWidth + kOffsetBetweenTextAndImages);
+    UIColor *colorStart = [self backgroundStartColor];
+    
+    if ([self hasResolvedStyleImages]) {
+        _iconView.image = _resolvedStyle->_iconImage;
+        _anchorView.image = _resolvedStyle->_anchorImage;
+    }
+    else {
+        _iconView.image = [self imageNamed:[self imageNameForIcon:_icon] withColor:colorStart];
+        _anchorView.image = [self imageNamed:[self imageNameForAnchor:_anchor] withColor:colorStart];
+    }
+    
+    if (_textColor != RZNotificationContentColorManual) {
+        _textLabel.textColor = [self adjustTextColor:colorStart];
     }
     
-    return offsetX;
+    _needsAppearanceUpdate = NO;
 }
 
 #pragma mark - Color Adjustements
 
+/**
+ *  Palette colors are built once from the RZNotificationColorMath table
+ */
+static UIColor *RZPaletteColor(RZNotificationColor color, RZNotificationPaletteRole role)
+{
+    static dispatch_once_t pred = 0;
+    __strong static NSArray *_palette = nil;
+    dispatch_once(&pred, ^{
+        NSMutableArray *palette = [NSMutableArray arrayWithCapacity:RZNotificationPaletteCount * RZNotificationPaletteRoleCount];
+        for (long index = 0; index < RZNotificationPaletteCount; index++) {
+            for (int paletteRole = 0; paletteRole < RZNotificationPaletteRoleCount; paletteRole++) {
+                [palette addObject:[UIColor colorWithRGBA:RZNotificationPaletteColor(index, paletteRole)]];
+            }
+        }
+        _palette = palette;
+    });
+    
+    // Unknown colors are grey, the last palette entry
+    long index = (color >= 0 && color < RZNotificationPaletteCount) ? color : RZNotificationPaletteCount - 1;
+    return [_palette objectAtIndex:index * RZNotificationPaletteRoleCount + role];
+}
+
 - (UIColor*) adjustTextColor:(UIColor*)c
 {
     UIColor *colorToReturn = nil;
@@ -131,10 +516,16 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
         case RZNotificationContentColorAutomaticDark:
-            colorToReturn = [UIColor darkerColorForColor:c withRgbOffset:0.55f];
+            if ([self hasCustomColors])
+                colorToReturn = [UIColor darkerColorForColor:c withRgbOffset:0.55f];
+            else
+                colorToReturn = RZPaletteColor(_color, RZNotificationPaletteRoleTextAutomaticDark);
             break;
         case RZNotificationContentColorAutomaticLight:
-            colorToReturn = [UIColor lighterColorForColor:c withRgbOffset:0.9f];
+            if ([self hasCustomColors])
+                colorToReturn = [UIColor lighterColorForColor:c withRgbOffset:0.9f];
+            else
+                colorToReturn = RZPaletteColor(_color, RZNotificationPaletteRoleTextAutomaticLight);
             break;
 #pragma GCC diagnostic pop
             
@@ -148,18 +539,50 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 
 #pragma mark - Drawings
 
+// Fill color of light and dark assets, nil for the automatic ones
+static UIColor *RZAssetTintColor(RZNotificationContentColor assetColor)
+{
+    switch (assetColor) {
+        case RZNotificationContentColorLight:
+            return [UIColor whiteColor];
+        case RZNotificationContentColorDark:
+            return [UIColor colorWithWhite:76.0f/255.0f alpha:1.0f];
+        default:
+            return nil;
+    }
+}
+
+// Light and dark assets do not depend on the background color, any thread
+static UIImage *RZTintedImageNamed(NSString *imageName, RZNotificationContentColor assetColor, UIColor *tintColor, CGFloat scale, id traceObject)
+{
+    if (!imageName)
+        return nil;
+    
+    return [[RZNotificationImageCache sharedCache] imageNamed:imageName
+                                                   assetColor:assetColor
+                                                    baseColor:nil
+                                                        scale:scale
+                                                  renderBlock:^UIImage *{
+                                                      RZNotificationTraceCounterAdd(RZNotificationTraceCounterIconRenders, 1);
+                                                      double traceBegin = RZTraceIntervalBegin(RZNotificationTraceEventIconRender, traceObject);
+                                                      UIImage *image = [RZNotificationImageCache imageByFillingImage:[UIImage imageNamed:imageName] withColor:tintColor];
+                                                      RZTraceIntervalEnd(RZNotificationTraceEventIconRender, traceObject, traceBegin);
+                                                      return image;
+                                                  }];
+}
+
 - (UIImage *)image:(UIImage *)img withColor:(UIColor *)color
 {
+    // A plain fill, MOOMaskedIconView is only needed for the gradients and can only render on the main thread
+    UIColor *tintColor = RZAssetTintColor(_assetColor);
+    if (tintColor) {
+        return [RZNotificationImageCache imageByFillingImage:img withColor:tintColor];
+    }
+    
     MOOStyleTrait *iconTrait = [MOOStyleTrait trait];
     
     switch(_assetColor)
     {
-        case RZNotificationContentColorLight:
-            iconTrait.color = [UIColor whiteColor];
-            break;
-        case RZNotificationContentColorDark:
-            iconTrait.color = [UIColor colorWithWhite:76.0f/255.0f alpha:1.0f];
-            break;
         case RZNotificationContentColorManual:
             NSLog(@"Warning, setting RZNotificationContentColorManual for assetColor is not supported. Setting to textColor");
             if (_textColor != RZNotificationContentColorManual)
@@ -193,6 +616,8 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
             iconTrait.clipsShadow = NO;
             break;
 #pragma GCC diagnostic pop
+        default:
+            break;
     }
     
     MOOMaskedIconView *iconView = [MOOMaskedIconView iconWithImage:img];
@@ -202,16 +627,32 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     return [iconView renderImage];
 }
 
-- (void) drawRect:(CGRect)rect
+- (UIImage *)imageNamed:(NSString *)imageName withColor:(UIColor *)color
 {
-    //// General Declarations
-    CGContextRef context = UIGraphicsGetCurrentContext();
+    if (!imageName)
+        return nil;
     
-    //// Color Declarations
-    
-    UIColor* colorStart = nil;
-    UIColor* colorEnd = nil;
+    if (_assetColor == RZNotificationContentColorManual) {
+        // Resolve the asset color before building the cache key
+        NSLog(@"Warning, setting RZNotificationContentColorManual for assetColor is not supported. Setting to textColor");
+        _assetColor = RZResolvedAssetColor(_assetColor, _textColor);
+    }
     
+    return [[RZNotificationImageCache sharedCache] imageNamed:imageName
+                                                   assetColor:_assetColor
+                                                    baseColor:color
+                                                        scale:[[UIScreen mainScreen] scale]
+                                                  renderBlock:^UIImage *{
+                                                      RZNotificationTraceCounterAdd(RZNotificationTraceCounterIconRenders, 1);
+                                                      double traceBegin = RZTraceIntervalBegin(RZNotificationTraceEventIconRender, self);
+                                                      UIImage *image = [self image:[UIImage imageNamed:imageName] withColor:color];
+                                                      RZTraceIntervalEnd(RZNotificationTraceEventIconRender, self, traceBegin);
+                                                      return image;
+                                                  }];
+}
+
+- (UIColor *) backgroundStartColor
+{
     if( _customTopColor || _customBottomColor) {
         if( !_customTopColor)
             _customTopColor = _customBottomColor;
@@ -219,42 +660,61 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
         if( !_customBottomColor)
             _customBottomColor = _customTopColor;
         
-        colorStart = _customTopColor;
-        colorEnd   = _customBottomColor;
+        return _customTopColor;
     }
-    else {
-        switch (_color) {
-            case RZNotificationColorYellow:
-                colorStart = RZUIColorFromRGB(0xFFBD00);
-                break;
-            case RZNotificationColorRed:
-                colorStart = RZUIColorFromRGB(0xB20000);
-                break;
-            case RZNotificationColorLightBlue:
-                colorStart = RZUIColorFromRGB(0x3699C9);
-                break;
-            case RZNotificationColorDarkBlue:
-                colorStart = RZUIColorFromRGB(0x395799);
-                break;
-            case RZNotificationColorPurple:
-                colorStart = RZUIColorFromRGB(0x704081);
-                break;
-            case RZNotificationColorOrange:
-                colorStart = RZUIColorFromRGB(0xD35400);
-                break;
-                // Deprecated
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-            case RZNotificationColorGrey:
-                colorStart = [UIColor colorWithRed: 162.0f/255.0f green: 156.0f/255.0f blue: 142.0f/255.0f alpha: 1.0f];
-                break;
-#pragma GCC diagnostic pop
-            default:
-                colorStart = [UIColor colorWithRed: 162.0f/255.0f green: 156.0f/255.0f blue: 142.0f/255.0f alpha: 1.0f];
-                break;
-        }
+    
+    return RZPaletteColor(_color, RZNotificationPaletteRoleStart);
+}
+
+- (UIColor *) backgroundStrokeColor
+{
+    if ([self hasCustomColors]) {
+        UIColor *colorStart = [self backgroundStartColor];
+        if (_resolvedStyle && _resolvedStyle->_startColor == colorStart)
+            return _resolvedStyle->_strokeColor;
+        
+        return [UIColor lighterColorForColor:colorStart withRgbOffset:0.1f];
     }
     
+    return RZPaletteColor(_color, RZNotificationPaletteRoleStroke);
+}
+
+// The pre-rendered images of the applied style, unless the properties they depend on changed since
+- (BOOL) hasResolvedStyleImages
+{
+    RZNotificationResolvedStyle *resolved = _resolvedStyle;
+    if (!resolved || !resolved->_hasImages)
+        return NO;
+    
+    RZNotificationStyle *style = resolved->_style;
+    if (_assetColor != resolved->_assetColor || _icon != style.icon || _anchor != style.anchor)
+        return NO;
+    
+    return _icon != RZNotificationIconCustom || [_customIcon isEqualToString:style.customIcon];
+}
+
+- (BOOL) hasCustomColors
+{
+    return _customTopColor || _customBottomColor;
+}
+
+- (UIColor *) backgroundEndColor
+{
+    // Only custom colors are drawn with a gradient
+    return _customBottomColor ? _customBottomColor : _customTopColor;
+}
+
+- (void) drawRect:(CGRect)rect
+{
+    RZNotificationTraceCounterAdd(RZNotificationTraceCounterDraws, 1);
+    double traceBegin = RZTraceIntervalBegin(RZNotificationTraceEventDraw, self);
+    
+    //// General Declarations
+    CGContextRef context = UIGraphicsGetCurrentContext();
+    
+    //// Color Declarations
+    UIColor* colorStart = [self backgroundStartColor];
+    UIColor* colorEnd = [self backgroundEndColor];
     
     //// Frames
     CGRect notificationFrame = rect;
@@ -294,7 +754,7 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
         CGContextFillRect(context, notificationFrame);
         
         // Draw stroke
-        UIColor *strokeColor = [UIColor lighterColorForColor:colorStart withRgbOffset:0.1f];
+        UIColor *strokeColor = [self backgroundStrokeColor];
         CGContextSetLineWidth(context, 1.0f);
         CGContextSetStrokeColorWithColor(context, strokeColor.CGColor);
         CGContextStrokeRect(context, notificationFrame);
@@ -302,38 +762,77 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     
     CGContextRestoreGState(context);
     
-    //// Subframes
-    _iconView.frame = CGRectMake(0.0f,
-                                 CGRectGetMinY(notificationFrame) + _topOffset + (CGFloat)floor((CGRectGetHeight(notificationFrame) - kIconHeight - _safeBottomInset + _safeTopInset) * 0.5f),
-                                 kIconWidth,
-                                 kIconHeight);
-    _iconView.center = CGPointMake(kDefaultOffsetX + kIconWidth * 0.5f, _iconView.center.y);
-    
-    CGRect contentFrame = CGRectMake(CGRectGetMinX(notificationFrame) + [self getOffsetXLeft],
-                                     CGRectGetMinY(notificationFrame) + kDefaultContentMarginHeight + _topOffset,
-                                     CGRectGetWidth(notificationFrame) - [self getOffsetXLeft] - [self getOffsetXRight],
-                                     CGRectGetHeight(notificationFrame) - 2*kDefaultContentMarginHeight - _safeBottomInset + _safeTopInset);
-    _textLabel.frame = contentFrame;
-    [_customView setFrame:contentFrame];
+    RZTraceIntervalEnd(RZNotificationTraceEventDraw, self, traceBegin);
+}
+
+#pragma mark - Layer backed background
 
-    _iconView.image = [self image:[self getImageForIcon:_icon] withColor:colorStart];
-    _anchorView.image = [self image:[self getImageForAnchor:_anchor] withColor:colorStart];
-    [_anchorView setSize:_anchorView.image.size];
+- (BOOL) respondsToSelector:(SEL)aSelector
+{
+    // CALayer only skips the backing store allocation when its delegate responds to `displayLayer:`
+    if (aSelector == @selector(displayLayer:)) {
+        return _backgroundRendering == RZNotificationBackgroundRenderingLayer;
+    }
+    return [super respondsToSelector:aSelector];
+}
+
+- (void) displayLayer:(CALayer *)layer
+{
+    [self updateBackgroundLayerWithColor:[self backgroundStartColor]];
+}
+
+- (void) updateBackgroundLayerWithColor:(UIColor *)colorStart
+{
+    if (!_backgroundLayer) {
+        _backgroundLayer = [CAGradientLayer layer];
+        _backgroundLayer.frame = self.bounds;
+        [self.layer insertSublayer:_backgroundLayer atIndex:0];
+    }
+    
+    UIColor *colorEnd = [self backgroundEndColor];
     
-    _anchorView.frame = CGRectMake(0.0f, CGRectGetMinY(notificationFrame) + _topOffset + (CGFloat)floor((CGRectGetHeight(notificationFrame) - kIconHeight - _safeBottomInset + _safeTopInset) * 0.5f), kIconWidth, kIconHeight);
-    _anchorView.center = CGPointMake(CGRectGetMaxX(notificationFrame) - (kDefaultOffsetX + kIconWidth * 0.5f), _anchorView.center.y);
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    if (colorEnd) {
+        _backgroundLayer.colors = @[(id)colorStart.CGColor, (id)colorEnd.CGColor];
+        _backgroundLayer.backgroundColor = NULL;
+        _backgroundLayer.borderWidth = 0.0f;
+    }
+    else {
+        // A 1px stroke centered on the bounds only shows its inner half, hence the 0.5 border
+        _backgroundLayer.colors = nil;
+        _backgroundLayer.backgroundColor = colorStart.CGColor;
+        _backgroundLayer.borderColor = [self backgroundStrokeColor].CGColor;
+        _backgroundLayer.borderWidth = 0.5f;
+    }
+    [CATransaction commit];
+}
 
-    if (_textColor != RZNotificationContentColorManual) {
-        _textLabel.textColor = [self adjustTextColor:colorStart];
+- (void) setBackgroundRendering:(RZNotificationBackgroundRendering)backgroundRendering
+{
+    if (_backgroundRendering == backgroundRendering)
+        return;
+    
+    _backgroundRendering = backgroundRendering;
+    
+    if (_backgroundRendering == RZNotificationBackgroundRenderingDrawRect) {
+        [_backgroundLayer removeFromSuperlayer];
+        _backgroundLayer = nil;
     }
+    else {
+        // Release the backing store drawn so far
+        self.layer.contents = nil;
+    }
+    [self setNeedsDisplay];
+    [RZNotificationViewManager updateMemoryOfNotification:self];
 }
 
 #pragma mark - Getters and Setters
 
-- (UIImage *) getImageForIcon:(RZNotificationIcon)icon
+static NSString *RZImageNameForIcon(RZNotificationIcon icon, NSString *customIcon)
 {
     NSString *imageName = nil;
-    switch (_icon) {
+    switch (icon) {
         case RZNotificationIconFacebook:
             imageName = @"notif_facebook";
             break;
@@ -353,7 +852,7 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
             imageName = @"notif_warning";
             break;
         case RZNotificationIconCustom:
-            imageName = _customIcon;
+            imageName = customIcon;
             break;
         case RZNotificationIconNone:
             imageName = nil;
@@ -362,10 +861,21 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
             break;
     }
     
+    return imageName;
+}
+
+- (NSString *) imageNameForIcon:(RZNotificationIcon)icon
+{
+    return RZImageNameForIcon(_icon, _customIcon);
+}
+
+- (UIImage *) getImageForIcon:(RZNotificationIcon)icon
+{
+    NSString *imageName = [self imageNameForIcon:icon];
     return imageName ? [UIImage imageNamed:imageName] : nil;
 }
 
-- (UIImage*) getImageForAnchor:(RZNotificationAnchor)anchor
+static NSString *RZImageNameForAnchor(RZNotificationAnchor anchor)
 {
     NSString *imageName = nil;
     switch (anchor) {
@@ -378,6 +888,17 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
         default:
             break;
     }
+    return imageName;
+}
+
+- (NSString *) imageNameForAnchor:(RZNotificationAnchor)anchor
+{
+    return RZImageNameForAnchor(anchor);
+}
+
+- (UIImage*) getImageForAnchor:(RZNotificationAnchor)anchor
+{
+    NSString *imageName = [self imageNameForAnchor:anchor];
     return imageName ? [UIImage imageNamed:imageName] : nil;
 }
 
@@ -390,86 +911,132 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     else {
         _icon = RZNotificationIconNone;
     }
+    [self setNeedsAppearanceUpdate];
 }
 
 - (void) setColor:(RZNotificationColor)color
 {
     _color = color;
+    [self setNeedsAppearanceUpdate];
     [self setNeedsDisplay];
 }
 
 - (void) setAssetColor:(RZNotificationContentColor)assetColor
 {
     _assetColor = assetColor;
+    [self setNeedsAppearanceUpdate];
     [self setNeedsDisplay];
 }
 
 - (void) setCustomTopColor:(UIColor *)customTopColor
 {
     _customTopColor = customTopColor;
+    [self setNeedsAppearanceUpdate];
     [self setNeedsDisplay];
 }
 
 - (void) setCustomBottomColor:(UIColor *)customBottomColor
 {
     _customBottomColor = customBottomColor;
+    [self setNeedsAppearanceUpdate];
     [self setNeedsDisplay];
 }
 
 - (void) setPosition:(RZNotificationPosition)position
 {
     _position = position;
-    [self setNeedsDisplay];
+    
+    // Each position has its own window, until the notification is scheduled
+    if ([_container isKindOfClass:[RZNotificationWindow class]] && !_isShowing && _scheduledIdentifier == 0) {
+        RZNotificationWindow *window = (RZNotificationWindow*)_container;
+        _container = [RZNotificationViewManager notificationWindowForContext:window.context position:position];
+    }
+    [self setNeedsLayout];
 }
 
-- (void) setMessage:(NSString *)message
+- (void) setTextColor:(RZNotificationContentColor)textColor
 {
-    NSString *tempMessage = message;
-    _message = message;
-    
-    NSInteger maxLenght = _messageMaxLenght;
-    if (maxLenght == 0)
-        maxLenght = kDefaultMaxMessageLength;
-    
-    if(maxLenght < [message length])
-        tempMessage = [[message substringToIndex:maxLenght] stringByAppendingString:@"..."]; // Tail truncation
+    _textColor = textColor;
+    [self setNeedsAppearanceUpdate];
+}
+
+- (void) setIcon:(RZNotificationIcon)icon
+{
+    _icon = icon;
+    [self setNeedsAppearanceUpdate];
+}
+
+// Both measurement paths share the cache, they measure the same way. Any thread
+static CGFloat RZMeasuredTextHeight(NSString *text, UIFont *font, CGFloat width)
+{
+    if (!text)
+        return 0.0f;
+    CGRect rect = [text boundingRectWithSize:CGSizeMake(width, CGFLOAT_MAX)
+                                     options:NSStringDrawingUsesLineFragmentOrigin
+                                  attributes:@{NSFontAttributeName: font}
+                                     context:nil];
+    // Rounded like `sizeToFit`
+    return ceil(CGRectGetHeight(rect));
+}
+
+- (void) setMessage:(NSString *)message
+{
+    _message = message;
     
     if ([(UIView*)_customView superview]) {
         [_customView removeFromSuperview];
     }
     
     [self addTextLabelIfNeeded];
+    [self measureMessage];
+}
+
+- (void) measureMessage
+{
+    if (_batchUpdateDepth > 0) {
+        _needsMessageMeasurement = YES;
+        return;
+    }
     
-    _textLabel.text = tempMessage;
+    NSString *message = _message;
+    NSInteger maxLenght = _messageMaxLenght;
+    if (maxLenght == 0)
+        maxLenght = kDefaultMaxMessageLength;
     
-    CGRect frameL = self.frame;
-    frameL.size.width -= [self getOffsetXLeft] + [self getOffsetXRight];
-    _textLabel.frame   = frameL;
-    [_textLabel sizeToFit];
+    CGFloat width = CGRectGetWidth(self.frame) - [self getOffsetXLeft] - [self getOffsetXRight];
+    CGFloat height = [[RZNotificationTextMeasurementCache sharedCache] heightForMessage:message
+                                                                                   font:_textLabel.font
+                                                                                  width:width
+                                                                              maxLength:maxLenght
+                                                                           measureBlock:^CGFloat{
+                                                                               RZNotificationTraceCounterAdd(RZNotificationTraceCounterTextMeasurements, 1);
+                                                                               double traceBegin = RZTraceIntervalBegin(RZNotificationTraceEventTextMeasurement, self);
+                                                                               CGFloat measuredHeight = RZMeasuredTextHeight(RZTruncatedMessage(message, maxLenght), _textLabel.font, width);
+                                                                               RZTraceIntervalEnd(RZNotificationTraceEventTextMeasurement, self, traceBegin);
+                                                                               return measuredHeight;
+                                                                           }];
     
     _textLabel.text = message; // FIXME: Why? We should keep the truncated text
     
-    [self adjustHeightAndRedraw:CGRectGetHeight(_textLabel.frame)];
+    [self adjustHeightAndRedraw:height];
 }
 
 - (void) setSound:(NSString *)sound
 {
     if(sound && ((NSNull*)sound != [NSNull null])) {
-        _sound = sound;
-        
-        NSURL *soundURL   = [[NSBundle mainBundle] URLForResource: [_sound stringByDeletingPathExtension]
-                                                    withExtension: [_sound pathExtension]];
+        if ([sound isEqualToString:_sound])
+            return;
         
-        // Create a system sound object representing the sound file.
-        AudioServicesCreateSystemSoundID (
-                                          (__bridge CFURLRef)(soundURL),
-                                          &_soundFileObject
-                                          );
+        // The registry shares one sound ID per file between notifications
+        RZNotificationSoundRegistry *registry = [RZNotificationSoundRegistry sharedRegistry];
+        [registry releaseSoundNamed:_sound];
+        _sound = sound;
+        _soundFileObject = [registry retainSoundNamed:_sound];
         
         if (_isShowing && !_hasPlayedSound && sound) {
             // Then we play the sound for the first time
             // This happens when you use [RZNotificationView showNotification ...]
-            AudioServicesPlaySystemSound (_soundFileObject);
+            [registry playSoundNamed:_sound];
             _hasPlayedSound = YES;
         }
     }
@@ -480,7 +1047,7 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     _vibrate = vibrate;
     
     if (_isShowing && !_hasVibrate && vibrate) {
-        AudioServicesPlaySystemSound (kSystemSoundID_Vibrate);
+        [[RZNotificationSoundRegistry sharedRegistry] vibrate];
         _hasVibrate = YES;
     }
 }
@@ -495,6 +1062,7 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     else if (_anchor == RZNotificationAnchorNone && _anchorView.superview){
         [_anchorView removeFromSuperview];
     }
+    [self setNeedsAppearanceUpdate];
 }
 
 - (void) setCustomView:(id<RZNotificationLabelProtocol>)customView
@@ -504,6 +1072,7 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
         [_customView removeFromSuperview];
         _customView = customView;
         [self addSubview:(UIView*)_customView];
+        [self invalidateLayout];
         
         if ([_customView shouldHandleTouch] && [_customView isKindOfClass:[UIControl class]]) {
             [((UIControl *)_customView) addTarget:self
@@ -574,6 +1143,11 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     kDefaultOffsetX = defaultXOffset;
 }
 
++ (void)registerBackgroundRendering:(RZNotificationBackgroundRendering)backgroundRendering
+{
+    kDefaultBackgroundRendering = backgroundRendering;
+}
+
 #pragma mark - Subviews build
 
 - (void) addTextLabelIfNeeded
@@ -600,8 +1174,11 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
         _textLabel.textColor = [UIColor blackColor];
     }
     
-    if (!_textLabel.superview)
+    if (!_textLabel.superview) {
         [self addSubview:_textLabel];
+        [self invalidateLayout];
+        [self setNeedsAppearanceUpdate];
+    }
 }
 
 #pragma mark - Init methods
@@ -614,6 +1191,8 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     self = [super initWithFrame:mFrame];
     if (self)
     {
+        sAllocatedNotifications++;
+        
         self.backgroundColor = [UIColor clearColor];
         self.autoresizingMask = UIViewAutoresizingFlexibleWidth;
         
@@ -626,7 +1205,10 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
         _textColor = textColor;
         _icon = icon;
         _anchor = anchor;
-        _labelFont = [UIFont fontWithName:@"Avenir" size:15.0];
+        _labelFont = RZDefaultLabelFont();
+        self.backgroundRendering = kDefaultBackgroundRendering;
+        _needsAppearanceUpdate = YES;
+        _styleContentMarginHeight = -1.0f;
         
         kDefaultContentMarginHeight = kDefaultContentMarginHeight;
         
@@ -650,19 +1232,36 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
             [self addSubview:_anchorView];
         }
         
-        // Observe device orientation changes
-        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(deviceOrientationDidChange:) name:UIDeviceOrientationDidChangeNotification object:nil];
-        
         // Handle touch
         [self addTarget:self
                  action:@selector(handleTouch)
        forControlEvents:UIControlEventTouchUpInside];
         
+        [self recordLifecycleEvent:RZNotificationLifecycleEventCreated];
     }
     return self;
     
 }
 
+- (void) setupWithIcon:(RZNotificationIcon)icon anchor:(RZNotificationAnchor)anchor position:(RZNotificationPosition)position color:(RZNotificationColor)color assetColor:(RZNotificationContentColor)assetColor textColor:(RZNotificationContentColor)textColor duration:(NSTimeInterval)duration
+{
+    // Same values as `initWithFrame:icon:...`, for a view coming out of the reuse pool
+    CGRect frame = CGRectMake(0.0f, 0.0f, CGRectGetWidth(PPScreenBounds()), kMinHeight);
+    self.frame = frame;
+    
+    _delay = duration;
+    _position = position;
+    _color = color;
+    _vibrate = kDefaultVibrate;
+    _assetColor = assetColor;
+    _textColor = textColor;
+    _icon = icon;
+    self.anchor = anchor;
+    // Through the setter, the previous mode may have left a background layer or a backing store
+    self.backgroundRendering = kDefaultBackgroundRendering;
+    _needsAppearanceUpdate = YES;
+}
+
 - (id) initWithFrame:(CGRect)frame
 {
     return [self initWithFrame:frame
@@ -709,6 +1308,37 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     return self;
 }
 
++ (RZNotificationView*) reusableNotificationWithContainer:(id<RZNotificationViewManagerProtocol>)container icon:(RZNotificationIcon)icon anchor:(RZNotificationAnchor)anchor position:(RZNotificationPosition)position color:(RZNotificationColor)color assetColor:(RZNotificationContentColor)assetColor textColor:(RZNotificationContentColor)textColor duration:(NSTimeInterval)duration completion:(RZNotificationCompletion)completionBlock
+{
+    RZNotificationView *notification = [RZNotificationViewManager dequeueReusableNotification];
+    if (notification) {
+        sReusedNotifications++;
+        [notification setupWithIcon:icon
+                             anchor:anchor
+                           position:position
+                              color:color
+                         assetColor:assetColor
+                          textColor:textColor
+                           duration:duration];
+        notification.container = container;
+        notification.completionBlock = completionBlock;
+        [notification recordLifecycleEvent:RZNotificationLifecycleEventCreated];
+    }
+    else {
+        notification = [[RZNotificationView alloc] initWithContainer:container
+                                                                icon:icon
+                                                              anchor:anchor
+                                                            position:position
+                                                               color:color
+                                                          assetColor:assetColor
+                                                           textColor:textColor
+                                                            duration:duration
+                                                          completion:completionBlock];
+    }
+    notification->_reusable = YES;
+    return notification;
+}
+
 - (id) initWithController:(UIViewController*)controller
 {
     CGRect frame = self.bounds;
@@ -723,7 +1353,7 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 
 - (id) initWithContext:(RZNotificationContext)context icon:(RZNotificationIcon)icon anchor:(RZNotificationAnchor)anchor position:(RZNotificationPosition)position color:(RZNotificationColor)color assetColor:(RZNotificationContentColor)assetColor textColor:(RZNotificationContentColor)textColor duration:(NSTimeInterval)duration completion:(RZNotificationCompletion)completionBlock {
     
-    id<RZNotificationViewManagerProtocol> container = [[self class] containerForContext:context];
+    id<RZNotificationViewManagerProtocol> container = [[self class] containerForContext:context position:position];
     self = [self initWithContainer:container
                               icon:icon
                             anchor:anchor
@@ -756,18 +1386,17 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 
 + (RZNotificationView*) showNotificationWithMessage:(NSString*)message icon:(RZNotificationIcon)icon anchor:(RZNotificationAnchor)anchor position:(RZNotificationPosition)position color:(RZNotificationColor)color assetColor:(RZNotificationContentColor)assetColor textColor:(RZNotificationContentColor)textColor duration:(NSTimeInterval)duration addedToController:(UIViewController*)controller withCompletion:(RZNotificationCompletion)completionBlock;
 {
-    RZNotificationView *notification = [[RZNotificationView alloc] initWithController:controller
-                                                                                 icon:icon
-                                                                               anchor:anchor
-                                                                             position:position
-                                                                                color:color
-                                                                           assetColor:assetColor
-                                                                            textColor:textColor
-                                                                             duration:duration
-                                                                           completion:completionBlock];
+    RZNotificationView *notification = [RZNotificationView reusableNotificationWithContainer:controller
+                                                                                       icon:icon
+                                                                                     anchor:anchor
+                                                                                   position:position
+                                                                                      color:color
+                                                                                 assetColor:assetColor
+                                                                                  textColor:textColor
+                                                                                   duration:duration
+                                                                                 completion:completionBlock];
     [notification setMessage:message];
-    [notification show];
-    return notification;
+    return [RZNotificationViewManager scheduleNotification:notification];
 }
 
 + (RZNotificationView*) showNotificationOn:(RZNotificationContext)context message:(NSString*)message icon:(RZNotificationIcon)icon anchor:(RZNotificationAnchor)anchor position:(RZNotificationPosition)position color:(RZNotificationColor)color assetColor:(RZNotificationContentColor)assetColor textColor:(RZNotificationContentColor)textColor withCompletion:(RZNotificationCompletion)completionBlock
@@ -787,21 +1416,89 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 
 + (RZNotificationView*) showNotificationOn:(RZNotificationContext)context message:(NSString*)message icon:(RZNotificationIcon)icon anchor:(RZNotificationAnchor)anchor position:(RZNotificationPosition)position color:(RZNotificationColor)color assetColor:(RZNotificationContentColor)assetColor textColor:(RZNotificationContentColor)textColor duration:(NSTimeInterval)duration withCompletion:(RZNotificationCompletion)completionBlock
 {
-    RZNotificationView *notification = [[RZNotificationView alloc] initWithContext:context
-                                                                              icon:icon
-                                                                            anchor:anchor
-                                                                          position:position
-                                                                             color:color
-                                                                        assetColor:assetColor
-                                                                         textColor:textColor
-                                                                          duration:duration
-                                                                        completion:completionBlock];
+    RZNotificationView *notification = [RZNotificationView reusableNotificationWithContainer:[self containerForContext:context position:position]
+                                                                                       icon:icon
+                                                                                     anchor:anchor
+                                                                                   position:position
+                                                                                      color:color
+                                                                                 assetColor:assetColor
+                                                                                  textColor:textColor
+                                                                                   duration:duration
+                                                                                 completion:completionBlock];
+    notification.context = context;
     [notification setMessage:message];
-    [notification show];
+    return [RZNotificationViewManager scheduleNotification:notification];
+}
+
+#pragma mark - Prepared notifications
+
++ (void) prepareNotification:(RZNotificationDescription*)description completion:(RZNotificationPrepareCompletion)completion
+{
+    NSAssert([NSThread isMainThread], @"`prepareNotification:completion:` must be called on the main thread");
+    RZNotificationDescription *notificationDescription = [description copy];
+    id<RZNotificationViewManagerProtocol> container = [self containerForContext:notificationDescription.context position:notificationDescription.position];
+    
+    // Same width and scale as the notifications built by the show methods, so they hit the caches
+    CGFloat width = CGRectGetWidth(PPScreenBounds());
+    CGFloat scale = [[UIScreen mainScreen] scale];
+    
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0), ^{
+        RZPreparedNotification *prepared = [[RZPreparedNotification alloc] initWithDescription:notificationDescription
+                                                                                     container:container
+                                                                                         width:width
+                                                                                         scale:scale];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (completion)
+                completion(prepared);
+        });
+    });
+}
+
++ (RZNotificationView*) showPreparedNotification:(RZPreparedNotification*)prepared withCompletion:(RZNotificationCompletion)completionBlock
+{
+    NSAssert(prepared, @"`prepared should not be nil`");
+    RZNotificationDescription *description = prepared.notificationDescription;
+    id<RZNotificationViewManagerProtocol> container = prepared->_container;
+    if (!container) {
+        // Gone while preparing
+        container = [self containerForContext:description.context position:description.position];
+    }
+    
+    // Measured height, icons and sound are found in the caches
+    RZNotificationView *notification = [self reusableNotificationWithDescription:description container:container completion:completionBlock];
+    return [RZNotificationViewManager scheduleNotification:notification];
+}
+
++ (void) submitNotification:(RZNotificationDescription*)description withCompletion:(RZNotificationCompletion)completionBlock
+{
+    NSAssert(description, @"`description should not be nil`");
+    [RZNotificationViewManager submitNotification:[description copy] completion:completionBlock];
+}
+
++ (RZNotificationView*) reusableNotificationWithDescription:(RZNotificationDescription*)description container:(id<RZNotificationViewManagerProtocol>)container completion:(RZNotificationCompletion)completionBlock
+{
+    RZNotificationView *notification = [RZNotificationView reusableNotificationWithContainer:container
+                                                                                       icon:description.icon
+                                                                                     anchor:description.anchor
+                                                                                   position:description.position
+                                                                                      color:description.color
+                                                                                 assetColor:description.assetColor
+                                                                                  textColor:description.textColor
+                                                                                   duration:description.duration
+                                                                                 completion:completionBlock];
+    notification.context = description.context;
+    notification.priority = description.priority;
+    if (description.icon == RZNotificationIconCustom) {
+        notification.customIcon = description.customIcon;
+    }
+    notification.messageMaxLenght = description.messageMaxLenght;
+    [notification setMessage:description.message];
+    notification.sound = description.sound;
+    notification.vibrate = description.vibrate;
     return notification;
 }
 
-+ (id<RZNotificationViewManagerProtocol>)containerForContext:(RZNotificationContext)context
++ (id<RZNotificationViewManagerProtocol>)containerForContext:(RZNotificationContext)context position:(RZNotificationPosition)position
 {
     id <RZNotificationViewManagerProtocol> toReturn = nil;
     switch (context) {
@@ -810,13 +1507,127 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
             break;
             case RZNotificationContextAboveStatusBar:
             case RZNotificationContextBelowStatusBar:
-            toReturn = [RZNotificationViewManager notificationWindow];
+            toReturn = [RZNotificationViewManager notificationWindowForContext:context position:position];
         default:
             break;
     }
     return toReturn;
 }
 
+#pragma mark - Styles
+
+static NSMutableDictionary *RZRegisteredStyles(void)
+{
+    static dispatch_once_t pred = 0;
+    __strong static NSMutableDictionary *_styles = nil;
+    dispatch_once(&pred, ^{
+        _styles = [[NSMutableDictionary alloc] init];
+    });
+    return _styles;
+}
+
++ (void) registerStyle:(RZNotificationStyle*)style forIdentifier:(NSString*)identifier
+{
+    NSAssert([NSThread isMainThread], @"`registerStyle:forIdentifier:` must be called on the main thread");
+    NSAssert(identifier, @"`identifier should not be nil`");
+    if (style) {
+        [RZRegisteredStyles() setObject:[[RZNotificationResolvedStyle alloc] initWithStyle:style] forKey:identifier];
+    }
+    else {
+        [RZRegisteredStyles() removeObjectForKey:identifier];
+    }
+}
+
++ (RZNotificationStyle*) styleForIdentifier:(NSString*)identifier
+{
+    RZNotificationResolvedStyle *resolved = [RZRegisteredStyles() objectForKey:identifier];
+    return resolved ? [resolved->_style copy] : nil;
+}
+
++ (RZNotificationView*) showNotificationOn:(RZNotificationContext)context message:(NSString*)message style:(NSString*)identifier withCompletion:(RZNotificationCompletion)completionBlock
+{
+    // The window of the notification depends on the position of the style
+    RZNotificationResolvedStyle *resolved = [RZRegisteredStyles() objectForKey:identifier];
+    RZNotificationPosition position = resolved ? resolved->_style.position : kDefaultPosition;
+    RZNotificationView *notification = [RZNotificationView reusableNotificationWithContainer:[self containerForContext:context position:position]
+                                                                                       icon:kDefaultIcon
+                                                                                     anchor:kDefaultAnchor
+                                                                                   position:position
+                                                                                      color:kDefaultColor
+                                                                                 assetColor:kDefaultAssetColor
+                                                                                  textColor:kDefaultTextColor
+                                                                                   duration:kDefaultDuration
+                                                                                 completion:completionBlock];
+    notification.context = context;
+    [notification performBatchUpdates:^{
+        [notification applyStyleWithIdentifier:identifier];
+        [notification setMessage:message];
+    }];
+    return [RZNotificationViewManager scheduleNotification:notification];
+}
+
+- (void) applyStyleWithIdentifier:(NSString*)identifier
+{
+    RZNotificationResolvedStyle *resolved = [RZRegisteredStyles() objectForKey:identifier];
+    NSAssert(resolved, @"No style registered for `%@`", identifier);
+    if (!resolved)
+        return;
+    
+    RZNotificationStyle *style = resolved->_style;
+    [self performBatchUpdates:^{
+        self.color = style.color;
+        self.customTopColor = style.customTopColor;
+        self.customBottomColor = style.customBottomColor;
+        self.assetColor = style.assetColor;
+        self.textColor = style.textColor;
+        if (style.icon == RZNotificationIconCustom) {
+            self.customIcon = style.customIcon;
+        }
+        else {
+            self.icon = style.icon;
+        }
+        self.anchor = style.anchor;
+        self.position = style.position;
+        self.delay = style.duration;
+        self.sound = style.sound;
+        self.vibrate = style.vibrate;
+        self.messageMaxLenght = style.messageMaxLenght;
+        
+        UIFont *font = style.labelFont ? style.labelFont : RZDefaultLabelFont();
+        if (font != _labelFont || style.contentMarginHeight != _styleContentMarginHeight) {
+            _labelFont = font;
+            _textLabel.font = font;
+            _styleContentMarginHeight = style.contentMarginHeight;
+            if (_message && _textLabel.superview) {
+                [self measureMessage];
+            }
+        }
+    }];
+    _resolvedStyle = resolved;
+}
+
+- (void) performBatchUpdates:(void (^)(void))updates
+{
+    _batchUpdateDepth++;
+    if (updates)
+        updates();
+    if (--_batchUpdateDepth > 0)
+        return;
+    
+    BOOL needsMessageMeasurement = _needsMessageMeasurement;
+    BOOL needsHeightAdjustment = _needsHeightAdjustment;
+    _needsMessageMeasurement = NO;
+    _needsHeightAdjustment = NO;
+    
+    // A custom view set after the message replaced the label
+    if (needsMessageMeasurement && _textLabel.superview) {
+        [self measureMessage];
+    }
+    else if (needsHeightAdjustment) {
+        [self adjustHeightAndRedraw:_pendingContentHeight];
+    }
+}
+
 + (BOOL) hideLastNotificationForController:(UIViewController*)controller
 {
     RZNotificationView *notification = [RZNotificationView notificationForController:controller];
@@ -829,13 +1640,64 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 
 + (NSUInteger)hideAllNotificationsForController:(UIViewController *)controller
 {
-    NSArray *notififications = [self allNotificationsForController:controller];
-	for (RZNotificationView *notification in notififications) {
-		[notification hide];
-	}
+    return [self hideAllNotificationsForController:controller completion:nil];
+}
+
++ (NSUInteger)hideAllNotificationsForController:(UIViewController *)controller completion:(RZNotificationBatchCompletion)completion
+{
+    NSArray *notififications = [[self allNotificationsForController:controller] arrayByAddingObjectsFromArray:[RZNotificationViewManager pendingNotificationsForContainer:controller]];
+    [self hideNotifications:notififications completion:completion];
 	return [notififications count];
 }
 
++ (void)hideNotifications:(NSArray *)notifications completion:(RZNotificationBatchCompletion)completion
+{
+    NSMutableArray *animated = [NSMutableArray arrayWithCapacity:[notifications count]];
+    NSUInteger count = 0;
+    
+    for (RZNotificationView *notification in notifications) {
+        switch ([notification beginHide]) {
+            case RZNotificationHideStepAnimate:
+                [animated addObject:notification];
+                count++;
+                break;
+            case RZNotificationHideStepCancelled:
+                count++;
+                break;
+            case RZNotificationHideStepNone:
+                break;
+        }
+    }
+    
+    if ([animated count] == 0) {
+        if (completion)
+            completion(count);
+        return;
+    }
+    
+    // One transaction for every view, one registry pass at the end
+    for (RZNotificationView *notification in animated) {
+        [notification recordLifecycleEvent:RZNotificationLifecycleEventHideAnimationStarted];
+        [notification beginSlide];
+    }
+    RZAnimateSlide(^{
+        for (RZNotificationView *notification in animated) {
+            [notification slideToOrigin];
+        }
+    }, ^(BOOL finished) {
+        for (RZNotificationView *notification in animated) {
+            [notification endSlide];
+            [notification recordLifecycleEvent:RZNotificationLifecycleEventHideAnimationEnded];
+        }
+        [RZNotificationViewManager removeNotifications:animated];
+        for (RZNotificationView *notification in animated) {
+            [notification finishHide];
+        }
+        if (completion)
+            completion(count);
+    });
+}
+
 + (RZNotificationView*) notificationForController:(UIViewController*)controller
 {
     return [RZNotificationViewManager notificationForContainer:controller];
@@ -847,83 +1709,174 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 }
 
 #pragma mark - Show hide methods
-- (CGFloat) _getFinalOriginForPosition:(RZNotificationPosition)position
+- (UIView*) containerView
+{
+    if ([_container isKindOfClass:[UIViewController class]]) {
+        return [(UIViewController*)_container view];
+    }
+    return (UIView*)_container;
+}
+
+// The safe area of a notification window depends on its frame, which depends on its notifications: use the screen one
+- (UIEdgeInsets) containerSafeAreaInsets API_AVAILABLE(ios(11.0))
 {
-    CGFloat finalOrigin = 0.0f;
+    if ([_container isKindOfClass:[RZNotificationWindow class]]) {
+        UIWindow *screenWindow = [(RZNotificationWindow*)_container screenWindow];
+        if (screenWindow)
+            return screenWindow.safeAreaInsets;
+    }
+    return [[self containerView] safeAreaInsets];
+}
+
+- (RZNotificationOriginInput) originInputForPosition:(RZNotificationPosition)position
+{
+    RZNotificationOriginInput input;
+    memset(&input, 0, sizeof(input));
+    
+    UIView *view = [self containerView];
+    input.bottom = (position == RZNotificationPositionBottom);
+    input.containerHeight = CGRectGetHeight(view.frame);
+    input.notificationHeight = CGRectGetHeight(self.frame);
+    // A notification window ends at the screen edge, the notification height already covers its safe area
+    if (@available(iOS 11.0, *)) {
+        if (![_container isKindOfClass:[RZNotificationWindow class]]) {
+            input.safeBottomInset = view.safeAreaInsets.bottom;
+        }
+    }
     
     if ([_container isKindOfClass:[UIViewController class]]) {
         UIViewController *c = (UIViewController*)_container;
         
         if ([c conformsToProtocol:@protocol(RZNotificationViewProtocol)] && [c respondsToSelector:@selector(yOriginForRZNotificationViewForPosition:)]) {
-            finalOrigin = [(UIViewController<RZNotificationViewProtocol>*)c yOriginForRZNotificationViewForPosition:position];
-        } else {
-            if (position == RZNotificationPositionTop) {
-                finalOrigin = [c.topLayoutGuide length];
-            } else {
-                finalOrigin = CGRectGetHeight(c.view.frame) - [c.bottomLayoutGuide length];
-                if (@available(iOS 11.0, *)) {
-                    finalOrigin -= c.view.safeAreaInsets.bottom;
-                }
-            }
-        }
-    }
-    else
-    {
-        UIView *v = (UIView*)_container;
-        
-        if (position == RZNotificationPositionTop) {
-            finalOrigin = 0.0f;
+            input.hasCustomOrigin = 1;
+            input.customOrigin = [(UIViewController<RZNotificationViewProtocol>*)c yOriginForRZNotificationViewForPosition:position];
         } else {
-            finalOrigin = CGRectGetHeight(v.frame);
-            
-            if (@available(iOS 11.0, *)) {
-                finalOrigin -= v.safeAreaInsets.bottom;
-            }
+            input.topGuide = [c.topLayoutGuide length];
+            input.bottomGuide = [c.bottomLayoutGuide length];
         }
     }
     
-    return finalOrigin;
+    return input;
 }
 
 - (void) placeToOrigin
 {
-    CGFloat yOrigin = 0.0f;
-    UIView *view = nil;
-    if ([_container isKindOfClass:[UIViewController class]]) {
-        view = [(UIViewController*)_container view];
+    RZNotificationOriginInput input = [self originInputForPosition:_position];
+    [self setRestingYOrigin:RZNotificationLayoutHiddenY(&input)];
+}
+
+- (void) placeToFinalPosition
+{
+    RZNotificationOriginInput input = [self originInputForPosition:_position];
+    CGFloat y = RZNotificationLayoutShownY(&input);
+    CGFloat stackOffset = [RZNotificationViewManager stackOffsetOfNotification:self];
+    [self setRestingYOrigin:(_position == RZNotificationPositionTop) ? y + stackOffset : y - stackOffset];
+}
+
+// The frame of a sliding view includes its transform, its center does not
+- (void) setRestingYOrigin:(CGFloat)y
+{
+    if (CGAffineTransformIsIdentity(self.transform)) {
+        [self setYOrigin:y];
     }
     else {
-        view = (UIView*)_container;
+        self.center = CGPointMake(self.center.x, y + CGRectGetHeight(self.bounds) / 2.0f);
     }
-    
-    if (_position == RZNotificationPositionTop) {
-        yOrigin = -CGRectGetHeight(self.frame);
+}
+
+#pragma mark - Slide animations
+
+static void RZAnimateSlide(void (^animations)(void), void (^completion)(BOOL finished))
+{
+    if (kAnimationSpringDamping > 0.0f) {
+        [UIView animateWithDuration:kAnimationDuration
+                              delay:0.0
+             usingSpringWithDamping:kAnimationSpringDamping
+              initialSpringVelocity:kAnimationSpringVelocity
+                            options:kAnimationOptions
+                         animations:animations
+                         completion:completion];
     }
     else {
-        yOrigin = CGRectGetHeight(view.frame);
-        
-        if (@available(iOS 11.0, *)) {
-            yOrigin -= view.safeAreaInsets.bottom;
-        }
+        [UIView animateWithDuration:kAnimationDuration
+                              delay:0.0
+                            options:kAnimationOptions
+                         animations:animations
+                         completion:completion];
     }
-    
-    [self setYOrigin:yOrigin];
 }
 
-- (void) placeToFinalPosition
+// Translation from the resting position to the hidden one
+- (CGAffineTransform) hiddenTransform
 {
-    CGFloat yFinalOrigin = 0.0f;
-    
-    if (_position == RZNotificationPositionTop) {
-        yFinalOrigin = [self _getFinalOriginForPosition:_position];
-    } else {
-        yFinalOrigin = [self _getFinalOriginForPosition:_position] - CGRectGetHeight(self.frame);
+    RZNotificationOriginInput input = [self originInputForPosition:_position];
+    CGFloat restingY = self.center.y - CGRectGetHeight(self.bounds) / 2.0f;
+    return CGAffineTransformMakeTranslation(0.0f, RZNotificationLayoutHiddenY(&input) - restingY);
+}
+
+// Called before the show animation, the view is at its origin
+- (void) beginSlideIn
+{
+    [self beginSlide];
+    if (kAnimationMode == RZNotificationAnimationModeTransform) {
+        // The frame goes to its final position once, only the transform is animated
+        [self placeToFinalPosition];
+        self.transform = [self hiddenTransform];
+    }
+}
+
+- (void) beginSlide
+{
+    if (_slideCount++ == 0 && kAnimationMode == RZNotificationAnimationModeTransform) {
+        self.layer.rasterizationScale = [[UIScreen mainScreen] scale];
+        self.layer.shouldRasterize = YES;
+    }
+}
+
+- (void) endSlide
+{
+    if (--_slideCount == 0) {
+        self.layer.shouldRasterize = NO;
+    }
+}
+
+// In an animation block
+- (void) slideToFinalPosition
+{
+    if (kAnimationMode == RZNotificationAnimationModeTransform) {
+        self.transform = CGAffineTransformIdentity;
+    }
+    else {
+        [self placeToFinalPosition];
+    }
+}
+
+// In an animation block
+- (void) slideToOrigin
+{
+    if (kAnimationMode == RZNotificationAnimationModeTransform) {
+        self.transform = [self hiddenTransform];
+    }
+    else {
+        [self placeToOrigin];
     }
-    
-    [self setYOrigin:yFinalOrigin];
 }
 
 - (void) show
+{
+    // The caller keeps this view to hide it, it is never merged into another one
+    [RZNotificationViewManager scheduleNotification:self coalesce:NO];
+}
+
+- (uint64_t) coalescingKey
+{
+    NSData *messageData = [_message dataUsingEncoding:NSUTF8StringEncoding];
+    uint64_t seed = RZNotificationHash64(((uint64_t)_icon << 32) ^ (uint64_t)_color ^ (uint64_t)[_customIcon hash]);
+    uint64_t key = RZNotificationHashBytes([messageData bytes], [messageData length], seed);
+    return key ? key : 1; // 0 means no coalescing
+}
+
+- (void) performShow
 {
     if (_customView) {
         CGFloat height = [_customView resizeForWidth:CGRectGetWidth(self.frame) - [self getOffsetXLeft] - [self getOffsetXRight]];
@@ -931,6 +1884,10 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     }
     
     self.hidden = YES;
+    if ([_container isKindOfClass:[RZNotificationWindow class]]) {
+        // Grown before placing, the origin of a bottom notification depends on the window height
+        [RZNotificationViewManager fitNotificationWindow:(RZNotificationWindow*)_container including:self];
+    }
     [self placeToOrigin];
     
     _isShowing = YES;
@@ -953,165 +1910,633 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
     else
     {
         NSAssert([_container respondsToSelector:@selector(addSubview:)], @"Your container should at least responds to `addSubview:`");
-        UIWindow *w = (UIWindow*)_container;
-        
-        if (self.context == RZNotificationContextAboveStatusBar) {
-            w.windowLevel = UIWindowLevelStatusBar + 1.0f;
-        }
-        else {
-            w.windowLevel = UIWindowLevelNormal;
-        }
-        
-        [w setSize:self.bounds.size];
-    
-        if (_position == RZNotificationPositionTop) {
-            [w setOrigin:CGPointZero];
-        }
-        else {
-            [w setOrigin:CGPointMake(0.0f, CGRectGetHeight(PPScreenBounds()) - CGRectGetHeight(w.bounds))];
-        }
-        
         [_container performSelector:@selector(addSubview:) withObject:self];
-        w.userInteractionEnabled = YES;
         self.userInteractionEnabled = YES;
     }
     
     if(_vibrate)
     {
         _hasVibrate = YES;
-        AudioServicesPlaySystemSound(kSystemSoundID_Vibrate);
+        [[RZNotificationSoundRegistry sharedRegistry] vibrate];
     }
     
     if(_sound)
     {
         _hasPlayedSound = YES;
-        AudioServicesPlaySystemSound (_soundFileObject);
+        [[RZNotificationSoundRegistry sharedRegistry] playSoundNamed:_sound];
     }
     
     [RZNotificationViewManager registerNotification:self];
+    [self recordLifecycleEvent:RZNotificationLifecycleEventAddedToHierarchy];
     
     self.hidden = NO;
-    [UIView animateWithDuration:0.4
-                     animations:^{
-                         [self placeToFinalPosition];
-                     }
-     ];
+    [self recordLifecycleEvent:RZNotificationLifecycleEventShowAnimationStarted];
+    [self beginSlideIn];
+    RZAnimateSlide(^{
+        [self slideToFinalPosition];
+    }, ^(BOOL finished) {
+        [self endSlide];
+        [self recordLifecycleEvent:RZNotificationLifecycleEventShowAnimationEnded];
+    });
     
     [self hideAfterDelay:_delay];
 }
 
-- (void) hide
+- (void) addMergedCompletion:(RZNotificationCompletion)completion
+{
+    if (!completion)
+        return;
+    if (!_mergedCompletions)
+        _mergedCompletions = [NSMutableArray array];
+    [_mergedCompletions addObject:[completion copy]];
+}
+
+// The completion of this notification, then the ones of the notifications merged into it
+- (void) callCompletions:(BOOL)touched
 {
     if (_completionBlock)
-        _completionBlock(_isTouch);
-    
-    _isTouch = NO;
+        _completionBlock(touched);
     
-    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(hide) object:nil];
+    NSArray *mergedCompletions = _mergedCompletions;
+    _mergedCompletions = nil;
+    for (RZNotificationCompletion completion in mergedCompletions) {
+        completion(touched);
+    }
+}
+
+- (void) hide
+{
+    if ([self beginHide] != RZNotificationHideStepAnimate)
+        return;
     
-    [UIView animateWithDuration:0.4
-                     animations:^{
-                         [self placeToOrigin];
-                     }
-                     completion:^(BOOL finished) {
-                         [self removeFromSuperview];
-                         [RZNotificationViewManager removeNotification:self];
-                         _isShowing = NO;
-                     }];
+    [self recordLifecycleEvent:RZNotificationLifecycleEventHideAnimationStarted];
+    [self beginSlide];
+    RZAnimateSlide(^{
+        [self slideToOrigin];
+    }, ^(BOOL finished) {
+        [self endSlide];
+        [self recordLifecycleEvent:RZNotificationLifecycleEventHideAnimationEnded];
+        [RZNotificationViewManager removeNotification:self];
+        [self finishHide];
+    });
 }
 
-- (void) hideAfterDelay:(NSTimeInterval)delay
+- (RZNotificationHideStep) beginHide
 {
-    if(0.0 < delay)
-    {
-        [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(hide) object:nil];
-        [self performSelector:@selector(hide) withObject:nil afterDelay:delay];
+    if (_isHiding)
+        return RZNotificationHideStepNone;
+    
+    [self recordLifecycleEvent:RZNotificationLifecycleEventHideRequested];
+    
+    if ([RZNotificationViewManager cancelScheduledNotification:self]) {
+        // Never shown, still waiting in the queue
+        [self callCompletions:NO];
+        if (_reusable) {
+            [RZNotificationViewManager enqueueReusableNotification:self];
+        }
+        [self recordEvent:RZNotificationEventHide];
+        return RZNotificationHideStepCancelled;
     }
+    
+    _isHiding = YES;
+    [self recordEvent:RZNotificationEventHide];
+    
+    [self callCompletions:_isTouch];
+    
+    _isTouch = NO;
+    
+    [RZNotificationViewManager cancelHideOfNotification:self];
+    return RZNotificationHideStepAnimate;
 }
 
-- (void) adjustHeightAndRedraw:(CGFloat)height
+// Called once the view is out of the screen and removed from the registry
+- (void) finishHide
 {
-    CGRect frame = self.frame;
+    [self removeFromSuperview];
+    self.transform = CGAffineTransformIdentity;
+    [self recordLifecycleEvent:RZNotificationLifecycleEventRemoved];
+    _isShowing = NO;
+    _isHiding = NO;
+    [RZNotificationViewManager notificationDidHide:self];
     
-    if (_context == RZNotificationContextBelowStatusBar && _position == RZNotificationPositionTop) {
-        _topOffset = PPStatusBarHeight() / 2.0f;
+    if (_reusable) {
+        [RZNotificationViewManager enqueueReusableNotification:self];
     }
-    else {
-        _topOffset = 0.0f;
+}
+
+- (void) recordLifecycleEvent:(RZNotificationLifecycleEvent)event
+{
+    RZNotificationTraceInstant((RZNotificationTraceEvent)event, RZRegistryKey(self));
+    
+    id<RZNotificationViewMetricsObserver> observer = sMetricsObserver;
+    if (observer) {
+        [observer notificationView:self didReachLifecycleEvent:event atTime:CACurrentMediaTime()];
     }
+}
+
+// What the app asked for, to replay it without UIKit
+- (void) recordEvent:(RZNotificationEventType)type
+{
+    if (!sEventRecordingEnabled)
+        return;
     
-    UIView *view = nil;
-    if ([_container isKindOfClass:[UIViewController class]]) {
-        view = [(UIViewController*)_container view];
+    RZNotificationEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.notification = RZRegistryKey(self);
+    event.container = RZRegistryKey(_container);
+    if (type == RZNotificationEventShow) {
+        event.coalescingKey = [self coalescingKey];
+        event.priority = (int)_priority;
+        event.bottom = (_position == RZNotificationPositionBottom);
+        event.duration = _delay;
+        event.width = CGRectGetWidth(self.frame);
+        event.height = CGRectGetHeight(self.frame);
     }
-    else {
-        view = (UIView*)_container;
+    else if (type == RZNotificationEventHide && sHidingExpiredNotifications) {
+        event.flags = RZNotificationEventFlagExpired;
     }
-    
-    if (_position == RZNotificationPositionTop) {
-        if (_context != RZNotificationContextTopMostController) {
-            if (@available(iOS 11.0, *)) {
-                _safeTopInset = view.safeAreaInsets.top;
-            }
-            if (self.context == RZNotificationContextBelowStatusBar) {
-                _safeTopInset -= PPStatusBarHeight();
-            }
-        }
+    [RZNotificationViewManager recordEvent:&event];
+}
+
+- (void) hideAfterDelay:(NSTimeInterval)delay
+{
+    if(0.0 < delay)
+    {
+        [RZNotificationViewManager scheduleHideOfNotification:self afterDelay:delay];
+    }
+}
+
+- (void) adjustHeightAndRedraw:(CGFloat)height
+{
+    if (_batchUpdateDepth > 0) {
+        _pendingContentHeight = height;
+        _needsHeightAdjustment = YES;
+        return;
+    }
+    
+    CGRect frame = self.frame;
+    
+    RZNotificationInsetsInput insets;
+    memset(&insets, 0, sizeof(insets));
+    insets.bottom = (_position == RZNotificationPositionBottom);
+    insets.belowStatusBar = (_context == RZNotificationContextBelowStatusBar);
+    insets.topMostController = (_context == RZNotificationContextTopMostController);
+    insets.statusBarHeight = PPStatusBarHeight();
+    if (@available(iOS 11.0, *)) {
+        UIEdgeInsets safeAreaInsets = [self containerSafeAreaInsets];
+        insets.containerSafeTopInset = safeAreaInsets.top;
+        insets.containerSafeBottomInset = safeAreaInsets.bottom;
+    }
+    
+    RZNotificationLayoutInput input = [self layoutInputForBounds:self.bounds];
+    RZNotificationLayoutApplyInsets(&insets, &input);
+    _topOffset = input.topOffset;
+    _safeTopInset = input.safeTopInset;
+    _safeBottomInset = input.safeBottomInset;
+    
+    frame.size.height = RZNotificationLayoutHeightForContentHeight(&input, height, kMinHeight);
+    BOOL resized = !CGSizeEqualToSize(frame.size, self.frame.size);
+    if (_isUpdatingInPlace && resized) {
+        [self animateHeightChangeToFrame:frame];
     }
     else {
-        if (@available(iOS 11.0, *)) {
-            _safeBottomInset = view.safeAreaInsets.bottom;
+        self.frame = frame;
+        if (resized) {
+            [RZNotificationViewManager fitWindowOfNotification:self];
+        }
+    }
+    [self recordLifecycleEvent:RZNotificationLifecycleEventMeasured];
+    [self invalidateLayout];
+    // The background does not depend on the text
+    if (resized || !_isUpdatingInPlace) {
+        [self setNeedsDisplay];
+    }
+    [RZNotificationViewManager resizeStackedNotification:self];
+    [RZNotificationViewManager updateMemoryOfNotification:self];
+}
+
+// Hidden rather than transparent, the alpha belongs to the app
+- (void) setStackHidden:(BOOL)stackHidden
+{
+    if (_stackHidden == stackHidden)
+        return;
+    _stackHidden = stackHidden;
+    self.hidden = stackHidden;
+}
+
+#pragma mark - In place updates
+
++ (RZNotificationView*) showOrUpdateNotification:(RZNotificationDescription*)description identifier:(NSString*)identifier withCompletion:(RZNotificationCompletion)completionBlock
+{
+    NSAssert(description, @"`description should not be nil`");
+    NSAssert(identifier, @"`identifier should not be nil`");
+    RZNotificationView *notification = [RZNotificationViewManager notificationWithIdentifier:identifier];
+    if (notification) {
+        [notification updateWithDescription:description];
+        if (completionBlock) {
+            notification.completionBlock = completionBlock;
         }
+        return notification;
     }
     
-    frame.size.height = MAX(kMinHeight , height + 2.0f*kDefaultContentMarginHeight + _topOffset + _safeBottomInset + _safeTopInset);
-    self.frame = frame;
-    [self setNeedsDisplay];
+    id<RZNotificationViewManagerProtocol> container = [self containerForContext:description.context position:description.position];
+    notification = [self reusableNotificationWithDescription:description container:container completion:completionBlock];
+    notification.notificationIdentifier = identifier;
+    
+    // Its content changes with each update, it can neither be merged nor merge others
+    [RZNotificationViewManager scheduleNotification:notification coalesce:NO];
+    [RZNotificationViewManager setNotification:notification forIdentifier:identifier];
+    return notification;
 }
 
-#pragma mark - Rotation handling
++ (RZNotificationView*) notificationWithIdentifier:(NSString*)identifier
+{
+    return [RZNotificationViewManager notificationWithIdentifier:identifier];
+}
 
-- (void) deviceOrientationDidChange:(NSNotification*)notification
+// Visible or waiting to be shown, and not hiding
+- (BOOL) isLive
 {
-    if(self.superview){
-        if ([_container isKindOfClass:[UIViewController class]]) {
-            UIViewController *c = (UIViewController*)_container;
+    return !_isHiding && (_isShowing || _scheduledIdentifier != 0);
+}
 
-            UIDevice *device = (UIDevice*)notification.object;
-            if ([c shouldAutorotate] && (RZOrientationMaskContainsOrientation([c supportedInterfaceOrientations], device.orientation))) {
-                if(_textLabel){
-                    self.message = _message;
-                }
-                else{
-                    CGFloat height = [_customView resizeForWidth:CGRectGetWidth(self.frame) - [self getOffsetXLeft] - [self getOffsetXRight]];
-                    [self adjustHeightAndRedraw:height];
-                }
-                
-                CGRect frame = self.frame;
-                CGFloat yOrigin = 0.0f;
-                
-                if (_position == RZNotificationPositionTop) {
-                    yOrigin = [self _getFinalOriginForPosition:_position];
-                }
-                else {
-                    yOrigin = [self _getFinalOriginForPosition:_position]-CGRectGetHeight(self.frame);
-                }
-                
-                frame.origin.y = yOrigin;
-                
-                if (c.view.frame.size.width != 0)
-                    frame.size.width = c.view.frame.size.width;
-                self.frame = frame;
-                
-                _highlightedView.frame = self.bounds;
+- (void) updateWithDescription:(RZNotificationDescription*)description
+{
+    BOOL visible = _isShowing;
+    _isUpdatingInPlace = visible;
+    
+    // Only the changed properties are set, each setter re-renders its part
+    [self performBatchUpdates:^{
+        CGFloat textWidth = CGRectGetWidth(self.frame) - [self getOffsetXLeft] - [self getOffsetXRight];
+        
+        if (description.icon == RZNotificationIconCustom) {
+            if (_icon != RZNotificationIconCustom || ![description.customIcon isEqualToString:_customIcon]) {
+                self.customIcon = description.customIcon;
             }
         }
-        else
-        {
-            // TODO: handle rotation for window
-            NSLog(@"Handle rotation: TODO :/");
+        else if (_icon != description.icon) {
+            self.icon = description.icon;
+        }
+        if (_anchor != description.anchor) {
+            self.anchor = description.anchor;
+        }
+        if (_color != description.color) {
+            self.color = description.color;
+        }
+        if (_assetColor != description.assetColor) {
+            self.assetColor = description.assetColor;
+        }
+        if (_textColor != description.textColor) {
+            self.textColor = description.textColor;
+        }
+        // Played at most once, when shown
+        self.sound = description.sound;
+        self.vibrate = description.vibrate;
+        
+        // Showing or removing the icon or the anchor changes the width of the text
+        BOOL widthChanged = textWidth != CGRectGetWidth(self.frame) - [self getOffsetXLeft] - [self getOffsetXRight];
+        if (_messageMaxLenght != description.messageMaxLenght) {
+            self.messageMaxLenght = description.messageMaxLenght;
+        }
+        if (widthChanged || !_textLabel.superview || ![_message isEqualToString:description.message]) {
+            [self setMessage:description.message];
+        }
+    }];
+    
+    if (_priority != description.priority) {
+        self.priority = description.priority;
+        [RZNotificationViewManager updatePriorityOfNotification:self];
+    }
+    _isUpdatingInPlace = NO;
+    
+    _delay = description.duration;
+    if (!visible) {
+        // Still waiting, the hide delay starts once shown
+        return;
+    }
+    if (_delay > 0.0) {
+        [self hideAfterDelay:_delay];
+    }
+    else {
+        [RZNotificationViewManager cancelHideOfNotification:self];
+    }
+    [RZNotificationViewManager updateMemoryOfNotification:self];
+}
+
+// Only the height changes, the content follows the new bounds
+- (void) animateHeightChangeToFrame:(CGRect)frame
+{
+    [UIView animateWithDuration:kAnimationDuration
+                          delay:0.0
+                        options:kAnimationOptions | UIViewAnimationOptionBeginFromCurrentState
+                     animations:^{
+                         self.frame = frame;
+                         [RZNotificationViewManager fitWindowOfNotification:self];
+                         [self placeToFinalPosition];
+                         [self invalidateLayout];
+                         [self layoutIfNeeded];
+                     }
+                     completion:nil];
+}
+
+#pragma mark - Reuse
+
+- (void) prepareForReuse
+{
+    [RZNotificationViewManager cancelHideOfNotification:self];
+    
+    _completionBlock = nil;
+    _mergedCompletions = nil;
+    _isTouch = NO;
+    _isShowing = NO;
+    _isHiding = NO;
+    _scheduledIdentifier = 0;
+    _repeatCount = 0;
+    _priority = 0;
+    _notificationIdentifier = nil;
+    
+    // Custom view and text
+    if (_customView) {
+        [_customView removeFromSuperview];
+        if ([_customView isKindOfClass:[UIControl class]]) {
+            [((UIControl *)_customView) removeTarget:self action:@selector(handleTouch) forControlEvents:UIControlEventTouchUpInside];
         }
+        _customView = nil;
+    }
+    _message = nil;
+    _messageMaxLenght = 0;
+    _textLabel.text = nil;
+    _labelFont = RZDefaultLabelFont();
+    _textLabel.font = _labelFont;
+    
+    // Colors and icon
+    _customTopColor = nil;
+    _customBottomColor = nil;
+    _customIcon = nil;
+    
+    // Style
+    _resolvedStyle = nil;
+    _styleContentMarginHeight = -1.0f;
+    
+    // Sound and vibration
+    [[RZNotificationSoundRegistry sharedRegistry] releaseSoundNamed:_sound];
+    _soundFileObject = 0;
+    _sound = nil;
+    _vibrate = kDefaultVibrate;
+    _hasPlayedSound = NO;
+    _hasVibrate = NO;
+    
+    // Highlight overlay
+    [_highlightedView removeFromSuperview];
+    [super setHighlighted:NO];
+    
+    // Label, back to its init values. The rendering mode is reset by -setupWithIcon:...
+    _textLabel.textColor = [UIColor blackColor];
+    _iconView.image = nil;
+    _anchorView.image = nil;
+    _needsAppearanceUpdate = YES;
+    
+    // Context and geometry
+    _container = nil;
+    self.contextController = nil;
+    _context = RZNotificationContextTopMostController;
+    _topOffset = 0.0f;
+    _safeTopInset = 0.0f;
+    _safeBottomInset = 0.0f;
+    _hasLayout = NO;
+    self.transform = CGAffineTransformIdentity;
+    _stackHidden = NO;
+    self.hidden = NO;
+}
+
++ (void) registerReusePoolSize:(NSUInteger)poolSize
+{
+    kReusePoolSize = poolSize;
+}
+
++ (NSUInteger) numberOfAllocatedNotifications
+{
+    return sAllocatedNotifications;
+}
+
++ (NSUInteger) numberOfReusedNotifications
+{
+    return sReusedNotifications;
+}
+
++ (NSUInteger) numberOfReusableNotifications
+{
+    return [RZNotificationViewManager numberOfReusableNotifications];
+}
+
+#pragma mark - Memory
+
+static size_t RZImageMemoryBytes(UIImage *image)
+{
+    CGImageRef cgImage = image.CGImage;
+    return cgImage ? CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage) : 0;
+}
+
+static size_t RZViewMemoryBytes(UIView *view, CGFloat scale)
+{
+    return RZNotificationMemoryBitmapBytes(CGRectGetWidth(view.bounds), CGRectGetHeight(view.bounds), scale);
+}
+
+// The bitmaps this view keeps alive, an estimate: images shared with other views are counted for each of them
+- (size_t) estimatedMemoryBytes
+{
+    CGFloat scale = [[UIScreen mainScreen] scale];
+    size_t bytes = 0;
+    
+    // The layer backed rendering has no backing store, see `respondsToSelector:`
+    if (_backgroundRendering == RZNotificationBackgroundRenderingDrawRect) {
+        bytes += RZViewMemoryBytes(self, scale);
+    }
+    if (_textLabel.superview && [_textLabel.text length] > 0) {
+        bytes += RZViewMemoryBytes(_textLabel, scale);
+    }
+    if ([_customView isKindOfClass:[UIView class]]) {
+        bytes += RZViewMemoryBytes((UIView *)_customView, scale);
+    }
+    if (_iconView.superview) {
+        bytes += RZImageMemoryBytes(_iconView.image);
+    }
+    if (_anchorView.superview) {
+        bytes += RZImageMemoryBytes(_anchorView.image);
+    }
+    if (_highlightedView.superview) {
+        bytes += RZViewMemoryBytes(_highlightedView, scale);
+    }
+    return bytes;
+}
+
+// The overlay is kept after the first highlight, drop it when it is not on screen
+- (void) releaseUnusedHighlightOverlay
+{
+    if (_highlightedView && !_highlightedView.superview) {
+        _highlightedView = nil;
+    }
+}
+
++ (void) registerMemoryBudget:(NSUInteger)bytes
+{
+    kMemoryBudget = bytes;
+    [RZNotificationViewManager updateMemoryBudget];
+}
+
++ (NSUInteger) estimatedMemoryUsage
+{
+    return [RZNotificationViewManager memoryUsage];
+}
+
++ (NSUInteger) numberOfMemoryEvictions
+{
+    return sMemoryEvictions;
+}
+
+#pragma mark - Scheduling
+
++ (void) registerMaxVisibleNotifications:(NSUInteger)maxVisible
+{
+    kMaxVisibleNotifications = maxVisible;
+    [RZNotificationViewManager updateSchedulerConfiguration];
+}
+
++ (void) registerRateLimit:(double)notificationsPerSecond burst:(NSUInteger)burst
+{
+    kRateLimitPerSecond = MAX(0.0, notificationsPerSecond);
+    kRateLimitBurst = MAX((NSUInteger)1, burst);
+    [RZNotificationViewManager updateSchedulerConfiguration];
+}
+
++ (void) registerCoalescing:(BOOL)coalesce
+{
+    kCoalesceNotifications = coalesce;
+    [RZNotificationViewManager updateSchedulerConfiguration];
+}
+
+#pragma mark - Stacking
+
++ (void) registerLayoutMode:(RZNotificationLayoutMode)layoutMode
+{
+    kLayoutMode = layoutMode;
+}
+
++ (void) registerStackSpacing:(CGFloat)spacing maxVisible:(NSUInteger)maxVisible
+{
+    kStackSpacing = MAX(0.0f, spacing);
+    kStackMaxVisible = maxVisible;
+    [RZNotificationViewManager updateStackConfiguration];
+}
+
+#pragma mark - Animations
+
++ (void) registerAnimationMode:(RZNotificationAnimationMode)animationMode
+{
+    kAnimationMode = animationMode;
+}
+
++ (void) registerAnimationDuration:(NSTimeInterval)duration options:(UIViewAnimationOptions)options
+{
+    kAnimationDuration = MAX(0.0, duration);
+    kAnimationOptions = options;
+}
+
++ (void) registerAnimationSpringDamping:(CGFloat)damping initialVelocity:(CGFloat)velocity
+{
+    kAnimationSpringDamping = MIN(MAX(0.0f, damping), 1.0f);
+    kAnimationSpringVelocity = velocity;
+}
+
+#pragma mark - Sounds
+
++ (void) preloadSounds:(NSArray*)soundNames
+{
+    [[RZNotificationSoundRegistry sharedRegistry] preloadSounds:soundNames];
+}
+
++ (void) registerSoundThrottleInterval:(NSTimeInterval)interval
+{
+    [RZNotificationSoundRegistry sharedRegistry].throttleInterval = MAX(0.0, interval);
+}
+
+#pragma mark - Metrics
+
++ (void) registerMetricsObserver:(id<RZNotificationViewMetricsObserver>)observer
+{
+    sMetricsObserver = observer;
+}
+
++ (void) setTracingEnabled:(BOOL)enabled capacity:(NSUInteger)capacity
+{
+    RZNotificationTraceBuffer *buffer = enabled ? [RZNotificationViewManager traceBufferWithCapacity:capacity] : NULL;
+    RZNotificationTraceInstallBuffer(buffer);
+}
+
++ (BOOL) writeTraceToPath:(NSString*)path
+{
+    RZNotificationTraceBuffer *buffer = [RZNotificationViewManager traceBuffer];
+    FILE *file = buffer ? fopen([path fileSystemRepresentation], "w") : NULL;
+    if (!file)
+        return NO;
+    
+    BOOL written = RZNotificationTraceBufferWriteChromeJSON(buffer, file);
+    return (fclose(file) == 0) && written;
+}
+
++ (void) setEventRecordingEnabled:(BOOL)enabled
+{
+    sEventRecordingEnabled = enabled && [RZNotificationViewManager eventLog] != NULL;
+}
+
++ (BOOL) writeEventLogToPath:(NSString*)path
+{
+    RZNotificationEventLog *log = [RZNotificationViewManager eventLog];
+    FILE *file = log ? fopen([path fileSystemRepresentation], "wb") : NULL;
+    if (!file)
+        return NO;
+    
+    BOOL written = RZNotificationEventLogWrite(log, file);
+    return (fclose(file) == 0) && written;
+}
+
++ (void) resetMetrics
+{
+    RZNotificationTraceBuffer *buffer = [RZNotificationViewManager traceBuffer];
+    if (buffer)
+        RZNotificationTraceBufferClear(buffer);
+    RZNotificationTraceResetCounters();
+    RZNotificationEventLog *log = [RZNotificationViewManager eventLog];
+    if (log)
+        RZNotificationEventLogClear(log);
+}
+
++ (NSInteger) valueForCounter:(RZNotificationCounter)counter
+{
+    return RZNotificationTraceCounterValue((RZNotificationTraceCounter)counter);
+}
+
+#pragma mark - Rotation handling
+
+// Called by the manager once per rotation, with the container width
+- (void) relayoutForWidth:(CGFloat)width
+{
+    // Width first, the text is measured for it
+    CGRect frame = self.frame;
+    frame.size.width = width;
+    self.frame = frame;
+    
+    if(_textLabel){
+        self.message = _message;
+    }
+    else{
+        CGFloat height = [_customView resizeForWidth:CGRectGetWidth(self.frame) - [self getOffsetXLeft] - [self getOffsetXRight]];
+        [self adjustHeightAndRedraw:height];
     }
+    
+    [self placeToFinalPosition];
+    _highlightedView.frame = self.bounds;
 }
 
 #pragma mark - Touches
@@ -1119,6 +2544,7 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 {
     if(!_isTouch){
         _isTouch = YES;
+        [self recordEvent:RZNotificationEventTouch];
         
         if(_delay == 0.0){
             if (_completionBlock){
@@ -1133,6 +2559,25 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 
 #pragma mark - UIControl methods
 
+- (BOOL) beginTrackingWithTouch:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    // Do not hide under the finger
+    [RZNotificationViewManager pauseHideOfNotification:self];
+    return [super beginTrackingWithTouch:touch withEvent:event];
+}
+
+- (void) endTrackingWithTouch:(UITouch *)touch withEvent:(UIEvent *)event
+{
+    [super endTrackingWithTouch:touch withEvent:event];
+    [RZNotificationViewManager resumeHideOfNotification:self];
+}
+
+- (void) cancelTrackingWithEvent:(UIEvent *)event
+{
+    [super cancelTrackingWithEvent:event];
+    [RZNotificationViewManager resumeHideOfNotification:self];
+}
+
 - (void) setHighlighted:(BOOL)highlighted
 {
     // Do nothing if no completion block
@@ -1152,14 +2597,13 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
         {
             [_highlightedView removeFromSuperview];
         }
+        [RZNotificationViewManager updateMemoryOfNotification:self];
     }
 }
 
 - (void) dealloc
 {
-    [[NSNotificationCenter defaultCenter] removeObserver:self name:UIDeviceOrientationDidChangeNotification object:nil];
-    
-    AudioServicesDisposeSystemSoundID(_soundFileObject);
+    [[RZNotificationSoundRegistry sharedRegistry] releaseSoundNamed:_sound];
 }
 
 #pragma mark - deprecated
@@ -1259,96 +2703,1348 @@ static BOOL RZOrientationMaskContainsOrientation(UIInterfaceOrientationMask mask
 
 @end
 
+#pragma mark - Prepared notifications
 
-#pragma mark - Notification Manager
-
-@implementation UIViewController (RZNotificationViewManager)
-static char rzNotificationsKey;
+@implementation RZNotificationDescription
 
-- (void)setRzNotifications:(NSMutableArray *)rzNotifications
++ (instancetype) descriptionWithMessage:(NSString*)message context:(RZNotificationContext)context
 {
-    objc_setAssociatedObject(self,
-                             &rzNotificationsKey,
-                             rzNotifications,
-                             OBJC_ASSOCIATION_RETAIN);
+    RZNotificationDescription *description = [[self alloc] init];
+    description.message = message;
+    description.context = context;
+    return description;
 }
 
-- (NSMutableArray *) rzNotifications {
-    id notifications = objc_getAssociatedObject(self,
-                                             &rzNotificationsKey);
-    
-    if (!notifications)
+- (id) init
+{
+    self = [super init];
+    if (self)
     {
-        notifications = [NSMutableArray array];
-        self.rzNotifications = notifications;
+        _context = RZNotificationContextTopMostController;
+        _icon = kDefaultIcon;
+        _anchor = kDefaultAnchor;
+        _position = kDefaultPosition;
+        _color = kDefaultColor;
+        _assetColor = kDefaultAssetColor;
+        _textColor = kDefaultTextColor;
+        _duration = kDefaultDuration;
+        _vibrate = kDefaultVibrate;
     }
-    return notifications;
+    return self;
+}
+
+- (id) copyWithZone:(NSZone *)zone
+{
+    RZNotificationDescription *copy = [[[self class] allocWithZone:zone] init];
+    copy.message = _message;
+    copy.context = _context;
+    copy.icon = _icon;
+    copy.customIcon = _customIcon;
+    copy.anchor = _anchor;
+    copy.position = _position;
+    copy.color = _color;
+    copy.assetColor = _assetColor;
+    copy.textColor = _textColor;
+    copy.duration = _duration;
+    copy.priority = _priority;
+    copy.sound = _sound;
+    copy.vibrate = _vibrate;
+    copy.messageMaxLenght = _messageMaxLenght;
+    return copy;
 }
 
 @end
 
-@implementation UIWindow (RZNotificationViewManager)
-static char rzNotificationsKey;
+@implementation RZNotificationStyle
 
-- (void)setRzNotifications:(NSMutableArray *)rzNotifications
+- (id) init
 {
-    objc_setAssociatedObject(self,
-                             &rzNotificationsKey,
-                             rzNotifications,
-                             OBJC_ASSOCIATION_RETAIN);
-}
-
-- (NSMutableArray *) rzNotifications {
-    id notifications = objc_getAssociatedObject(self,
-                                                &rzNotificationsKey);
-    
-    if (!notifications)
+    self = [super init];
+    if (self)
     {
-        notifications = [NSMutableArray array];
-        self.rzNotifications = notifications;
+        _icon = kDefaultIcon;
+        _anchor = kDefaultAnchor;
+        _position = kDefaultPosition;
+        _color = kDefaultColor;
+        _assetColor = kDefaultAssetColor;
+        _textColor = kDefaultTextColor;
+        _contentMarginHeight = -1.0f;
+        _duration = kDefaultDuration;
+        _vibrate = kDefaultVibrate;
     }
-    return notifications;
+    return self;
+}
+
+- (id) copyWithZone:(NSZone *)zone
+{
+    RZNotificationStyle *copy = [[[self class] allocWithZone:zone] init];
+    copy.color = _color;
+    copy.customTopColor = _customTopColor;
+    copy.customBottomColor = _customBottomColor;
+    copy.assetColor = _assetColor;
+    copy.textColor = _textColor;
+    copy.labelFont = _labelFont;
+    copy.icon = _icon;
+    copy.customIcon = _customIcon;
+    copy.anchor = _anchor;
+    copy.position = _position;
+    copy.contentMarginHeight = _contentMarginHeight;
+    copy.duration = _duration;
+    copy.sound = _sound;
+    copy.vibrate = _vibrate;
+    copy.messageMaxLenght = _messageMaxLenght;
+    return copy;
 }
 
 @end
 
-@implementation RZNotificationViewManager
+@implementation RZNotificationResolvedStyle
 
-+ (UIWindow *)notificationWindow
+- (id) initWithStyle:(RZNotificationStyle*)style
 {
-    static dispatch_once_t pred = 0;
-    __strong static UIWindow *_notificationWindow = nil;
-    dispatch_once(&pred, ^{
-        _notificationWindow = [[UIWindow alloc] initWithFrame:PPScreenBounds()];
-        _notificationWindow.hidden = YES;
-    });
-    return _notificationWindow;
+    self = [super init];
+    if (self)
+    {
+        // Nobody else holds the copy, the preset cannot change anymore
+        _style = [style copy];
+        _assetColor = RZResolvedAssetColor(_style.assetColor, _style.textColor);
+        
+        // Same colors as `backgroundStartColor` and `backgroundStrokeColor`
+        UIColor *customColor = _style.customTopColor ? _style.customTopColor : _style.customBottomColor;
+        if (customColor) {
+            _startColor = customColor;
+            _strokeColor = [UIColor lighterColorForColor:customColor withRgbOffset:0.1f];
+        }
+        else {
+            _startColor = RZPaletteColor(_style.color, RZNotificationPaletteRoleStart);
+            _strokeColor = RZPaletteColor(_style.color, RZNotificationPaletteRoleStroke);
+        }
+        
+        // Also kept in the image cache, but this reference survives its evictions
+        UIColor *tintColor = RZAssetTintColor(_assetColor);
+        if (tintColor) {
+            CGFloat scale = [[UIScreen mainScreen] scale];
+            _iconImage = RZTintedImageNamed(RZImageNameForIcon(_style.icon, _style.customIcon), _assetColor, tintColor, scale, self);
+            _anchorImage = RZTintedImageNamed(RZImageNameForAnchor(_style.anchor), _assetColor, tintColor, scale, self);
+            _hasImages = YES;
+        }
+        
+        if (_style.sound) {
+            [[RZNotificationSoundRegistry sharedRegistry] retainSoundNamed:_style.sound];
+        }
+    }
+    return self;
 }
 
-+ (void)registerNotification:(RZNotificationView *)notification
+- (void) dealloc
 {
-    NSAssert(notification, @"`notification should not be nil`");
-    [notification.container.rzNotifications addObject:notification];
-    
-    if ([notification.container isEqual:[self notificationWindow]]) {
-        [[self notificationWindow] setHidden:NO];
+    if (_style.sound) {
+        [[RZNotificationSoundRegistry sharedRegistry] releaseSoundNamed:_style.sound];
     }
 }
 
-+ (void)removeNotification:(RZNotificationView*)notification
+@end
+
+@implementation RZPreparedNotification
+
+// Called on a background queue: UIKit drawing, text measurement and the caches are thread safe, views are not
+- (id) initWithDescription:(RZNotificationDescription*)description container:(id<RZNotificationViewManagerProtocol>)container width:(CGFloat)width scale:(CGFloat)scale
 {
-    NSAssert(notification, @"`notification should not be nil`");
-    if ([notification.container.rzNotifications containsObject:notification]) {
-        [notification.container.rzNotifications removeObject:notification];
+    self = [super init];
+    if (self)
+    {
+        _notificationDescription = description;
+        _container = container;
+        
+        RZNotificationContentColor assetColor = RZResolvedAssetColor(description.assetColor, description.textColor);
+        NSString *iconName = RZImageNameForIcon(description.icon, description.customIcon);
+        NSString *anchorName = RZImageNameForAnchor(description.anchor);
+        
+        // Automatic asset colors are rendered by MOOMaskedIconView, on the main thread when shown
+        UIColor *tintColor = RZAssetTintColor(assetColor);
+        if (tintColor) {
+            _iconImage = RZTintedImageNamed(iconName, assetColor, tintColor, scale, self);
+            _anchorImage = RZTintedImageNamed(anchorName, assetColor, tintColor, scale, self);
+        }
+        
+        RZNotificationLayoutInput input;
+        memset(&input, 0, sizeof(input));
+        input.bounds.width = width;
+        input.hasIcon = iconName != nil;
+        input.hasAnchor = anchorName != nil;
+        input.offsetX = kDefaultOffsetX;
+        input.iconWidth = kIconWidth;
+        input.iconHeight = kIconHeight;
+        _messageHeight = [self measureMessage:description.message
+                                        width:RZNotificationLayoutContentWidth(&input)
+                                    maxLength:description.messageMaxLenght ? description.messageMaxLenght : kDefaultMaxMessageLength];
+        
+        if (description.sound) {
+            _soundID = [[RZNotificationSoundRegistry sharedRegistry] retainSoundNamed:description.sound];
+        }
+    }
+    return self;
+}
+
+- (void) dealloc
+{
+    // The shown notification took its own reference
+    if (_soundID) {
+        [[RZNotificationSoundRegistry sharedRegistry] releaseSoundNamed:_notificationDescription.sound];
+    }
+}
+
+- (CGFloat) measureMessage:(NSString *)message width:(CGFloat)width maxLength:(NSInteger)maxLength
+{
+    UIFont *font = RZDefaultLabelFont();
+    
+    // Same key and same measurement as `-[RZNotificationView setMessage:]`
+    return [[RZNotificationTextMeasurementCache sharedCache] heightForMessage:message
+                                                                         font:font
+                                                                        width:width
+                                                                    maxLength:maxLength
+                                                                 measureBlock:^CGFloat{
+                                                                     if (!message)
+                                                                         return 0.0f;
+                                                                     
+                                                                     RZNotificationTraceCounterAdd(RZNotificationTraceCounterTextMeasurements, 1);
+                                                                     double traceBegin = RZTraceIntervalBegin(RZNotificationTraceEventTextMeasurement, self);
+                                                                     CGFloat height = RZMeasuredTextHeight(RZTruncatedMessage(message, maxLength), font, width);
+                                                                     RZTraceIntervalEnd(RZNotificationTraceEventTextMeasurement, self, traceBegin);
+                                                                     return height;
+                                                                 }];
+}
+
+@end
+
+#pragma mark - Notification Manager
+
+@implementation UIViewController (RZNotificationViewManager)
+@end
+
+@implementation UIWindow (RZNotificationViewManager)
+@end
+
+@implementation RZNotificationWindow
+
+- (id) initWithContext:(RZNotificationContext)context position:(RZNotificationPosition)position
+{
+    CGRect screen = PPScreenBounds();
+    CGFloat y = (position == RZNotificationPositionTop) ? 0.0f : CGRectGetHeight(screen);
+    self = [super initWithFrame:CGRectMake(0.0f, y, CGRectGetWidth(screen), 0.0f)];
+    if (self) {
+        _context = context;
+        _position = position;
+        self.windowLevel = (context == RZNotificationContextAboveStatusBar) ? UIWindowLevelStatusBar + 1.0f : UIWindowLevelNormal;
+        self.hidden = YES;
+    }
+    return self;
+}
+
+// A full screen application window sharing the screen, and the scene when there is one. nil when none exists yet
+- (UIWindow *) screenWindow
+{
+    NSArray *windows = [[UIApplication sharedApplication] windows];
+    if (@available(iOS 13.0, *)) {
+        if (self.windowScene)
+            windows = self.windowScene.windows;
+    }
+    for (UIWindow *window in windows) {
+        if ([window isKindOfClass:[RZNotificationWindow class]] || window.screen != self.screen)
+            continue;
+        if (CGRectEqualToRect(window.bounds, window.screen.bounds))
+            return window;
+    }
+    return nil;
+}
+
+@end
+
+static double RZMediaTime(void *context)
+{
+    return CACurrentMediaTime();
+}
+
+static RZNotificationSchedulerConfig RZCurrentSchedulerConfig(void)
+{
+    RZNotificationSchedulerConfig config = RZNotificationSchedulerDefaultConfig();
+    config.maxVisible = (unsigned)kMaxVisibleNotifications;
+    config.ratePerSecond = kRateLimitPerSecond;
+    config.burst = (double)kRateLimitBurst;
+    config.coalesce = kCoalesceNotifications;
+    config.clock.now = RZMediaTime;
+    config.clock.context = NULL;
+    return config;
+}
+
+/**
+ *  Show queue of a container, wraps a RZNotificationScheduler
+ */
+@interface RZNotificationContainerQueue : NSObject
+{
+@public
+    RZNotificationScheduler *_scheduler;
+    NSMutableDictionary *_notifications; // Scheduled identifier -> notification, pending or visible
+    BOOL _drainScheduled;
+}
+@end
+
+@implementation RZNotificationContainerQueue
+
+- (id) init
+{
+    self = [super init];
+    if (self)
+    {
+        RZNotificationSchedulerConfig config = RZCurrentSchedulerConfig();
+        _scheduler = RZNotificationSchedulerCreate(&config);
+        _notifications = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (void) dealloc
+{
+    RZNotificationSchedulerDestroy(_scheduler);
+}
+
+@end
+
+/**
+ *  A show request submitted from any thread, see `+submitNotification:withCompletion:`
+ */
+@interface RZNotificationRequest : NSObject
+{
+@public
+    RZNotificationDescription *_description;
+    RZNotificationCompletion _completion;
+}
+@end
+
+@implementation RZNotificationRequest
+@end
+
+/**
+ *  Stacked notifications of a container, one RZNotificationStack per edge
+ */
+@interface RZNotificationContainerStacks : NSObject
+{
+@public
+    RZNotificationStack *_top;
+    RZNotificationStack *_bottom;
+}
+@end
+
+@implementation RZNotificationContainerStacks
+
+- (id) init
+{
+    self = [super init];
+    if (self)
+    {
+        _top = RZNotificationStackCreate(kStackSpacing, (unsigned)kStackMaxVisible);
+        _bottom = RZNotificationStackCreate(kStackSpacing, (unsigned)kStackMaxVisible);
+    }
+    return self;
+}
+
+- (void) dealloc
+{
+    RZNotificationStackDestroy(_top);
+    RZNotificationStackDestroy(_bottom);
+}
+
+@end
+
+@implementation RZNotificationViewManager
+
++ (NSMutableDictionary *)notificationWindows
+{
+    static dispatch_once_t pred = 0;
+    __strong static NSMutableDictionary *_notificationWindows = nil;
+    dispatch_once(&pred, ^{
+        _notificationWindows = [NSMutableDictionary dictionary];
+    });
+    return _notificationWindows;
+}
+
++ (RZNotificationWindow *)notificationWindowForContext:(RZNotificationContext)context position:(RZNotificationPosition)position
+{
+    NSNumber *key = @((context << 1) | position);
+    RZNotificationWindow *window = [[self notificationWindows] objectForKey:key];
+    if (!window) {
+        window = [[RZNotificationWindow alloc] initWithContext:context position:position];
+        [[self notificationWindows] setObject:window forKey:key];
+    }
+    return window;
+}
+
+// The union of the notifications shown, against the edge of the screen. Only changed when it has to
++ (void)fitNotificationWindow:(RZNotificationWindow *)window including:(RZNotificationView *)notification
+{
+    NSArray *shown = [self allNotificationsForContainer:window];
+    double *extents = malloc(([shown count] + 1) * sizeof(double));
+    size_t count = 0;
+    if (notification) {
+        extents[count++] = CGRectGetHeight(notification.frame);
+    }
+    for (RZNotificationView *other in shown) {
+        // Stacked past the max visible
+        if ([self isStackVisibleNotification:other]) {
+            extents[count++] = [self stackOffsetOfNotification:other] + CGRectGetHeight(other.frame);
+        }
+    }
+    
+    CGRect screen = PPScreenBounds();
+    CGRect frame = CGRectFromRZNotificationRect(RZNotificationLayoutWindowFrame(CGRectGetWidth(screen), CGRectGetHeight(screen), window.position == RZNotificationPositionBottom, extents, count));
+    free(extents);
+    if (!CGRectEqualToRect(frame, window.frame)) {
+        window.frame = frame;
+    }
+}
+
++ (void)fitWindowOfNotification:(RZNotificationView *)notification
+{
+    id<RZNotificationViewManagerProtocol> container = notification.container;
+    if ([container isKindOfClass:[RZNotificationWindow class]] && [[self registeredNotifications] containsObject:notification]) {
+        [self fitNotificationWindow:(RZNotificationWindow*)container including:nil];
+    }
+}
+
++ (void)fitNotificationWindows
+{
+    for (RZNotificationWindow *window in [[self notificationWindows] objectEnumerator]) {
+        if (!window.hidden) {
+            [self fitNotificationWindow:window including:nil];
+        }
+    }
+}
+
++ (RZNotificationRegistry *)registry
+{
+    static dispatch_once_t pred = 0;
+    static RZNotificationRegistry *_registry = NULL;
+    dispatch_once(&pred, ^{
+        _registry = RZNotificationRegistryCreate();
+    });
+    return _registry;
+}
+
++ (NSMutableSet *)registeredNotifications
+{
+    // The registry only stores keys, this keeps the registered notifications alive
+    static dispatch_once_t pred = 0;
+    __strong static NSMutableSet *_registeredNotifications = nil;
+    dispatch_once(&pred, ^{
+        _registeredNotifications = [NSMutableSet set];
+    });
+    return _registeredNotifications;
+}
+
+// Created by the first start of the tracing only, so that its capacity is the requested one
++ (RZNotificationTraceBuffer *)traceBufferWithCapacity:(NSUInteger)capacity
+{
+    // Never destroyed, another thread can still be recording into it
+    static dispatch_once_t pred = 0;
+    dispatch_once(&pred, ^{
+        RZNotificationClock clock = { RZMediaTime, NULL };
+        sTraceBuffer = RZNotificationTraceBufferCreate(capacity ? capacity : kDefaultTraceCapacity, &clock);
+    });
+    return sTraceBuffer;
+}
+
+// NULL until the tracing starts
++ (RZNotificationTraceBuffer *)traceBuffer
+{
+    return sTraceBuffer;
+}
+
++ (RZNotificationEventLog *)eventLog
+{
+    static dispatch_once_t pred = 0;
+    static RZNotificationEventLog *_eventLog = NULL;
+    dispatch_once(&pred, ^{
+        RZNotificationClock clock = { RZMediaTime, NULL };
+        _eventLog = RZNotificationEventLogCreate(&clock);
+    });
+    return _eventLog;
+}
+
+// Main thread only, like every call recorded
++ (void)recordEvent:(RZNotificationEvent *)event
+{
+    if (sEventRecordingEnabled) {
+        RZNotificationEventLogRecord([self eventLog], event);
+    }
+}
+
+static inline RZNotificationView *RZNotificationForRegistryKey(uint64_t key)
+{
+    return key ? (__bridge RZNotificationView *)(void *)(uintptr_t)key : nil;
+}
+
++ (void)registerNotification:(RZNotificationView *)notification
+{
+    NSAssert(notification, @"`notification should not be nil`");
+    BOOL onWindow = [notification.container isKindOfClass:[RZNotificationWindow class]];
+    uint64_t controller = onWindow ? RZRegistryKey(notification.contextController) : 0;
+    
+    [self observeOrientationChanges];
+    [self observeMemoryWarnings];
+    
+    if (RZNotificationRegistryInsert([self registry], RZRegistryKey(notification), RZRegistryKey(notification.container), controller)) {
+        [[self registeredNotifications] addObject:notification];
+        RZNotificationTraceCounterAdd(RZNotificationTraceCounterLiveViews, 1);
+        [self stackNotification:notification];
+        [self updateMemoryOfNotification:notification];
+    }
+    
+    if (onWindow) {
+        [(UIWindow*)notification.container setHidden:NO];
+    }
+    
+    // The new notification is never evicted, older or less important ones make room for it
+    [self enforceMemoryBudget];
+}
+
++ (void)removeNotification:(RZNotificationView*)notification
+{
+    NSAssert(notification, @"`notification should not be nil`");
+    [self removeNotifications:@[notification]];
+}
+
++ (NSUInteger)removeNotifications:(NSArray*)notifications
+{
+    NSUInteger count = [notifications count];
+    if (count == 0) {
+        return 0;
+    }
+    
+    uint64_t *keys = malloc(count * sizeof(uint64_t));
+    NSUInteger index = 0;
+    for (RZNotificationView *notification in notifications) {
+        keys[index++] = RZRegistryKey(notification);
+    }
+    uint64_t *emptied = malloc(count * sizeof(uint64_t));
+    size_t emptiedCount = 0;
+    NSUInteger removed = RZNotificationRegistryRemoveManyEmptying([self registry], keys, count, emptied, &emptiedCount);
+    for (NSUInteger i = 0; i < count; i++) {
+        RZNotificationMemoryBudgetRemove([self memoryBudget], keys[i]);
+    }
+    NSMutableSet *emptiedContainers = [NSMutableSet setWithCapacity:emptiedCount];
+    for (size_t i = 0; i < emptiedCount; i++) {
+        [emptiedContainers addObject:@(emptied[i])];
+    }
+    free(emptied);
+    free(keys);
+    if (removed > 0) {
+        RZNotificationTraceCounterAdd(RZNotificationTraceCounterLiveViews, -(long)removed);
+    }
+    
+    NSMutableSet *windows = [NSMutableSet set];
+    for (RZNotificationView *notification in notifications) {
+        [self unstackNotification:notification];
+        if ([notification.container isKindOfClass:[RZNotificationWindow class]]) {
+            [windows addObject:notification.container];
+        }
+    }
+    [[self registeredNotifications] minusSet:[NSSet setWithArray:notifications]];
+    
+    // Each window once: hidden with its last notification, shrunk to the remaining ones otherwise
+    for (RZNotificationWindow *window in windows) {
+        if ([emptiedContainers containsObject:@(RZRegistryKey(window))]) {
+            if (!window.hidden) {
+                [window setHidden:YES];
+            }
+        }
+        else {
+            [self fitNotificationWindow:window including:nil];
+        }
+    }
+    return removed;
+}
+
+#pragma mark Rotation
+
++ (void)observeOrientationChanges
+{
+    static dispatch_once_t pred = 0;
+    dispatch_once(&pred, ^{
+        [[NSNotificationCenter defaultCenter] addObserverForName:UIDeviceOrientationDidChangeNotification object:nil queue:[NSOperationQueue mainQueue] usingBlock:^(NSNotification *note) {
+            UIDeviceOrientation orientation = [(UIDevice*)note.object orientation];
+            if (!UIDeviceOrientationIsValidInterfaceOrientation(orientation))
+                return;
+            
+            // Rotations come in bursts, only the last one is laid out
+            NSUInteger changeCount = ++sOrientationChangeCount;
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kOrientationDebounceDelay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+                if (changeCount == sOrientationChangeCount) {
+                    [self relayoutNotificationsForOrientation:orientation];
+                }
+            });
+        }];
+    });
+}
+
+// 0 when the container does not follow the orientation
++ (CGFloat)layoutWidthForContainer:(id<RZNotificationViewManagerProtocol>)container orientation:(UIDeviceOrientation)orientation
+{
+    if ([container isKindOfClass:[UIViewController class]]) {
+        UIViewController *c = (UIViewController*)container;
+        if (![c shouldAutorotate] || !RZOrientationMaskContainsOrientation([c supportedInterfaceOrientations], orientation))
+            return 0.0f;
+        return CGRectGetWidth(c.view.frame);
+    }
+    if ([container isKindOfClass:[RZNotificationWindow class]]) {
+        return CGRectGetWidth(PPScreenBounds());
+    }
+    return CGRectGetWidth([(UIView*)container frame]);
+}
+
++ (void)relayoutNotificationsForOrientation:(UIDeviceOrientation)orientation
+{
+    // Container widths are computed once, notifications of the same width are laid out together
+    NSMapTable *widthByContainer = [NSMapTable strongToStrongObjectsMapTable];
+    NSMutableDictionary *notificationsByWidth = [NSMutableDictionary dictionary];
+    
+    for (RZNotificationView *notification in [self registeredNotifications]) {
+        id<RZNotificationViewManagerProtocol> container = notification.container;
+        // Stacked past the max visible, they are laid out for when they show again
+        if (!container || (notification.hidden && !notification.stackHidden) || !notification.superview)
+            continue;
+        
+        NSNumber *width = [widthByContainer objectForKey:container];
+        if (!width) {
+            width = @([self layoutWidthForContainer:container orientation:orientation]);
+            [widthByContainer setObject:width forKey:container];
+        }
+        if ([width doubleValue] <= 0.0)
+            continue;
+        
+        NSMutableArray *notifications = notificationsByWidth[width];
+        if (!notifications) {
+            notifications = [NSMutableArray array];
+            notificationsByWidth[width] = notifications;
+        }
+        [notifications addObject:notification];
+    }
+    
+    if ([notificationsByWidth count] == 0)
+        return;
+    
+    if (sEventRecordingEnabled) {
+        for (id<RZNotificationViewManagerProtocol> container in widthByContainer) {
+            RZNotificationEvent event;
+            memset(&event, 0, sizeof(event));
+            event.type = RZNotificationEventRotate;
+            event.container = RZRegistryKey(container);
+            event.width = [[widthByContainer objectForKey:container] doubleValue];
+            if ([container isKindOfClass:[UIViewController class]])
+                event.height = CGRectGetHeight(((UIViewController*)container).view.frame);
+            else if ([container isKindOfClass:[RZNotificationWindow class]])
+                event.height = CGRectGetHeight(PPScreenBounds());
+            else
+                event.height = CGRectGetHeight([(UIView*)container frame]);
+            [self recordEvent:&event];
+        }
+    }
+    
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    
+    [notificationsByWidth enumerateKeysAndObjectsUsingBlock:^(NSNumber *width, NSArray *notifications, BOOL *stop) {
+        for (RZNotificationView *notification in notifications) {
+            [notification relayoutForWidth:[width doubleValue]];
+        }
+    }];
+    
+    // Then the windows follow the screen and their notifications, and the notifications follow their window
+    for (RZNotificationWindow *window in [[self notificationWindows] objectEnumerator]) {
+        if ([[widthByContainer objectForKey:window] doubleValue] > 0.0) {
+            [self fitNotificationWindow:window including:nil];
+            for (RZNotificationView *notification in [self allNotificationsForContainer:window]) {
+                [notification placeToFinalPosition];
+            }
+        }
+    }
+    
+    // Stacked notifications pushed by a resized one
+    [self layoutStacksAnimated:NO];
+    
+    [CATransaction commit];
+}
+
+#pragma mark Scheduling
+
++ (NSMapTable *)containerQueues
+{
+    static dispatch_once_t pred = 0;
+    __strong static NSMapTable *_containerQueues = nil;
+    dispatch_once(&pred, ^{
+        _containerQueues = [NSMapTable weakToStrongObjectsMapTable];
+    });
+    return _containerQueues;
+}
+
++ (RZNotificationContainerQueue *)queueForContainer:(id<RZNotificationViewManagerProtocol>)container create:(BOOL)create
+{
+    if (!container)
+        return nil;
+    
+    RZNotificationContainerQueue *queue = [[self containerQueues] objectForKey:container];
+    if (!queue && create) {
+        queue = [[RZNotificationContainerQueue alloc] init];
+        [[self containerQueues] setObject:queue forKey:container];
+    }
+    return queue;
+}
+
++ (void)updateSchedulerConfiguration
+{
+    RZNotificationSchedulerConfig config = RZCurrentSchedulerConfig();
+    for (RZNotificationContainerQueue *queue in [[self containerQueues] objectEnumerator]) {
+        RZNotificationSchedulerSetConfig(queue->_scheduler, &config);
+        [self drainQueue:queue];
+    }
+}
+
++ (RZNotificationView *)scheduleNotification:(RZNotificationView*)notification
+{
+    return [self scheduleNotification:notification coalesce:kCoalesceNotifications];
+}
+
+// Only notifications the caller does not hold yet can be merged: the returned one replaces them
++ (RZNotificationView *)scheduleNotification:(RZNotificationView*)notification coalesce:(BOOL)coalesce
+{
+    NSAssert(notification, @"`notification should not be nil`");
+    RZNotificationContainerQueue *queue = [self queueForContainer:notification.container create:YES];
+    if (!queue) {
+        [notification performShow];
+        return notification;
+    }
+    if (notification.scheduledIdentifier != 0) {
+        // Already queued or visible
+        return notification;
+    }
+    [notification recordEvent:RZNotificationEventShow];
+    
+    uint64_t identifier = 0;
+    uint64_t coalescingKey = coalesce ? [notification coalescingKey] : 0;
+    RZNotificationScheduleResult result = RZNotificationSchedulerSubmit(queue->_scheduler, coalescingKey, (int)notification.priority, &identifier);
+    
+    switch (result) {
+        case RZNotificationScheduleQueued:
+            notification.scheduledIdentifier = identifier;
+            [queue->_notifications setObject:notification forKey:@(identifier)];
+            [self drainQueue:queue];
+            return notification;
+            
+        case RZNotificationScheduleCoalescedPending:
+        case RZNotificationScheduleCoalescedVisible:
+        {
+            RZNotificationView *existing = [queue->_notifications objectForKey:@(identifier)];
+            existing.repeatCount = RZNotificationSchedulerRepeatCount(queue->_scheduler, identifier);
+            [existing addMergedCompletion:notification.completionBlock];
+            if (result == RZNotificationScheduleCoalescedVisible) {
+                // Keep the merged notification on screen for a full duration
+                [existing hideAfterDelay:existing.delay];
+            }
+            if ([notification isReusable]) {
+                [self enqueueReusableNotification:notification];
+            }
+            return existing;
+        }
+            
+        case RZNotificationScheduleFailed:
+        default:
+            [notification performShow];
+            return notification;
+    }
+}
+
++ (void)drainQueue:(RZNotificationContainerQueue *)queue
+{
+    RZNotificationScheduledRequest request;
+    while (RZNotificationSchedulerNext(queue->_scheduler, &request)) {
+        RZNotificationView *notification = [queue->_notifications objectForKey:@(request.identifier)];
+        notification.repeatCount = request.repeatCount;
+        [notification performShow];
+    }
+    
+    // Rate limited, come back when the next token is available
+    double delay = RZNotificationSchedulerNextReadyDelay(queue->_scheduler);
+    if (delay > 0.0 && !queue->_drainScheduled) {
+        queue->_drainScheduled = YES;
+        __weak RZNotificationContainerQueue *weakQueue = queue;
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            RZNotificationContainerQueue *strongQueue = weakQueue;
+            if (strongQueue) {
+                strongQueue->_drainScheduled = NO;
+                [self drainQueue:strongQueue];
+            }
+        });
+    }
+}
+
++ (BOOL)cancelScheduledNotification:(RZNotificationView*)notification
+{
+    RZNotificationContainerQueue *queue = [self queueForContainer:notification.container create:NO];
+    uint64_t identifier = notification.scheduledIdentifier;
+    if (!queue || identifier == 0 || !RZNotificationSchedulerCancel(queue->_scheduler, identifier)) {
+        return NO;
+    }
+    [queue->_notifications removeObjectForKey:@(identifier)];
+    notification.scheduledIdentifier = 0;
+    return YES;
+}
+
+// A waiting notification is queued again at its new priority, a visible one has nothing to reorder
++ (void)updatePriorityOfNotification:(RZNotificationView*)notification
+{
+    RZNotificationContainerQueue *queue = [self queueForContainer:notification.container create:NO];
+    // Only a pending request can be cancelled
+    if (!queue || ![self cancelScheduledNotification:notification]) {
+        return;
+    }
+    
+    uint64_t identifier = 0;
+    if (RZNotificationSchedulerSubmit(queue->_scheduler, 0, (int)notification.priority, &identifier) != RZNotificationScheduleQueued) {
+        [notification performShow];
+        return;
+    }
+    notification.scheduledIdentifier = identifier;
+    [queue->_notifications setObject:notification forKey:@(identifier)];
+    [self drainQueue:queue];
+}
+
++ (void)notificationDidHide:(RZNotificationView*)notification
+{
+    RZNotificationContainerQueue *queue = [self queueForContainer:notification.container create:NO];
+    uint64_t identifier = notification.scheduledIdentifier;
+    if (!queue || identifier == 0) {
+        return;
+    }
+    RZNotificationSchedulerDidHide(queue->_scheduler, identifier);
+    [queue->_notifications removeObjectForKey:@(identifier)];
+    notification.scheduledIdentifier = 0;
+    [self drainQueue:queue];
+}
+
++ (NSArray *)pendingNotificationsForContainer:(id<RZNotificationViewManagerProtocol>)container
+{
+    RZNotificationContainerQueue *queue = [self queueForContainer:container create:NO];
+    NSMutableArray *pending = [NSMutableArray array];
+    for (RZNotificationView *notification in [queue->_notifications objectEnumerator]) {
+        if (![notification superview]) {
+            [pending addObject:notification];
+        }
+    }
+    return pending;
+}
+
+#pragma mark Requests
+
++ (RZNotificationRequestQueue *)requestQueue
+{
+    static dispatch_once_t pred = 0;
+    static RZNotificationRequestQueue *_requestQueue = NULL;
+    dispatch_once(&pred, ^{
+        _requestQueue = RZNotificationRequestQueueCreate(kRequestQueueCapacity);
+    });
+    return _requestQueue;
+}
+
++ (CADisplayLink *)requestDisplayLink
+{
+    static dispatch_once_t pred = 0;
+    __strong static CADisplayLink *_requestDisplayLink = nil;
+    dispatch_once(&pred, ^{
+        _requestDisplayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(drainRequests:)];
+        _requestDisplayLink.paused = YES;
+        // Common modes, requests are also shown while scrolling
+        [_requestDisplayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    });
+    return _requestDisplayLink;
+}
+
++ (void)showRequest:(RZNotificationRequest *)request
+{
+    RZNotificationDescription *description = request->_description;
+    id<RZNotificationViewManagerProtocol> container = [RZNotificationView containerForContext:description.context position:description.position];
+    RZNotificationView *notification = [RZNotificationView reusableNotificationWithDescription:description container:container completion:request->_completion];
+    [self scheduleNotification:notification];
+}
+
+// Any thread
++ (void)submitNotification:(RZNotificationDescription*)description completion:(RZNotificationCompletion)completionBlock
+{
+    RZNotificationRequest *request = [[RZNotificationRequest alloc] init];
+    request->_description = description;
+    request->_completion = [completionBlock copy];
+    
+    void *record = (__bridge_retained void *)request;
+    switch (RZNotificationRequestQueuePush([self requestQueue], record)) {
+        case RZNotificationRequestQueuePushedWake:
+            // Once per burst, the display link then drains every frame until the queue is empty
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self requestDisplayLink].paused = NO;
+            });
+            break;
+            
+        case RZNotificationRequestQueuePushed:
+            break;
+            
+        case RZNotificationRequestQueueFull:
+        default:
+            // The main thread is far behind, the request skips the queue rather than being lost
+            CFRelease(record);
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self showRequest:request];
+            });
+            break;
+    }
+}
+
+static void RZShowRequest(void *record, void *context)
+{
+    RZNotificationRequest *request = (__bridge_transfer RZNotificationRequest *)record;
+    [RZNotificationViewManager showRequest:request];
+}
+
++ (void)drainRequests:(CADisplayLink *)displayLink
+{
+    RZNotificationRequestQueue *queue = [self requestQueue];
+    // Bounded so that a storm spreads over a few frames
+    RZNotificationRequestQueueDrain(queue, kMaxRequestsPerFrame, RZShowRequest, NULL);
+    if (RZNotificationRequestQueueIsEmpty(queue)) {
+        // A request pushed from now on asks for a wake up
+        displayLink.paused = YES;
+    }
+}
+
+#pragma mark Stacking
+
++ (NSMapTable *)containerStacks
+{
+    static dispatch_once_t pred = 0;
+    __strong static NSMapTable *_containerStacks = nil;
+    dispatch_once(&pred, ^{
+        _containerStacks = [NSMapTable weakToStrongObjectsMapTable];
+    });
+    return _containerStacks;
+}
+
++ (RZNotificationStack *)stackForNotification:(RZNotificationView*)notification create:(BOOL)create
+{
+    id<RZNotificationViewManagerProtocol> container = notification.container;
+    if (!container)
+        return NULL;
+    
+    RZNotificationContainerStacks *stacks = [[self containerStacks] objectForKey:container];
+    if (!stacks && create) {
+        stacks = [[RZNotificationContainerStacks alloc] init];
+        [[self containerStacks] setObject:stacks forKey:container];
+    }
+    if (!stacks)
+        return NULL;
+    return (notification.position == RZNotificationPositionTop) ? stacks->_top : stacks->_bottom;
+}
+
++ (void)stackNotification:(RZNotificationView*)notification
+{
+    if (kLayoutMode != RZNotificationLayoutModeStack)
+        return;
+    
+    // The newest notification goes against the edge
+    RZNotificationStack *stack = [self stackForNotification:notification create:YES];
+    if (stack && RZNotificationStackInsert(stack, RZRegistryKey(notification), 0, CGRectGetHeight(notification.frame))) {
+        [self setNeedsStackLayout];
+    }
+}
+
++ (void)unstackNotification:(RZNotificationView*)notification
+{
+    id<RZNotificationViewManagerProtocol> container = notification.container;
+    RZNotificationContainerStacks *stacks = container ? [[self containerStacks] objectForKey:container] : nil;
+    if (!stacks)
+        return;
+    
+    // Both edges, the position may have changed since the notification was stacked
+    uint64_t key = RZRegistryKey(notification);
+    BOOL removedFromTop = RZNotificationStackRemove(stacks->_top, key);
+    BOOL removedFromBottom = RZNotificationStackRemove(stacks->_bottom, key);
+    if (removedFromTop || removedFromBottom) {
+        notification.stackHidden = NO;
+        [self setNeedsStackLayout];
+    }
+}
+
++ (void)resizeStackedNotification:(RZNotificationView*)notification
+{
+    RZNotificationStack *stack = [self stackForNotification:notification create:NO];
+    if (stack && RZNotificationStackResize(stack, RZRegistryKey(notification), CGRectGetHeight(notification.frame))) {
+        [self setNeedsStackLayout];
+    }
+}
+
+// Not stacked notifications are visible
++ (BOOL)isStackVisibleNotification:(RZNotificationView*)notification
+{
+    RZNotificationStack *stack = [self stackForNotification:notification create:NO];
+    uint64_t key = RZRegistryKey(notification);
+    size_t index = 0;
+    return !stack || !RZNotificationStackIndex(stack, key, &index) || RZNotificationStackIsVisible(stack, key);
+}
+
++ (CGFloat)stackOffsetOfNotification:(RZNotificationView*)notification
+{
+    RZNotificationStack *stack = [self stackForNotification:notification create:NO];
+    double offset = 0.0;
+    if (stack) {
+        RZNotificationStackOffset(stack, RZRegistryKey(notification), &offset);
+    }
+    return offset;
+}
+
++ (void)updateStackConfiguration
+{
+    for (RZNotificationContainerStacks *stacks in [[self containerStacks] objectEnumerator]) {
+        RZNotificationStackSetSpacing(stacks->_top, kStackSpacing);
+        RZNotificationStackSetSpacing(stacks->_bottom, kStackSpacing);
+        RZNotificationStackSetMaxVisible(stacks->_top, (unsigned)kStackMaxVisible);
+        RZNotificationStackSetMaxVisible(stacks->_bottom, (unsigned)kStackMaxVisible);
+    }
+    [self setNeedsStackLayout];
+}
+
+// The changes of a run loop turn are animated together
++ (void)setNeedsStackLayout
+{
+    if (sStackLayoutScheduled)
+        return;
+    sStackLayoutScheduled = YES;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [self layoutStacksAnimated:YES];
+    });
+}
+
+static void RZAppendStackChanges(RZNotificationStack *stack, NSMutableData *changes)
+{
+    RZNotificationStackChange buffer[16];
+    size_t remaining;
+    do {
+        remaining = RZNotificationStackTakeChanges(stack, buffer, 16);
+        [changes appendBytes:buffer length:MIN(remaining, (size_t)16) * sizeof(RZNotificationStackChange)];
+    } while (remaining > 16);
+}
+
++ (void)layoutStacksAnimated:(BOOL)animated
+{
+    sStackLayoutScheduled = NO;
+    
+    NSMutableData *changes = [NSMutableData data];
+    for (RZNotificationContainerStacks *stacks in [[self containerStacks] objectEnumerator]) {
+        RZAppendStackChanges(stacks->_top, changes);
+        RZAppendStackChanges(stacks->_bottom, changes);
+    }
+    NSUInteger count = [changes length] / sizeof(RZNotificationStackChange);
+    if (count == 0)
+        return;
+    
+    // Windows first, the notifications are placed against their edge
+    [self fitNotificationWindows];
+    
+    // Only the notifications that moved, in a single transaction
+    void (^apply)(void) = ^{
+        const RZNotificationStackChange *change = [changes bytes];
+        for (NSUInteger i = 0; i < count; i++, change++) {
+            RZNotificationView *notification = RZNotificationForRegistryKey(change->item);
+            if (!change->inserted) {
+                // A new notification is already animated by its show
+                [notification placeToFinalPosition];
+            }
+            notification.stackHidden = !change->visible;
+        }
+    };
+    
+    // Again once hidden or shown past the max visible
+    if (animated) {
+        RZAnimateSlide(apply, ^(BOOL finished) {
+            [self fitNotificationWindows];
+        });
     }
+    else {
+        apply();
+        [self fitNotificationWindows];
+    }
+}
+
+#pragma mark Hide timers
+
+static void RZHideTimerFired(uint64_t identifier, void *context)
+{
+    NSMutableArray *expiredTimers = (__bridge NSMutableArray *)context;
+    [expiredTimers addObject:@(identifier)];
+}
+
++ (RZNotificationTimerWheel *)hideTimerWheel
+{
+    static dispatch_once_t pred = 0;
+    static RZNotificationTimerWheel *_hideTimerWheel = NULL;
+    dispatch_once(&pred, ^{
+        RZNotificationClock clock = { RZMediaTime, NULL };
+        _hideTimerWheel = RZNotificationTimerWheelCreate(&clock, 0.0, 0);
+        
+        // Countdowns stop while the app is in background
+        NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+        [center addObserverForName:UIApplicationDidEnterBackgroundNotification object:nil queue:[NSOperationQueue mainQueue] usingBlock:^(NSNotification *note) {
+            RZNotificationTimerWheelPause(_hideTimerWheel);
+            [self armHideTimerSource];
+        }];
+        [center addObserverForName:UIApplicationWillEnterForegroundNotification object:nil queue:[NSOperationQueue mainQueue] usingBlock:^(NSNotification *note) {
+            RZNotificationTimerWheelResume(_hideTimerWheel);
+            [self armHideTimerSource];
+        }];
+    });
+    return _hideTimerWheel;
+}
+
++ (NSMutableDictionary *)notificationsByHideTimer
+{
+    static dispatch_once_t pred = 0;
+    __strong static NSMutableDictionary *_notificationsByHideTimer = nil;
+    dispatch_once(&pred, ^{
+        _notificationsByHideTimer = [NSMutableDictionary dictionary];
+    });
+    return _notificationsByHideTimer;
+}
+
++ (dispatch_source_t)hideTimerSource
+{
+    static dispatch_once_t pred = 0;
+    __strong static dispatch_source_t _hideTimerSource = nil;
+    dispatch_once(&pred, ^{
+        _hideTimerSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_main_queue());
+        dispatch_source_set_event_handler(_hideTimerSource, ^{
+            [self hideTimerSourceFired];
+        });
+        dispatch_source_set_timer(_hideTimerSource, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_hideTimerSource);
+    });
+    return _hideTimerSource;
+}
+
++ (void)armHideTimerSource
+{
+    double deadline = RZNotificationTimerWheelNextDeadline([self hideTimerWheel]);
+    if (deadline < 0.0) {
+        dispatch_source_set_timer([self hideTimerSource], DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        return;
+    }
+    double delay = MAX(0.0, deadline - CACurrentMediaTime());
+    dispatch_source_set_timer([self hideTimerSource],
+                              dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                              DISPATCH_TIME_FOREVER,
+                              NSEC_PER_SEC / 100);
+}
+
++ (void)hideTimerSourceFired
+{
+    NSMutableArray *expiredTimers = [NSMutableArray array];
+    RZNotificationTimerWheelAdvance([self hideTimerWheel], RZHideTimerFired, (__bridge void *)expiredTimers);
     
-    if ([notification.container isEqual:[self notificationWindow]]) {
-        if ([notification.container.rzNotifications count] == 0) {
-            [[self notificationWindow] setHidden:YES];
+    sHidingExpiredNotifications = YES;
+    for (NSNumber *timer in expiredTimers) {
+        RZNotificationView *notification = [[self notificationsByHideTimer] objectForKey:timer];
+        [[self notificationsByHideTimer] removeObjectForKey:timer];
+        notification.hideTimer = 0;
+        [notification hide];
+    }
+    sHidingExpiredNotifications = NO;
+    [self armHideTimerSource];
+}
+
++ (void)scheduleHideOfNotification:(RZNotificationView*)notification afterDelay:(NSTimeInterval)delay
+{
+    [self cancelHideOfNotification:notification];
+    
+    uint64_t timer = RZNotificationTimerWheelSchedule([self hideTimerWheel], delay);
+    if (timer == 0) {
+        return;
+    }
+    notification.hideTimer = timer;
+    [[self notificationsByHideTimer] setObject:notification forKey:@(timer)];
+    [self armHideTimerSource];
+}
+
++ (void)cancelHideOfNotification:(RZNotificationView*)notification
+{
+    uint64_t timer = notification.hideTimer;
+    if (timer == 0) {
+        return;
+    }
+    RZNotificationTimerWheelCancel([self hideTimerWheel], timer);
+    [[self notificationsByHideTimer] removeObjectForKey:@(timer)];
+    notification.hideTimer = 0;
+    [self armHideTimerSource];
+}
+
++ (void)pauseHideOfNotification:(RZNotificationView*)notification
+{
+    if (notification.hideTimer && RZNotificationTimerWheelPauseTimer([self hideTimerWheel], notification.hideTimer)) {
+        [self armHideTimerSource];
+    }
+}
+
++ (void)resumeHideOfNotification:(RZNotificationView*)notification
+{
+    if (notification.hideTimer && RZNotificationTimerWheelResumeTimer([self hideTimerWheel], notification.hideTimer)) {
+        [self armHideTimerSource];
+    }
+}
+
+#pragma mark Identifiers
+
++ (NSMapTable *)notificationsByIdentifier
+{
+    static dispatch_once_t pred = 0;
+    __strong static NSMapTable *_notificationsByIdentifier = nil;
+    dispatch_once(&pred, ^{
+        _notificationsByIdentifier = [NSMapTable strongToWeakObjectsMapTable];
+    });
+    return _notificationsByIdentifier;
+}
+
++ (RZNotificationView *)notificationWithIdentifier:(NSString*)identifier
+{
+    RZNotificationView *notification = [[self notificationsByIdentifier] objectForKey:identifier];
+    // Hidden, or reused for another notification since
+    if (notification && (![notification isLive] || ![notification.notificationIdentifier isEqualToString:identifier])) {
+        [[self notificationsByIdentifier] removeObjectForKey:identifier];
+        return nil;
+    }
+    return notification;
+}
+
++ (void)setNotification:(RZNotificationView*)notification forIdentifier:(NSString*)identifier
+{
+    if ([notification.notificationIdentifier isEqualToString:identifier]) {
+        [[self notificationsByIdentifier] setObject:notification forKey:identifier];
+    }
+}
+
+#pragma mark Memory
+
++ (RZNotificationMemoryBudget *)memoryBudget
+{
+    static dispatch_once_t pred = 0;
+    static RZNotificationMemoryBudget *_memoryBudget = NULL;
+    dispatch_once(&pred, ^{
+        _memoryBudget = RZNotificationMemoryBudgetCreate(kMemoryBudget);
+    });
+    return _memoryBudget;
+}
+
++ (void)observeMemoryWarnings
+{
+    static dispatch_once_t pred = 0;
+    dispatch_once(&pred, ^{
+        // Image and text measurement caches purge themselves
+        [[NSNotificationCenter defaultCenter] addObserverForName:UIApplicationDidReceiveMemoryWarningNotification object:nil queue:[NSOperationQueue mainQueue] usingBlock:^(NSNotification *note) {
+            [[self reusePool] removeAllObjects];
+            for (RZNotificationView *notification in [self registeredNotifications]) {
+                [notification releaseUnusedHighlightOverlay];
+            }
+            [self enforceMemoryBudget];
+        }];
+    });
+}
+
++ (void)updateMemoryOfNotification:(RZNotificationView*)notification
+{
+    // Only live notifications are accounted
+    if (![[self registeredNotifications] containsObject:notification]) {
+        return;
+    }
+    RZNotificationMemoryBudgetSet([self memoryBudget], RZRegistryKey(notification), [notification estimatedMemoryBytes], (int)notification.priority);
+}
+
++ (void)updateMemoryBudget
+{
+    [self observeMemoryWarnings];
+    RZNotificationMemoryBudgetSetLimit([self memoryBudget], kMemoryBudget);
+    [self enforceMemoryBudget];
+}
+
++ (void)enforceMemoryBudget
+{
+    RZNotificationMemoryBudget *budget = [self memoryBudget];
+    if (RZNotificationMemoryBudgetLimit(budget) == 0) {
+        return;
+    }
+    
+    NSMutableArray *evicted = [NSMutableArray array];
+    uint64_t keys[kEvictionBatchSize];
+    size_t count;
+    do {
+        count = RZNotificationMemoryBudgetTakeEvictions(budget, keys, kEvictionBatchSize);
+        for (size_t i = 0; i < MIN(count, kEvictionBatchSize); i++) {
+            [evicted addObject:RZNotificationForRegistryKey(keys[i])];
         }
+    } while (count > kEvictionBatchSize);
+    
+    if ([evicted count] > 0) {
+        sMemoryEvictions += [evicted count];
+        // Accounted until removed, once the hide animation ends
+        [RZNotificationView hideNotifications:evicted completion:nil];
     }
 }
 
++ (NSUInteger)memoryUsage
+{
+    return RZNotificationMemoryBudgetUsage([self memoryBudget]);
+}
+
+#pragma mark Reuse
+
++ (NSMutableArray *)reusePool
+{
+    static dispatch_once_t pred = 0;
+    __strong static NSMutableArray *_reusePool = nil;
+    dispatch_once(&pred, ^{
+        _reusePool = [NSMutableArray array];
+    });
+    return _reusePool;
+}
+
++ (RZNotificationView *)dequeueReusableNotification
+{
+    NSMutableArray *pool = [self reusePool];
+    RZNotificationView *notification = [pool lastObject];
+    if (notification) {
+        [pool removeLastObject];
+    }
+    return notification;
+}
+
++ (void)enqueueReusableNotification:(RZNotificationView*)notification
+{
+    NSAssert(notification, @"`notification should not be nil`");
+    NSMutableArray *pool = [self reusePool];
+    while ([pool count] > kReusePoolSize) {
+        [pool removeObjectAtIndex:0];
+    }
+    if ([pool count] < kReusePoolSize && [pool indexOfObjectIdenticalTo:notification] == NSNotFound) {
+        [notification prepareForReuse];
+        [pool addObject:notification];
+    }
+}
+
++ (NSUInteger)numberOfReusableNotifications
+{
+    return [[self reusePool] count];
+}
+
 + (RZNotificationView *)notificationForContainer:(id<RZNotificationViewManagerProtocol>)container
 {
     NSAssert([container conformsToProtocol:@protocol(RZNotificationViewManagerProtocol)], @"The container should conforms to `RZNotificationViewManagerProtocol`");
@@ -1356,29 +4052,43 @@ static char rzNotificationsKey;
     if([container isKindOfClass:[UIViewController class]])
     {
         // Then we assume that there may be some notifications into a window with a context controller
-        NSArray *allNotifsForWindow = [self allNotificationsForContainer:[self notificationWindow]];
-        NSArray *filtered = [allNotifsForWindow filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"contextController == %@", container]];
         // We also assume that what is on window is on top
-        if([filtered count] != 0)
+        uint64_t onWindow = RZNotificationRegistryLastForController([self registry], RZRegistryKey(container));
+        if(onWindow != 0)
         {
-            return [filtered lastObject];
+            return RZNotificationForRegistryKey(onWindow);
         }
     }
     
-    return [container.rzNotifications lastObject];
+    return RZNotificationForRegistryKey(RZNotificationRegistryLastForContainer([self registry], RZRegistryKey(container)));
 }
 
 +(NSArray *)allNotificationsForContainer:(id<RZNotificationViewManagerProtocol>)container
 {
     NSAssert([container conformsToProtocol:@protocol(RZNotificationViewManagerProtocol)], @"The container should conforms to `RZNotificationViewManagerProtocol`");
-    NSMutableArray *toReturn = container.rzNotifications;
-    if([container isKindOfClass:[UIViewController class]])
-    {
-        // Then we assume that there may be some notifications into a window with a context controller
-        NSArray *allNotifsForWindow = [self allNotificationsForContainer:[self notificationWindow]];
-        [toReturn addObjectsFromArray:allNotifsForWindow];
+    RZNotificationRegistry *registry = [self registry];
+    uint64_t key = RZRegistryKey(container);
+    BOOL isController = [container isKindOfClass:[UIViewController class]];
+    
+    size_t containerCount = RZNotificationRegistryCountForContainer(registry, key);
+    // Then we assume that there may be some notifications into a window with a context controller
+    size_t windowCount = isController ? RZNotificationRegistryCountForController(registry, key) : 0;
+    if (containerCount + windowCount == 0) {
+        return @[];
     }
-
+    
+    uint64_t *keys = malloc((containerCount + windowCount) * sizeof(uint64_t));
+    RZNotificationRegistryCopyForContainer(registry, key, keys, containerCount);
+    if (isController) {
+        RZNotificationRegistryCopyForController(registry, key, keys + containerCount, windowCount);
+    }
+    
+    NSMutableArray *toReturn = [NSMutableArray arrayWithCapacity:containerCount + windowCount];
+    for (size_t i = 0; i < containerCount + windowCount; i++) {
+        [toReturn addObject:RZNotificationForRegistryKey(keys[i])];
+    }
+    free(keys);
+    
     return [NSArray arrayWithArray:toReturn];
 }
 
@@ -7,9 +7,13 @@
 //
 
 #import <UIKit/UIKit.h>
+#import "RZNotificationColorMath.h"
 
 @interface UIColor (RZAdditions)
 
++ (RZNotificationRGBA)RGBAForColor:(UIColor *)color;
++ (UIColor *)colorWithRGBA:(RZNotificationRGBA)color;
+
 + (UIColor *)lighterColorForColor:(UIColor *)c;
 + (UIColor *)lighterColorForColor:(UIColor *)oldColor withRgbOffset:(CGFloat)value;
 + (UIColor *)lighterColorForColor:(UIColor *)oldColor withRgbOffset:(CGFloat)value andAlphaOffset:(CGFloat)alpha;
@@ -10,6 +10,37 @@
 
 @implementation UIColor (RZAdditions)
 
+static CGColorSpaceRef RZDeviceRGBColorSpace(void)
+{
+    static dispatch_once_t pred = 0;
+    static CGColorSpaceRef _colorSpace = NULL;
+    dispatch_once(&pred, ^{
+        _colorSpace = CGColorSpaceCreateDeviceRGB();
+    });
+    return _colorSpace;
+}
+
++ (RZNotificationRGBA)RGBAForColor:(UIColor *)color
+{
+    CGColorRef cgColor = color.CGColor;
+    size_t count = CGColorGetNumberOfComponents(cgColor);
+    const CGFloat *components = CGColorGetComponents(cgColor);
+    double values[4] = {0.0, 0.0, 0.0, 1.0};
+    for (size_t i = 0; i < count && i < 4; i++) {
+        values[i] = components[i];
+    }
+    return RZNotificationRGBAFromComponents(values, count);
+}
+
++ (UIColor *)colorWithRGBA:(RZNotificationRGBA)color
+{
+    CGFloat components[4] = {color.red, color.green, color.blue, color.alpha};
+    CGColorRef cgColor = CGColorCreate(RZDeviceRGBColorSpace(), components);
+    UIColor *retColor = [UIColor colorWithCGColor:cgColor];
+    CGColorRelease(cgColor);
+    return retColor;
+}
+
 // Largely inspired by BButton methods
 + (UIColor *)lighterColorForColor:(UIColor *)c
 {
@@ -23,47 +54,13 @@
 
 + (UIColor *)lighterColorForColor:(UIColor *)oldColor withRgbOffset:(CGFloat)value andAlpha:(CGFloat)alpha
 {
-    CGFloat alphaOffset = 0.0;
-    NSUInteger totalComponents = CGColorGetNumberOfComponents(oldColor.CGColor);
-    bool  isGreyscale     = totalComponents == 2 ? YES : NO;
-    
-    CGFloat* oldComponents = (CGFloat *)CGColorGetComponents(oldColor.CGColor);
-    if (isGreyscale)
-        alphaOffset = oldComponents[1] > alpha ? oldComponents[1] - alpha : alpha - oldComponents[1];
-    else
-        alphaOffset = oldComponents[3] > alpha ? oldComponents[3] - alpha : alpha - oldComponents[3];
-    
+    CGFloat alphaOffset = RZNotificationRGBAAlphaOffset([self RGBAForColor:oldColor], alpha);
     return [UIColor lighterColorForColor:oldColor withRgbOffset:value andAlphaOffset:alphaOffset];
 }
 
 + (UIColor *)lighterColorForColor:(UIColor *)oldColor withRgbOffset:(CGFloat)value andAlphaOffset:(CGFloat)alpha
 {
-    NSUInteger totalComponents = CGColorGetNumberOfComponents(oldColor.CGColor);
-    bool  isGreyscale     = totalComponents == 2 ? YES : NO;
-    
-    CGFloat* oldComponents = (CGFloat *)CGColorGetComponents(oldColor.CGColor);
-    CGFloat newComponents[4];
-    
-    if (isGreyscale) {
-        newComponents[0] = oldComponents[0]+value > 1.0 ? 1.0 : oldComponents[0]+value;
-        newComponents[1] = oldComponents[0]+value > 1.0 ? 1.0 : oldComponents[0]+value;
-        newComponents[2] = oldComponents[0]+value > 1.0 ? 1.0 : oldComponents[0]+value;
-        newComponents[3] = oldComponents[1]-alpha < 0.0 ? 0.0 : oldComponents[1]-alpha;
-    } else {
-        newComponents[0] = oldComponents[0]+value > 1.0 ? 1.0 : oldComponents[0]+value;
-        newComponents[1] = oldComponents[1]+value > 1.0 ? 1.0 : oldComponents[1]+value;
-        newComponents[2] = oldComponents[2]+value > 1.0 ? 1.0 : oldComponents[2]+value;
-        newComponents[3] = oldComponents[3]-alpha < 0.0 ? 0.0 : oldComponents[3]-alpha;
-    }
-    
-    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
-	CGColorRef newColor = CGColorCreate(colorSpace, newComponents);
-	CGColorSpaceRelease(colorSpace);
-    
-	UIColor *retColor = [UIColor colorWithCGColor:newColor];
-	CGColorRelease(newColor);
-    
-    return retColor;
+    return [self colorWithRGBA:RZNotificationRGBALighter([self RGBAForColor:oldColor], value, alpha)];
 }
 
 + (UIColor *)darkerColorForColor:(UIColor *)c
@@ -78,53 +75,13 @@
 
 + (UIColor *)darkerColorForColor:(UIColor *)oldColor withRgbOffset:(CGFloat)value andAlpha:(CGFloat)alpha
 {
-    CGFloat alphaOffset = 0.0;
-    NSUInteger totalComponents = CGColorGetNumberOfComponents(oldColor.CGColor);
-    bool   isGreyscale     = totalComponents == 2 ? YES : NO;
-    
-    CGFloat* oldComponents = (CGFloat *)CGColorGetComponents(oldColor.CGColor);
-    if (isGreyscale)
-        alphaOffset = oldComponents[1] > alpha ? oldComponents[1] - alpha : alpha - oldComponents[1];
-    else
-    {
-        alphaOffset = oldComponents[3] > alpha ? oldComponents[3] - alpha : alpha - oldComponents[3];
-        NSLog(@"dark alpha : %f, real : %f, offset : %f", alpha, oldComponents[3], alphaOffset);
-
-    }
-    
+    CGFloat alphaOffset = RZNotificationRGBAAlphaOffset([self RGBAForColor:oldColor], alpha);
     return [UIColor darkerColorForColor:oldColor withRgbOffset:value andAlphaOffset:alphaOffset];
 }
 
-
 + (UIColor *)darkerColorForColor:(UIColor *)oldColor withRgbOffset:(CGFloat)value andAlphaOffset:(CGFloat)alpha
 {
-    NSUInteger totalComponents = CGColorGetNumberOfComponents(oldColor.CGColor);
-    bool   isGreyscale     = totalComponents == 2 ? YES : NO;
-    
-    CGFloat* oldComponents = (CGFloat *)CGColorGetComponents(oldColor.CGColor);
-    CGFloat newComponents[4];
-    
-    if (isGreyscale) {
-        newComponents[0] = oldComponents[0]-value < 0.0 ? 0.0 : oldComponents[0]-value;
-        newComponents[1] = oldComponents[0]-value < 0.0 ? 0.0 : oldComponents[0]-value;
-        newComponents[2] = oldComponents[0]-value < 0.0 ? 0.0 : oldComponents[0]-value;
-        newComponents[3] = oldComponents[1]+alpha > 1.0 ? 1.0 : oldComponents[1]+alpha;
-    } else {
-        newComponents[0] = oldComponents[0]-value < 0.0 ? 0.0 : oldComponents[0]-value;
-        newComponents[1] = oldComponents[1]-value < 0.0 ? 0.0 : oldComponents[1]-value;
-        newComponents[2] = oldComponents[2]-value < 0.0 ? 0.0 : oldComponents[2]-value;
-        newComponents[3] = oldComponents[3]+alpha > 1.0 ? 1.0 : oldComponents[3]+alpha;
-    }
-    
-    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
-	CGColorRef newColor = CGColorCreate(colorSpace, newComponents);
-	CGColorSpaceRelease(colorSpace);
-    
-	UIColor *retColor = [UIColor colorWithCGColor:newColor];
-	CGColorRelease(newColor);
-    
-    return retColor;
-    
+    return [self colorWithRGBA:RZNotificationRGBADarker([self RGBAForColor:oldColor], value, alpha)];
 }
 
 @end
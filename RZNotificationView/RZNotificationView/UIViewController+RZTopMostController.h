@@ -9,6 +9,18 @@
 #import <UIKit/UIKit.h>
 
 @interface UIViewController (RZTopMostController)
+
+/**
+ The controller currently on screen, walking modals and RZTopMostControllerProtocol containers.
+ The hierarchy is walked at most once per run loop turn: the result is cached until the
+ turn ends, or until the window root controller changes
+ */
 + (UIViewController*) topMostController;
 
+/**
+ Forget the cached top most controller, for a presentation, a navigation or a tab change
+ followed by a notification in the same run loop turn
+ */
++ (void) invalidateTopMostController;
+
 @end
@@ -10,6 +10,11 @@
 #import "UITabBarController+RZTopMostControllerProtocol.h"
 #import "UINavigationController+RZTopMostControllerProtocol.h"
 
+// Resolved top most controller, and the root it was resolved from
+static __weak UIViewController *sCachedTopMostController = nil;
+static __weak UIViewController *sCachedRootController = nil;
+static BOOL sTopMostControllerValid = NO;
+
 @implementation UIViewController (RZTopMostController)
 
 + (UIViewController*) getModalViewControllerOfControllerIfExists:(UIViewController*)controller
@@ -26,10 +31,36 @@
     return toReturn;
 }
 
++ (void) invalidateTopMostController
+{
+    sTopMostControllerValid = NO;
+}
+
 + (UIViewController*) topMostController
 {
-    UIViewController *topController = ((UIWindow*)[[UIApplication sharedApplication].windows objectAtIndex:0]).rootViewController;
-    topController = [self getModalViewControllerOfControllerIfExists:topController];
+    UIViewController *rootController = ((UIWindow*)[[UIApplication sharedApplication].windows objectAtIndex:0]).rootViewController;
+    
+    // A replaced root is detected right away
+    UIViewController *cachedController = sCachedTopMostController;
+    if (sTopMostControllerValid && cachedController && sCachedRootController == rootController) {
+        return cachedController;
+    }
+    
+    UIViewController *topController = [self resolveTopMostControllerFromRoot:rootController];
+    sCachedTopMostController = topController;
+    sCachedRootController = rootController;
+    sTopMostControllerValid = YES;
+    
+    // Other hierarchy changes are picked up on the next run loop turn at worst
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [UIViewController invalidateTopMostController];
+    });
+    return topController;
+}
+
++ (UIViewController*) resolveTopMostControllerFromRoot:(UIViewController*)rootController
+{
+    UIViewController *topController = [self getModalViewControllerOfControllerIfExists:rootController];
     
     UIViewController *oldTopController = nil;
     
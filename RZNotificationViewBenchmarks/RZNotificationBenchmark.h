@@ -0,0 +1,79 @@
+//
+//  RZNotificationBenchmark.h
+//  RZNotificationViewBenchmarks
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationViewBenchmarks_RZNotificationBenchmark_h
+#define RZNotificationViewBenchmarks_RZNotificationBenchmark_h
+
+/*
+ * Minimal harness for the plain C benchmarks.
+ * Each case runs once to warm up, then kRZBenchmarkSamples times. The median is reported,
+ * one line per case, so outputs of two commits can be diffed or joined on the name:
+ *
+ *   <suite>/<case>  <median> ns/op  min <min>  max <max>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "RZNotificationClock.h"
+
+#define kRZBenchmarkSamples 9
+
+typedef void (*RZBenchmarkFunction)(void *context, size_t operations);
+
+/*
+ * Keeps results alive so that the compiler does not remove benchmarked calls
+ */
+static volatile double RZBenchmarkSink = 0.0;
+
+static inline int RZBenchmarkCompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return x < y ? -1 : (x > y);
+}
+
+/*
+ * setUp and tearDown run around each sample, outside of the measure. They can be NULL
+ */
+static inline void RZBenchmarkRunWithSetUp(const char *suite, const char *name,
+                                           RZBenchmarkFunction setUp, RZBenchmarkFunction body, RZBenchmarkFunction tearDown,
+                                           void *context, size_t operations)
+{
+    double samples[kRZBenchmarkSamples];
+
+    for (int sample = -1; sample < kRZBenchmarkSamples; sample++) {
+        if (setUp) {
+            setUp(context, operations);
+        }
+        double start = RZNotificationMonotonicTime(NULL);
+        body(context, operations);
+        double elapsed = RZNotificationMonotonicTime(NULL) - start;
+        if (tearDown) {
+            tearDown(context, operations);
+        }
+        // Sample -1 is the warm up
+        if (sample >= 0) {
+            samples[sample] = elapsed * 1e9 / (double)operations;
+        }
+    }
+
+    qsort(samples, kRZBenchmarkSamples, sizeof(double), RZBenchmarkCompareDouble);
+    char label[128];
+    snprintf(label, sizeof(label), "%s/%s", suite, name);
+    printf("%-48s %10.2f ns/op  min %10.2f  max %10.2f\n", label,
+           samples[kRZBenchmarkSamples / 2], samples[0], samples[kRZBenchmarkSamples - 1]);
+    fflush(stdout);
+}
+
+static inline void RZBenchmarkRun(const char *suite, const char *name, RZBenchmarkFunction body, void *context, size_t operations)
+{
+    RZBenchmarkRunWithSetUp(suite, name, NULL, body, NULL, context, operations);
+}
+
+#endif
@@ -0,0 +1,47 @@
+//
+//  RZNotificationColorMathBenchmark.c
+//  RZNotificationViewBenchmarks
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationColorMath.h"
+#include "RZNotificationBenchmark.h"
+
+#define kIterations 1000000
+
+static void lighter(void *context, size_t operations)
+{
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationRGBA color = RZNotificationRGBAFromHex((uint32_t)i & 0xFFFFFF);
+        RZBenchmarkSink += RZNotificationRGBALighter(color, 0.1, 0.0).red;
+    }
+}
+
+static void darker(void *context, size_t operations)
+{
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationRGBA color = RZNotificationRGBAFromHex((uint32_t)i & 0xFFFFFF);
+        RZBenchmarkSink += RZNotificationRGBADarker(color, 0.55, 0.6).green;
+    }
+}
+
+static void paletteLookup(void *context, size_t operations)
+{
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        RZBenchmarkSink += RZNotificationPaletteColor((long)(i % RZNotificationPaletteCount),
+                                                      (RZNotificationPaletteRole)(i % RZNotificationPaletteRoleCount)).blue;
+    }
+}
+
+int main(void)
+{
+    RZBenchmarkRun("ColorMath", "lighter", lighter, NULL, kIterations);
+    RZBenchmarkRun("ColorMath", "darker", darker, NULL, kIterations);
+    RZBenchmarkRun("ColorMath", "palette lookup", paletteLookup, NULL, kIterations);
+    return 0;
+}
@@ -0,0 +1,79 @@
+//
+//  RZNotificationLayoutBenchmark.c
+//  RZNotificationViewBenchmarks
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationLayout.h"
+#include "RZNotificationBenchmark.h"
+
+#define kIterations 1000000
+
+static RZNotificationLayoutInput inputForIteration(size_t i)
+{
+    RZNotificationLayoutInput input;
+    // Portrait and landscape widths of common devices
+    static const double widths[] = { 320.0, 375.0, 414.0, 568.0, 667.0, 812.0 };
+    input.bounds = RZNotificationRectMake(0.0, 0.0, widths[i % 6], 54.0 + (double)(i % 3) * 20.0);
+    input.topOffset = (i & 1) ? 10.0 : 0.0;
+    input.safeTopInset = (i & 2) ? 24.0 : 0.0;
+    input.safeBottomInset = (i & 4) ? 34.0 : 0.0;
+    input.hasIcon = (int)(i & 8);
+    input.hasAnchor = 1;
+    input.offsetX = 16.0;
+    input.contentMarginHeight = 16.0;
+    input.iconWidth = 21.0;
+    input.iconHeight = 22.0;
+    return input;
+}
+
+static void computeFrames(void *context, size_t operations)
+{
+    RZNotificationLayoutResult result;
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationLayoutInput input = inputForIteration(i);
+        RZNotificationLayoutCompute(&input, &result);
+        RZBenchmarkSink += result.contentFrame.width;
+    }
+}
+
+static void heightForContent(void *context, size_t operations)
+{
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationLayoutInput input = inputForIteration(i);
+        RZBenchmarkSink += RZNotificationLayoutHeightForContentHeight(&input, (double)(i % 80), 54.0);
+    }
+}
+
+static void applyInsets(void *context, size_t operations)
+{
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationLayoutInput input = inputForIteration(i);
+        RZNotificationInsetsInput insets = { (int)(i & 1), (int)(i & 2), (int)(i & 4), 20.0, 44.0, 34.0 };
+        RZNotificationLayoutApplyInsets(&insets, &input);
+        RZBenchmarkSink += input.safeTopInset;
+    }
+}
+
+static void verticalPosition(void *context, size_t operations)
+{
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationOriginInput origin = { (int)(i & 1), 812.0, 88.0, 83.0, 34.0, (int)(i & 2), 300.0, 74.0 };
+        RZBenchmarkSink += RZNotificationLayoutShownY(&origin) + RZNotificationLayoutHiddenY(&origin);
+    }
+}
+
+int main(void)
+{
+    RZBenchmarkRun("Layout", "compute frames", computeFrames, NULL, kIterations);
+    RZBenchmarkRun("Layout", "height for content", heightForContent, NULL, kIterations);
+    RZBenchmarkRun("Layout", "apply insets", applyInsets, NULL, kIterations);
+    RZBenchmarkRun("Layout", "shown and hidden y", verticalPosition, NULL, kIterations);
+    return 0;
+}
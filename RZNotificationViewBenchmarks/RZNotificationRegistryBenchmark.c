@@ -0,0 +1,147 @@
+//
+//  RZNotificationRegistryBenchmark.c
+//  RZNotificationViewBenchmarks
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationRegistry.h"
+#include "RZNotificationBenchmark.h"
+
+#define kNotificationCount 4000
+#define kControllerCount 16
+#define kWindow 1
+
+static uint64_t controllerForNotification(uint64_t notification)
+{
+    return 100 + notification % kControllerCount;
+}
+
+// MARK: - Registry
+
+static void createRegistry(void *context, size_t operations)
+{
+    (void)operations;
+    *(RZNotificationRegistry **)context = RZNotificationRegistryCreate();
+}
+
+static void insertNotifications(void *context, size_t operations)
+{
+    RZNotificationRegistry *registry = *(RZNotificationRegistry **)context;
+    for (uint64_t i = 1; i <= operations; i++) {
+        RZNotificationRegistryInsert(registry, i, kWindow, controllerForNotification(i));
+    }
+}
+
+static void createFilledRegistry(void *context, size_t operations)
+{
+    createRegistry(context, operations);
+    insertNotifications(context, operations);
+}
+
+static void destroyRegistry(void *context, size_t operations)
+{
+    (void)operations;
+    RZNotificationRegistryDestroy(*(RZNotificationRegistry **)context);
+}
+
+static void lastForController(void *context, size_t operations)
+{
+    RZNotificationRegistry *registry = *(RZNotificationRegistry **)context;
+    for (uint64_t i = 0; i < operations; i++) {
+        RZBenchmarkSink += (double)RZNotificationRegistryLastForController(registry, controllerForNotification(i));
+    }
+}
+
+static void removeNotifications(void *context, size_t operations)
+{
+    RZNotificationRegistry *registry = *(RZNotificationRegistry **)context;
+    // Registration order, the worst case for arrays
+    for (uint64_t i = 1; i <= operations; i++) {
+        RZNotificationRegistryRemove(registry, i);
+    }
+}
+
+// MARK: - Array baseline
+
+/*
+ * One array scanned on every lookup, like the former rzNotifications + NSPredicate implementation
+ */
+typedef struct {
+    uint64_t notification;
+    uint64_t controller;
+} RZArrayEntry;
+
+typedef struct {
+    RZArrayEntry entries[kNotificationCount];
+    size_t count;
+} RZArrayRegistry;
+
+static void clearArray(void *context, size_t operations)
+{
+    (void)operations;
+    ((RZArrayRegistry *)context)->count = 0;
+}
+
+static void arrayInsert(void *context, size_t operations)
+{
+    RZArrayRegistry *array = context;
+    for (uint64_t i = 1; i <= operations; i++) {
+        array->entries[array->count].notification = i;
+        array->entries[array->count].controller = controllerForNotification(i);
+        array->count++;
+    }
+}
+
+static void fillArray(void *context, size_t operations)
+{
+    clearArray(context, operations);
+    arrayInsert(context, operations);
+}
+
+static void arrayLastForController(void *context, size_t operations)
+{
+    RZArrayRegistry *array = context;
+    for (uint64_t i = 0; i < operations; i++) {
+        uint64_t controller = controllerForNotification(i);
+        uint64_t last = 0;
+        for (size_t j = 0; j < array->count; j++) {
+            if (array->entries[j].controller == controller) {
+                last = array->entries[j].notification;
+            }
+        }
+        RZBenchmarkSink += (double)last;
+    }
+}
+
+static void arrayRemove(void *context, size_t operations)
+{
+    RZArrayRegistry *array = context;
+    for (uint64_t i = 1; i <= operations; i++) {
+        for (size_t j = 0; j < array->count; j++) {
+            if (array->entries[j].notification == i) {
+                for (size_t k = j + 1; k < array->count; k++) {
+                    array->entries[k - 1] = array->entries[k];
+                }
+                array->count--;
+                break;
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    static RZNotificationRegistry *registry;
+    static RZArrayRegistry array;
+
+    RZBenchmarkRunWithSetUp("Registry", "insert", createRegistry, insertNotifications, destroyRegistry, &registry, kNotificationCount);
+    RZBenchmarkRunWithSetUp("Registry", "last for controller", createFilledRegistry, lastForController, destroyRegistry, &registry, kNotificationCount);
+    RZBenchmarkRunWithSetUp("Registry", "remove", createFilledRegistry, removeNotifications, destroyRegistry, &registry, kNotificationCount);
+
+    RZBenchmarkRunWithSetUp("Registry", "array insert (baseline)", clearArray, arrayInsert, NULL, &array, kNotificationCount);
+    RZBenchmarkRunWithSetUp("Registry", "array last for controller (baseline)", fillArray, arrayLastForController, NULL, &array, kNotificationCount);
+    RZBenchmarkRunWithSetUp("Registry", "array remove (baseline)", fillArray, arrayRemove, NULL, &array, kNotificationCount);
+    return 0;
+}
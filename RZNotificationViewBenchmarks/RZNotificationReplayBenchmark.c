@@ -0,0 +1,211 @@
+//
+//  RZNotificationReplayBenchmark.c
+//  RZNotificationViewBenchmarks
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+//  Without argument, replays synthetic notification storms at full speed.
+//  With a log written by +[RZNotificationView writeEventLogToPath:], replays it:
+//
+//    RZNotificationReplayBenchmark <log> [--real-time]
+//
+
+#include "RZNotificationReplay.h"
+#include "RZNotificationBenchmark.h"
+
+#include <string.h>
+
+#define kContainerCount 8
+
+typedef struct {
+    RZNotificationEventLog *log;
+    RZNotificationReplayConfig config;
+    RZNotificationReplayReport report;
+} RZReplayContext;
+
+// Same storms on every run
+static uint32_t nextRandom(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static double randomUnit(uint32_t *state)
+{
+    return (double)nextRandom(state) / (double)(1u << 24);
+}
+
+static RZNotificationEvent makeShow(double timestamp, uint64_t notification, uint64_t container)
+{
+    RZNotificationEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = RZNotificationEventShow;
+    event.timestamp = timestamp;
+    event.notification = notification;
+    event.container = container;
+    event.duration = 3.5;
+    event.width = 320.0;
+    event.height = 54.0;
+    return event;
+}
+
+// A sync completes: thousands of "new item" notifications within half a second
+static RZNotificationEventLog *syncBurst(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    uint32_t state = 1;
+    for (uint64_t i = 0; i < 4000; i++) {
+        RZNotificationEvent event = makeShow(0.5 * (double)i / 4000.0, i + 1, 1);
+        event.coalescingKey = 1 + nextRandom(&state) % 16;
+        event.priority = (int)(nextRandom(&state) % 3);
+        RZNotificationEventLogAppend(log, &event);
+    }
+    return log;
+}
+
+// Chat rooms in several containers, touched and dismissed by the user
+static RZNotificationEventLog *chat(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    uint32_t state = 2;
+    double time = 0.0;
+    for (uint64_t i = 0; i < 20000; i++) {
+        time += 0.01 * randomUnit(&state);
+        uint64_t notification = 1 + nextRandom(&state) % 512;
+        uint64_t container = 1 + nextRandom(&state) % kContainerCount;
+        RZNotificationEvent event = makeShow(time, notification, container);
+        event.bottom = (int)(notification & 1);
+        event.duration = 1.0 + 4.0 * randomUnit(&state);
+        switch (nextRandom(&state) % 8) {
+            case 0:
+                event.type = RZNotificationEventTouch;
+                break;
+            case 1:
+                event.type = RZNotificationEventHide;
+                break;
+            default:
+                break;
+        }
+        RZNotificationEventLogAppend(log, &event);
+    }
+    return log;
+}
+
+// The device rotates back and forth while stacked notifications keep coming
+static RZNotificationEventLog *rotationDuringBurst(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    uint32_t state = 3;
+    for (uint64_t i = 0; i < 2000; i++) {
+        double time = (double)i / 1000.0;
+        RZNotificationEvent event = makeShow(time, i + 1, 1 + i % 2);
+        event.bottom = (int)(nextRandom(&state) & 1);
+        event.duration = 0.5 + randomUnit(&state);
+        RZNotificationEventLogAppend(log, &event);
+        if (i % 50 == 49) {
+            int landscape = (int)(i / 50) & 1;
+            for (uint64_t container = 1; container <= 2; container++) {
+                RZNotificationEvent rotate;
+                memset(&rotate, 0, sizeof(rotate));
+                rotate.type = RZNotificationEventRotate;
+                rotate.timestamp = time;
+                rotate.container = container;
+                rotate.width = landscape ? 568.0 : 320.0;
+                rotate.height = landscape ? 320.0 : 568.0;
+                RZNotificationEventLogAppend(log, &rotate);
+            }
+        }
+    }
+    return log;
+}
+
+// Replayed from the file format, like a recorded log
+static RZNotificationEventLog *roundTrip(RZNotificationEventLog *log)
+{
+    FILE *file = tmpfile();
+    RZNotificationEventLog *read = NULL;
+    if (file != NULL && RZNotificationEventLogWrite(log, file)) {
+        rewind(file);
+        read = RZNotificationEventLogRead(file);
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+    RZNotificationEventLogDestroy(log);
+    return read;
+}
+
+static void replay(void *context, size_t operations)
+{
+    RZReplayContext *c = context;
+    (void)operations;
+    RZNotificationReplayRun(c->log, &c->config, &c->report);
+    RZBenchmarkSink += (double)c->report.shown;
+}
+
+static void runStorm(const char *name, RZNotificationEventLog *log, RZNotificationReplayConfig config)
+{
+    static RZReplayContext context;
+    context.log = roundTrip(log);
+    context.config = config;
+    if (context.log == NULL) {
+        fprintf(stderr, "%s: could not write the log\n", name);
+        return;
+    }
+    RZBenchmarkRun("Replay", name, replay, &context, RZNotificationEventLogCount(context.log));
+    // Reports on stderr, the output stays diffable
+    RZNotificationReplayReportPrint(&context.report, stderr);
+    RZNotificationEventLogDestroy(context.log);
+}
+
+static int replayFile(const char *path, int realTime)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "%s: could not open the file\n", path);
+        return 1;
+    }
+    RZNotificationEventLog *log = RZNotificationEventLogRead(file);
+    fclose(file);
+    if (log == NULL) {
+        fprintf(stderr, "%s: not an event log\n", path);
+        return 1;
+    }
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    config.realTime = realTime;
+    RZNotificationReplayReport report;
+    int replayed = RZNotificationReplayRun(log, &config, &report);
+    printf("%zu events\n", RZNotificationEventLogCount(log));
+    RZNotificationReplayReportPrint(&report, stdout);
+    RZNotificationEventLogDestroy(log);
+    return replayed ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        return replayFile(argv[1], argc > 2 && strcmp(argv[2], "--real-time") == 0);
+    }
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    config.maxVisible = 3;
+    config.reusePoolSize = 8;
+    runStorm("sync burst", syncBurst(), config);
+    config.coalesce = 1;
+    runStorm("sync burst, coalesced", syncBurst(), config);
+
+    config = RZNotificationReplayDefaultConfig();
+    config.reusePoolSize = 8;
+    runStorm("chat, 8 containers", chat(), config);
+    config.reusePoolSize = 0;
+    runStorm("chat, no reuse (baseline)", chat(), config);
+
+    config = RZNotificationReplayDefaultConfig();
+    config.stack = 1;
+    config.stackMaxVisible = 4;
+    config.reusePoolSize = 8;
+    runStorm("rotation during burst, stacked", rotationDuringBurst(), config);
+    return 0;
+}
@@ -0,0 +1,203 @@
+//
+//  RZNotificationRequestQueueBenchmark.c
+//  RZNotificationViewBenchmarks
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationRequestQueue.h"
+#include "RZNotificationBenchmark.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+
+#define kRequestCount 400000
+#define kQueueCapacity 1024
+#define kMaxProducerCount 4
+
+typedef struct RZQueueContext RZQueueContext;
+
+typedef struct {
+    RZQueueContext *context;
+    size_t count;
+} RZProducer;
+
+struct RZQueueContext {
+    RZNotificationRequestQueue *queue;
+    size_t producerCount;
+    RZProducer producers[kMaxProducerCount];
+    size_t received;
+};
+
+static void countRequest(void *request, void *context)
+{
+    RZQueueContext *c = context;
+    RZBenchmarkSink += (double)(uintptr_t)request;
+    c->received++;
+}
+
+static void createQueue(void *context, size_t operations)
+{
+    RZQueueContext *c = context;
+    (void)operations;
+    c->queue = RZNotificationRequestQueueCreate(kQueueCapacity);
+    c->received = 0;
+}
+
+static void destroyQueue(void *context, size_t operations)
+{
+    RZQueueContext *c = context;
+    (void)operations;
+    RZNotificationRequestQueueDestroy(c->queue);
+}
+
+static void pushAndDrain(void *context, size_t operations)
+{
+    RZQueueContext *c = context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationRequestQueuePush(c->queue, (void *)(uintptr_t)(i + 1));
+        // Batches like the frames of the main thread
+        if ((i & 63) == 63) {
+            RZNotificationRequestQueueDrain(c->queue, 0, countRequest, c);
+        }
+    }
+    RZNotificationRequestQueueDrain(c->queue, 0, countRequest, c);
+}
+
+static void *produce(void *argument)
+{
+    RZProducer *producer = argument;
+    for (size_t i = 0; i < producer->count; i++) {
+        while (RZNotificationRequestQueuePush(producer->context->queue, (void *)(uintptr_t)(i + 1)) == RZNotificationRequestQueueFull) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Thread creation is part of the measure, amortized over the requests
+static void concurrentProducers(void *context, size_t operations)
+{
+    RZQueueContext *c = context;
+    pthread_t threads[kMaxProducerCount];
+    for (size_t i = 0; i < c->producerCount; i++) {
+        c->producers[i].context = c;
+        c->producers[i].count = operations / c->producerCount;
+        pthread_create(&threads[i], NULL, produce, &c->producers[i]);
+    }
+    size_t expected = c->producers[0].count * c->producerCount;
+    while (c->received < expected) {
+        if (RZNotificationRequestQueueDrain(c->queue, 0, countRequest, c) == 0) {
+            sched_yield();
+        }
+    }
+    for (size_t i = 0; i < c->producerCount; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+// MARK: - Mutex baseline
+
+typedef struct RZLockedContext RZLockedContext;
+
+typedef struct {
+    RZLockedContext *context;
+    size_t count;
+} RZLockedProducer;
+
+struct RZLockedContext {
+    pthread_mutex_t mutex;
+    void *requests[kQueueCapacity];
+    size_t head;
+    size_t tail;
+    size_t producerCount;
+    RZLockedProducer producers[kMaxProducerCount];
+    size_t received;
+};
+
+static int lockedPush(RZLockedContext *c, void *request)
+{
+    pthread_mutex_lock(&c->mutex);
+    int pushed = (c->tail - c->head < kQueueCapacity);
+    if (pushed) {
+        c->requests[c->tail++ % kQueueCapacity] = request;
+    }
+    pthread_mutex_unlock(&c->mutex);
+    return pushed;
+}
+
+static size_t lockedDrain(RZLockedContext *c)
+{
+    size_t count = 0;
+    pthread_mutex_lock(&c->mutex);
+    while (c->head < c->tail) {
+        RZBenchmarkSink += (double)(uintptr_t)c->requests[c->head++ % kQueueCapacity];
+        count++;
+    }
+    pthread_mutex_unlock(&c->mutex);
+    c->received += count;
+    return count;
+}
+
+static void resetLocked(void *context, size_t operations)
+{
+    RZLockedContext *c = context;
+    (void)operations;
+    c->head = c->tail = 0;
+    c->received = 0;
+}
+
+static void *lockedProduce(void *argument)
+{
+    RZLockedProducer *producer = argument;
+    for (size_t i = 0; i < producer->count; i++) {
+        while (!lockedPush(producer->context, (void *)(uintptr_t)(i + 1))) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void lockedConcurrentProducers(void *context, size_t operations)
+{
+    RZLockedContext *c = context;
+    pthread_t threads[kMaxProducerCount];
+    for (size_t i = 0; i < c->producerCount; i++) {
+        c->producers[i].context = c;
+        c->producers[i].count = operations / c->producerCount;
+        pthread_create(&threads[i], NULL, lockedProduce, &c->producers[i]);
+    }
+    size_t expected = c->producers[0].count * c->producerCount;
+    while (c->received < expected) {
+        if (lockedDrain(c) == 0) {
+            sched_yield();
+        }
+    }
+    for (size_t i = 0; i < c->producerCount; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+int main(void)
+{
+    static RZQueueContext context;
+    static RZLockedContext locked;
+    pthread_mutex_init(&locked.mutex, NULL);
+
+    RZBenchmarkRunWithSetUp("RequestQueue", "push + drain, 1 thread", createQueue, pushAndDrain, destroyQueue, &context, kRequestCount);
+
+    context.producerCount = 1;
+    RZBenchmarkRunWithSetUp("RequestQueue", "1 producer", createQueue, concurrentProducers, destroyQueue, &context, kRequestCount);
+    context.producerCount = kMaxProducerCount;
+    RZBenchmarkRunWithSetUp("RequestQueue", "4 producers", createQueue, concurrentProducers, destroyQueue, &context, kRequestCount);
+
+    locked.producerCount = 1;
+    RZBenchmarkRunWithSetUp("RequestQueue", "mutex 1 producer (baseline)", resetLocked, lockedConcurrentProducers, NULL, &locked, kRequestCount);
+    locked.producerCount = kMaxProducerCount;
+    RZBenchmarkRunWithSetUp("RequestQueue", "mutex 4 producers (baseline)", resetLocked, lockedConcurrentProducers, NULL, &locked, kRequestCount);
+
+    pthread_mutex_destroy(&locked.mutex);
+    return 0;
+}
@@ -0,0 +1,91 @@
+//
+//  RZNotificationSchedulerBenchmark.c
+//  RZNotificationViewBenchmarks
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationScheduler.h"
+#include "RZNotificationBenchmark.h"
+
+#define kRequestCount 100000
+
+typedef struct {
+    RZNotificationScheduler *scheduler;
+    uint64_t identifiers[kRequestCount];
+    double now;
+    int coalesce;
+} RZSchedulerContext;
+
+static double fakeNow(void *context)
+{
+    return *(double *)context;
+}
+
+static void createScheduler(void *context, size_t operations)
+{
+    RZSchedulerContext *c = context;
+    RZNotificationSchedulerConfig config = RZNotificationSchedulerDefaultConfig();
+    (void)operations;
+    c->now = 0.0;
+    config.coalesce = c->coalesce;
+    config.clock.now = fakeNow;
+    config.clock.context = &c->now;
+    c->scheduler = RZNotificationSchedulerCreate(&config);
+}
+
+static void submit(void *context, size_t operations)
+{
+    RZSchedulerContext *c = context;
+    for (size_t i = 0; i < operations; i++) {
+        // A few priorities, 1 key out of 4 repeated when coalescing
+        uint64_t key = c->coalesce ? (i & 3 ? i + 1 : 1) : 0;
+        RZNotificationSchedulerSubmit(c->scheduler, key, (int)(i % 5), &c->identifiers[i]);
+    }
+}
+
+static void createSchedulerWithRequests(void *context, size_t operations)
+{
+    createScheduler(context, operations);
+    submit(context, operations);
+}
+
+static void destroyScheduler(void *context, size_t operations)
+{
+    RZSchedulerContext *c = context;
+    (void)operations;
+    RZNotificationSchedulerDestroy(c->scheduler);
+}
+
+static void drainAndHide(void *context, size_t operations)
+{
+    RZSchedulerContext *c = context;
+    RZNotificationScheduledRequest request;
+    (void)operations;
+    while (RZNotificationSchedulerNext(c->scheduler, &request)) {
+        RZNotificationSchedulerDidHide(c->scheduler, request.identifier);
+    }
+}
+
+static void cancelPending(void *context, size_t operations)
+{
+    RZSchedulerContext *c = context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationSchedulerCancel(c->scheduler, c->identifiers[i]);
+    }
+}
+
+int main(void)
+{
+    static RZSchedulerContext context;
+
+    context.coalesce = 0;
+    RZBenchmarkRunWithSetUp("Scheduler", "submit", createScheduler, submit, destroyScheduler, &context, kRequestCount);
+    RZBenchmarkRunWithSetUp("Scheduler", "next + did hide", createSchedulerWithRequests, drainAndHide, destroyScheduler, &context, kRequestCount);
+    RZBenchmarkRunWithSetUp("Scheduler", "cancel pending", createSchedulerWithRequests, cancelPending, destroyScheduler, &context, kRequestCount);
+
+    context.coalesce = 1;
+    RZBenchmarkRunWithSetUp("Scheduler", "submit coalescing", createScheduler, submit, destroyScheduler, &context, kRequestCount);
+    return 0;
+}
@@ -0,0 +1,103 @@
+//
+//  RZNotificationTimerWheelBenchmark.c
+//  RZNotificationViewBenchmarks
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationTimerWheel.h"
+#include "RZNotificationBenchmark.h"
+
+#define kTimerCount 100000
+
+typedef struct {
+    RZNotificationTimerWheel *wheel;
+    uint64_t identifiers[kTimerCount];
+    double now;
+} RZTimerWheelContext;
+
+static double fakeNow(void *context)
+{
+    return *(double *)context;
+}
+
+static void createWheel(void *context, size_t operations)
+{
+    RZTimerWheelContext *c = context;
+    RZNotificationClock clock = { fakeNow, &c->now };
+    (void)operations;
+    c->now = 0.0;
+    c->wheel = RZNotificationTimerWheelCreate(&clock, 0.0, 0);
+}
+
+static void scheduleTimers(void *context, size_t operations)
+{
+    RZTimerWheelContext *c = context;
+    srand(42);
+    for (size_t i = 0; i < operations; i++) {
+        // Typical notification durations, up to 10 s
+        c->identifiers[i] = RZNotificationTimerWheelSchedule(c->wheel, (double)(rand() % 10000) / 1000.0);
+    }
+}
+
+static void createWheelWithTimers(void *context, size_t operations)
+{
+    createWheel(context, operations);
+    scheduleTimers(context, operations);
+}
+
+static void destroyWheel(void *context, size_t operations)
+{
+    RZTimerWheelContext *c = context;
+    (void)operations;
+    RZNotificationTimerWheelDestroy(c->wheel);
+}
+
+static void cancelTimers(void *context, size_t operations)
+{
+    RZTimerWheelContext *c = context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationTimerWheelCancel(c->wheel, c->identifiers[i]);
+    }
+}
+
+static void pauseAndResumeTimers(void *context, size_t operations)
+{
+    RZTimerWheelContext *c = context;
+    for (size_t i = 0; i < operations; i++) {
+        RZNotificationTimerWheelPauseTimer(c->wheel, c->identifiers[i]);
+        RZNotificationTimerWheelResumeTimer(c->wheel, c->identifiers[i]);
+    }
+}
+
+static void nextDeadline(void *context, size_t operations)
+{
+    RZTimerWheelContext *c = context;
+    for (size_t i = 0; i < operations; i++) {
+        RZBenchmarkSink += RZNotificationTimerWheelNextDeadline(c->wheel);
+    }
+}
+
+static void advanceUntilEmpty(void *context, size_t operations)
+{
+    RZTimerWheelContext *c = context;
+    (void)operations;
+    // One advance per display frame
+    while (RZNotificationTimerWheelCount(c->wheel) > 0) {
+        c->now += 1.0 / 60.0;
+        RZNotificationTimerWheelAdvance(c->wheel, NULL, NULL);
+    }
+}
+
+int main(void)
+{
+    static RZTimerWheelContext context;
+
+    RZBenchmarkRunWithSetUp("TimerWheel", "schedule", createWheel, scheduleTimers, destroyWheel, &context, kTimerCount);
+    RZBenchmarkRunWithSetUp("TimerWheel", "cancel", createWheelWithTimers, cancelTimers, destroyWheel, &context, kTimerCount);
+    RZBenchmarkRunWithSetUp("TimerWheel", "pause+resume", createWheelWithTimers, pauseAndResumeTimers, destroyWheel, &context, kTimerCount);
+    RZBenchmarkRunWithSetUp("TimerWheel", "next deadline", createWheelWithTimers, nextDeadline, destroyWheel, &context, 1000);
+    RZBenchmarkRunWithSetUp("TimerWheel", "advance (per fired timer)", createWheelWithTimers, advanceUntilEmpty, destroyWheel, &context, kTimerCount);
+    return 0;
+}
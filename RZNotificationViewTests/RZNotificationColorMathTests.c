@@ -0,0 +1,83 @@
+//
+//  RZNotificationColorMathTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationColorMath.h"
+#include "RZNotificationTestMacros.h"
+
+static const uint32_t kPaletteHex[RZNotificationPaletteCount] = {
+    0xFFBD00, 0xB20000, 0x3699C9, 0x395799, 0x704081, 0xD35400, 0xA29C8E
+};
+
+static void testHexAndComponents(void)
+{
+    RZNotificationRGBA color = RZNotificationRGBAFromHex(0x3699C9);
+    RZAssertEqualDouble(color.red, 0x36 / 255.0, "red");
+    RZAssertEqualDouble(color.green, 0x99 / 255.0, "green");
+    RZAssertEqualDouble(color.blue, 0xC9 / 255.0, "blue");
+    RZAssertEqualDouble(color.alpha, 1.0, "opaque");
+
+    double grey[] = { 0.3, 0.5 };
+    color = RZNotificationRGBAFromComponents(grey, 2);
+    RZAssert(RZNotificationRGBAEqual(color, RZNotificationRGBAMake(0.3, 0.3, 0.3, 0.5)), "greyscale expanded");
+
+    double rgba[] = { 0.1, 0.2, 0.3, 0.4 };
+    color = RZNotificationRGBAFromComponents(rgba, 4);
+    RZAssert(RZNotificationRGBAEqual(color, RZNotificationRGBAMake(0.1, 0.2, 0.3, 0.4)), "rgba copied");
+    RZAssert(RZNotificationRGBAEqual(RZNotificationRGBAFromComponents(rgba, 3), RZNotificationRGBAMake(0.0, 0.0, 0.0, 1.0)), "unknown layout");
+}
+
+static void testLighterAndDarker(void)
+{
+    RZNotificationRGBA color = RZNotificationRGBAMake(0.2, 0.5, 0.95, 0.8);
+
+    RZNotificationRGBA lighter = RZNotificationRGBALighter(color, 0.1, 0.3);
+    RZAssertEqualDouble(lighter.red, 0.3, "red lighter");
+    RZAssertEqualDouble(lighter.green, 0.6, "green lighter");
+    RZAssertEqualDouble(lighter.blue, 1.0, "blue clamped");
+    RZAssertEqualDouble(lighter.alpha, 0.5, "alpha lowered");
+
+    RZNotificationRGBA darker = RZNotificationRGBADarker(color, 0.3, 0.5);
+    RZAssertEqualDouble(darker.red, 0.0, "red clamped");
+    RZAssertEqualDouble(darker.green, 0.2, "green darker");
+    RZAssertEqualDouble(darker.blue, 0.65, "blue darker");
+    RZAssertEqualDouble(darker.alpha, 1.0, "alpha clamped");
+
+    RZAssertEqualDouble(RZNotificationRGBAAlphaOffset(color, 0.6), 0.2, "offset down");
+    RZAssertEqualDouble(RZNotificationRGBAAlphaOffset(color, 1.0), 0.2, "offset up");
+}
+
+static void testPaletteMatchesKernels(void)
+{
+    for (long i = 0; i < RZNotificationPaletteCount; i++) {
+        RZNotificationRGBA start = RZNotificationRGBAFromHex(kPaletteHex[i]);
+        RZAssert(RZNotificationRGBAEqual(RZNotificationPaletteColor(i, RZNotificationPaletteRoleStart), start), "start");
+        RZAssert(RZNotificationRGBAEqual(RZNotificationPaletteColor(i, RZNotificationPaletteRoleStroke),
+                                         RZNotificationRGBALighter(start, 0.1, 0.0)), "stroke");
+        RZAssert(RZNotificationRGBAEqual(RZNotificationPaletteColor(i, RZNotificationPaletteRoleTextAutomaticDark),
+                                         RZNotificationRGBADarker(start, 0.55, 0.0)), "automatic dark text");
+        RZAssert(RZNotificationRGBAEqual(RZNotificationPaletteColor(i, RZNotificationPaletteRoleTextAutomaticLight),
+                                         RZNotificationRGBALighter(start, 0.9, 0.0)), "automatic light text");
+    }
+}
+
+static void testPaletteFallback(void)
+{
+    RZNotificationRGBA grey = RZNotificationPaletteColor(RZNotificationPaletteCount - 1, RZNotificationPaletteRoleStart);
+    RZAssert(RZNotificationRGBAEqual(RZNotificationPaletteColor(-1, RZNotificationPaletteRoleStart), grey), "negative index");
+    RZAssert(RZNotificationRGBAEqual(RZNotificationPaletteColor(42, RZNotificationPaletteRoleStart), grey), "unknown index");
+    RZAssert(RZNotificationRGBAEqual(RZNotificationPaletteColor(0, RZNotificationPaletteRoleCount), RZNotificationRGBAFromHex(0xFFBD00)), "unknown role");
+}
+
+int main(void)
+{
+    RZRunTest(testHexAndComponents);
+    RZRunTest(testLighterAndDarker);
+    RZRunTest(testPaletteMatchesKernels);
+    RZRunTest(testPaletteFallback);
+    return RZTestFailures == 0 ? 0 : 1;
+}
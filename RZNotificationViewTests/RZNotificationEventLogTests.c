@@ -0,0 +1,152 @@
+//
+//  RZNotificationEventLogTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationEventLog.h"
+#include "RZNotificationTestMacros.h"
+
+#include <string.h>
+
+static double fakeNow(void *context)
+{
+    return *(double *)context;
+}
+
+static RZNotificationEvent makeEvent(RZNotificationEventType type, uint64_t notification)
+{
+    RZNotificationEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.notification = notification;
+    event.container = 0xC0FFEE;
+    return event;
+}
+
+static void testRecordStampsEvents(void)
+{
+    double now = 10.0;
+    RZNotificationClock clock = { fakeNow, &now };
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(&clock);
+
+    RZNotificationEvent event = makeEvent(RZNotificationEventShow, 1);
+    event.timestamp = 99.0;
+    now = 10.5;
+    RZAssert(RZNotificationEventLogRecord(log, &event), "recorded");
+    now = 11.0;
+    event = makeEvent(RZNotificationEventHide, 1);
+    RZAssert(RZNotificationEventLogRecord(log, &event), "recorded");
+
+    const RZNotificationEvent *events = RZNotificationEventLogEvents(log);
+    RZAssert(RZNotificationEventLogCount(log) == 2, "two events");
+    RZAssertEqualDouble(events[0].timestamp, 0.5, "since the log started");
+    RZAssertEqualDouble(events[1].timestamp, 1.0, "since the log started");
+
+    event.timestamp = 0.2;
+    RZAssert(!RZNotificationEventLogAppend(log, &event), "out of order");
+
+    now = 20.0;
+    RZNotificationEventLogClear(log);
+    now = 20.25;
+    RZNotificationEventLogRecord(log, &event);
+    RZAssert(RZNotificationEventLogCount(log) == 1, "cleared");
+    RZAssertEqualDouble(RZNotificationEventLogEvents(log)[0].timestamp, 0.25, "clock restarted");
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testWriteAndRead(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    RZNotificationEvent show = makeEvent(RZNotificationEventShow, 0x7f00deadbeef);
+    show.timestamp = 0.125;
+    show.coalescingKey = UINT64_MAX;
+    show.priority = -3;
+    show.bottom = 1;
+    show.duration = 3.5;
+    show.width = 320.0;
+    show.height = 54.0;
+    RZNotificationEvent hide = makeEvent(RZNotificationEventHide, 0x7f00deadbeef);
+    hide.timestamp = 3.625;
+    hide.flags = RZNotificationEventFlagExpired;
+    RZNotificationEvent rotate = makeEvent(RZNotificationEventRotate, 0);
+    rotate.timestamp = 4.0;
+    rotate.width = 568.0;
+    rotate.height = 320.0;
+    RZNotificationEventLogAppend(log, &show);
+    RZNotificationEventLogAppend(log, &hide);
+    RZNotificationEventLogAppend(log, &rotate);
+
+    FILE *file = tmpfile();
+    RZAssert(RZNotificationEventLogWrite(log, file), "written");
+    RZAssert(ftell(file) == 16 + 3 * 56, "header and fixed size records");
+    rewind(file);
+    RZNotificationEventLog *read = RZNotificationEventLogRead(file);
+    fclose(file);
+
+    RZAssert(read != NULL && RZNotificationEventLogCount(read) == 3, "every event read");
+    if (read != NULL) {
+        const RZNotificationEvent *events = RZNotificationEventLogEvents(read);
+        RZAssert(events[0].type == RZNotificationEventShow && events[0].notification == 0x7f00deadbeef, "show");
+        RZAssert(events[0].coalescingKey == UINT64_MAX && events[0].priority == -3 && events[0].bottom, "show parameters");
+        RZAssertEqualDouble(events[0].timestamp, 0.125, "timestamp");
+        RZAssertEqualDouble(events[0].duration, 3.5, "duration");
+        RZAssertEqualDouble(events[0].width, 320.0, "width");
+        RZAssert(events[1].type == RZNotificationEventHide && events[1].flags == RZNotificationEventFlagExpired, "expired hide");
+        RZAssert(events[2].type == RZNotificationEventRotate && events[2].container == 0xC0FFEE, "rotate");
+        RZAssertEqualDouble(events[2].height, 320.0, "container height");
+    }
+    RZNotificationEventLogDestroy(read);
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testRejectInvalidFiles(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    RZNotificationEvent event = makeEvent(RZNotificationEventTouch, 2);
+    RZNotificationEventLogAppend(log, &event);
+    RZNotificationEventLogAppend(log, &event);
+
+    unsigned char bytes[16 + 2 * 56];
+    FILE *file = tmpfile();
+    RZNotificationEventLogWrite(log, file);
+    rewind(file);
+    RZAssert(fread(bytes, sizeof(bytes), 1, file) == 1, "whole log");
+    fclose(file);
+
+    // Truncated in the middle of the second record
+    file = tmpfile();
+    fwrite(bytes, sizeof(bytes) - 10, 1, file);
+    rewind(file);
+    RZAssert(RZNotificationEventLogRead(file) == NULL, "truncated");
+    fclose(file);
+
+    // Not a log
+    bytes[0] = 'X';
+    file = tmpfile();
+    fwrite(bytes, sizeof(bytes), 1, file);
+    rewind(file);
+    RZAssert(RZNotificationEventLogRead(file) == NULL, "bad magic");
+    fclose(file);
+
+    // Unknown event type
+    bytes[0] = 'R';
+    bytes[16] = RZNotificationEventTypeCount;
+    file = tmpfile();
+    fwrite(bytes, sizeof(bytes), 1, file);
+    rewind(file);
+    RZAssert(RZNotificationEventLogRead(file) == NULL, "bad type");
+    fclose(file);
+
+    RZNotificationEventLogDestroy(log);
+}
+
+int main(void)
+{
+    RZRunTest(testRecordStampsEvents);
+    RZRunTest(testWriteAndRead);
+    RZRunTest(testRejectInvalidFiles);
+    return RZTestFailures == 0 ? 0 : 1;
+}
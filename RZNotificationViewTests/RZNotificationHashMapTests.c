@@ -0,0 +1,81 @@
+//
+//  RZNotificationHashMapTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationHashMap.h"
+#include "RZNotificationTestMacros.h"
+
+#include <stdlib.h>
+
+static void testSetGetRemove(void)
+{
+    RZNotificationHashMap *map = RZNotificationHashMapCreate(0);
+    int a = 1, b = 2;
+    void *value = NULL;
+
+    RZAssert(!RZNotificationHashMapGet(map, 42, &value), "empty map");
+    RZAssert(RZNotificationHashMapSet(map, 42, &a), "insert");
+    RZAssert(RZNotificationHashMapGet(map, 42, &value) && value == &a, "lookup");
+    RZAssert(RZNotificationHashMapSet(map, 42, &b), "replace");
+    RZAssert(RZNotificationHashMapCount(map) == 1, "replace keeps count");
+    RZAssert(RZNotificationHashMapRemove(map, 42, &value) && value == &b, "remove returns value");
+    RZAssert(!RZNotificationHashMapGet(map, 42, NULL), "removed");
+    RZAssert(RZNotificationHashMapCount(map) == 0, "empty again");
+
+    RZNotificationHashMapDestroy(map);
+}
+
+static void testMatchesReferenceUnderRandomOperations(void)
+{
+    enum { kKeys = 512, kOperations = 200000 };
+    RZNotificationHashMap *map = RZNotificationHashMapCreate(0);
+    uintptr_t reference[kKeys] = {0};
+    size_t referenceCount = 0;
+    int mismatches = 0;
+
+    srand(1234);
+    for (int i = 0; i < kOperations; i++) {
+        uint64_t key = (uint64_t)(rand() % kKeys);
+        int operation = rand() % 3;
+        if (operation == 0) {
+            uintptr_t value = (uintptr_t)(i + 1);
+            RZNotificationHashMapSet(map, key, (void *)value);
+            if (reference[key] == 0) {
+                referenceCount++;
+            }
+            reference[key] = value;
+        }
+        else if (operation == 1) {
+            int removed = RZNotificationHashMapRemove(map, key, NULL);
+            if (removed != (reference[key] != 0)) {
+                mismatches++;
+            }
+            if (reference[key] != 0) {
+                referenceCount--;
+            }
+            reference[key] = 0;
+        }
+        else {
+            void *value = NULL;
+            int found = RZNotificationHashMapGet(map, key, &value);
+            if (found != (reference[key] != 0) || (found && (uintptr_t)value != reference[key])) {
+                mismatches++;
+            }
+        }
+    }
+
+    RZAssert(mismatches == 0, "map agrees with reference array");
+    RZAssert(RZNotificationHashMapCount(map) == referenceCount, "count agrees with reference array");
+    RZNotificationHashMapDestroy(map);
+}
+
+int main(void)
+{
+    RZRunTest(testSetGetRemove);
+    RZRunTest(testMatchesReferenceUnderRandomOperations);
+    return RZTestFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+//
+//  RZNotificationLayoutTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationLayout.h"
+#include "RZNotificationTestMacros.h"
+
+static RZNotificationLayoutInput defaultInput(void)
+{
+    RZNotificationLayoutInput input;
+    input.bounds = RZNotificationRectMake(0.0, 0.0, 320.0, 54.0);
+    input.topOffset = 0.0;
+    input.safeTopInset = 0.0;
+    input.safeBottomInset = 0.0;
+    input.hasIcon = 1;
+    input.hasAnchor = 1;
+    input.offsetX = 16.0;
+    input.contentMarginHeight = 16.0;
+    input.iconWidth = 21.0;
+    input.iconHeight = 22.0;
+    return input;
+}
+
+static void testFramesWithIconAndAnchor(void)
+{
+    RZNotificationLayoutInput input = defaultInput();
+    RZNotificationLayoutResult result;
+    RZNotificationLayoutCompute(&input, &result);
+
+    RZAssert(RZNotificationRectEqual(result.iconFrame, RZNotificationRectMake(16.0, 16.0, 21.0, 22.0)), "icon frame");
+    RZAssert(RZNotificationRectEqual(result.contentFrame, RZNotificationRectMake(53.0, 16.0, 214.0, 22.0)), "content frame");
+    RZAssert(RZNotificationRectEqual(result.anchorFrame, RZNotificationRectMake(283.0, 16.0, 21.0, 22.0)), "anchor frame");
+}
+
+static void testContentTakesSpaceOfMissingImages(void)
+{
+    RZNotificationLayoutInput input = defaultInput();
+    input.hasIcon = 0;
+    input.hasAnchor = 0;
+    RZNotificationLayoutResult result;
+    RZNotificationLayoutCompute(&input, &result);
+
+    RZAssertEqualDouble(result.contentFrame.x, 16.0, "content starts at offset");
+    RZAssertEqualDouble(result.contentFrame.width, 288.0, "content spans the width");
+    RZAssertEqualDouble(RZNotificationLayoutContentWidth(&input), 288.0, "content width");
+}
+
+static void testSafeInsetsAndTopOffset(void)
+{
+    RZNotificationLayoutInput input = defaultInput();
+    input.bounds.height = 100.0;
+    input.topOffset = 10.0;
+    input.safeTopInset = 4.0;
+    input.safeBottomInset = 34.0;
+    RZNotificationLayoutResult result;
+    RZNotificationLayoutCompute(&input, &result);
+
+    // 10 + floor((100 - 22 - 34 + 4) / 2) = 34
+    RZAssertEqualDouble(result.iconFrame.y, 34.0, "icon centered above the bottom inset");
+    RZAssertEqualDouble(result.anchorFrame.y, 34.0, "anchor aligned with icon");
+    RZAssertEqualDouble(result.contentFrame.y, 26.0, "content below margin and top offset");
+    RZAssertEqualDouble(result.contentFrame.height, 38.0, "content height without margins and insets");
+}
+
+static void testHeightForContentHeight(void)
+{
+    RZNotificationLayoutInput input = defaultInput();
+    RZAssertEqualDouble(RZNotificationLayoutHeightForContentHeight(&input, 10.0, 54.0), 54.0, "minimum height");
+
+    input.topOffset = 10.0;
+    input.safeBottomInset = 34.0;
+    RZAssertEqualDouble(RZNotificationLayoutHeightForContentHeight(&input, 40.0, 54.0), 116.0, "content, margins, offset and insets");
+}
+
+static void testInputEquality(void)
+{
+    RZNotificationLayoutInput a = defaultInput();
+    RZNotificationLayoutInput b = defaultInput();
+    RZAssert(RZNotificationLayoutInputEqual(&a, &b), "same inputs");
+
+    b.hasIcon = 2;
+    RZAssert(RZNotificationLayoutInputEqual(&a, &b), "flags are booleans");
+
+    b.bounds.width = 480.0;
+    RZAssert(!RZNotificationLayoutInputEqual(&a, &b), "width change");
+
+    b = defaultInput();
+    b.safeBottomInset = 34.0;
+    RZAssert(!RZNotificationLayoutInputEqual(&a, &b), "inset change");
+}
+
+static void testInsets(void)
+{
+    RZNotificationLayoutInput input = defaultInput();
+    RZNotificationInsetsInput insets = { 0, 1, 0, 20.0, 44.0, 34.0 };
+
+    // Top, below the status bar of a notched device
+    RZNotificationLayoutApplyInsets(&insets, &input);
+    RZAssertEqualDouble(input.topOffset, 10.0, "half the status bar");
+    RZAssertEqualDouble(input.safeTopInset, 24.0, "status bar removed from the safe area");
+    RZAssertEqualDouble(input.safeBottomInset, 0.0, "bottom untouched");
+
+    // Top most controller keeps its previous top inset
+    insets.belowStatusBar = 0;
+    insets.topMostController = 1;
+    input.safeTopInset = 5.0;
+    RZNotificationLayoutApplyInsets(&insets, &input);
+    RZAssertEqualDouble(input.topOffset, 0.0, "no offset");
+    RZAssertEqualDouble(input.safeTopInset, 5.0, "top untouched");
+
+    // Bottom only uses the bottom safe area
+    insets.bottom = 1;
+    insets.belowStatusBar = 1;
+    RZNotificationLayoutApplyInsets(&insets, &input);
+    RZAssertEqualDouble(input.topOffset, 0.0, "no offset at the bottom");
+    RZAssertEqualDouble(input.safeBottomInset, 34.0, "bottom safe area");
+    RZAssertEqualDouble(input.safeTopInset, 5.0, "top untouched");
+}
+
+static void testVerticalPosition(void)
+{
+    RZNotificationOriginInput origin = { 0, 800.0, 64.0, 49.0, 34.0, 0, 0.0, 60.0 };
+
+    RZAssertEqualDouble(RZNotificationLayoutFinalEdge(&origin), 64.0, "top guide");
+    RZAssertEqualDouble(RZNotificationLayoutShownY(&origin), 64.0, "shown under the top guide");
+    RZAssertEqualDouble(RZNotificationLayoutHiddenY(&origin), -60.0, "hidden above");
+
+    origin.bottom = 1;
+    RZAssertEqualDouble(RZNotificationLayoutFinalEdge(&origin), 800.0 - 49.0 - 34.0, "bottom guide and safe area");
+    RZAssertEqualDouble(RZNotificationLayoutShownY(&origin), 800.0 - 49.0 - 34.0 - 60.0, "shown above the edge");
+    RZAssertEqualDouble(RZNotificationLayoutHiddenY(&origin), 766.0, "hidden under the safe area");
+
+    origin.hasCustomOrigin = 1;
+    origin.customOrigin = 500.0;
+    RZAssertEqualDouble(RZNotificationLayoutShownY(&origin), 440.0, "controller origin");
+    origin.bottom = 0;
+    RZAssertEqualDouble(RZNotificationLayoutShownY(&origin), 500.0, "controller origin on top");
+}
+
+static void testWindowFrame(void)
+{
+    double extents[] = { 60.0, 128.0, 54.0 };
+
+    RZNotificationRect frame = RZNotificationLayoutWindowFrame(375.0, 812.0, 0, extents, 3);
+    RZAssert(RZNotificationRectEqual(frame, RZNotificationRectMake(0.0, 0.0, 375.0, 128.0)), "top, farthest notification");
+
+    frame = RZNotificationLayoutWindowFrame(375.0, 812.0, 1, extents, 3);
+    RZAssert(RZNotificationRectEqual(frame, RZNotificationRectMake(0.0, 684.0, 375.0, 128.0)), "bottom, against the edge");
+
+    frame = RZNotificationLayoutWindowFrame(375.0, 812.0, 1, extents, 0);
+    RZAssert(RZNotificationRectEqual(frame, RZNotificationRectMake(0.0, 812.0, 375.0, 0.0)), "empty on the edge");
+
+    extents[1] = 1000.0;
+    frame = RZNotificationLayoutWindowFrame(375.0, 812.0, 0, extents, 3);
+    RZAssertEqualDouble(frame.height, 812.0, "never higher than the screen");
+}
+
+// The height of a bottom notification covers the safe area, its content sized window must not push it up again
+static void testBottomWindowFitsItsNotification(void)
+{
+    RZNotificationLayoutInput input = defaultInput();
+    RZNotificationInsetsInput insets = { 1, 1, 0, 20.0, 44.0, 34.0 };
+    RZNotificationLayoutApplyInsets(&insets, &input);
+    double height = RZNotificationLayoutHeightForContentHeight(&input, 20.0, 54.0);
+
+    RZNotificationRect frame = RZNotificationLayoutWindowFrame(375.0, 812.0, 1, &height, 1);
+    RZAssertEqualDouble(frame.height, height, "window as high as its notification");
+
+    // Windows leave their safe area out of the origin
+    RZNotificationOriginInput origin = { 1, frame.height, 0.0, 0.0, 0.0, 0, 0.0, height };
+    RZAssertEqualDouble(RZNotificationLayoutShownY(&origin), 0.0, "shown inside the window");
+    RZAssertEqualDouble(RZNotificationLayoutHiddenY(&origin), frame.height, "hidden under the window");
+}
+
+int main(void)
+{
+    RZRunTest(testFramesWithIconAndAnchor);
+    RZRunTest(testContentTakesSpaceOfMissingImages);
+    RZRunTest(testSafeInsetsAndTopOffset);
+    RZRunTest(testHeightForContentHeight);
+    RZRunTest(testInputEquality);
+    RZRunTest(testInsets);
+    RZRunTest(testVerticalPosition);
+    RZRunTest(testWindowFrame);
+    RZRunTest(testBottomWindowFitsItsNotification);
+    return RZTestFailures == 0 ? 0 : 1;
+}
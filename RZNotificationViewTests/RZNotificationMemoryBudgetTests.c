@@ -0,0 +1,121 @@
+//
+//  RZNotificationMemoryBudgetTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationMemoryBudget.h"
+#include "RZNotificationTestMacros.h"
+
+static int contains(const uint64_t *items, size_t count, uint64_t item)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (items[i] == item) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void testBitmapBytes(void)
+{
+    RZAssert(RZNotificationMemoryBitmapBytes(320.0, 54.0, 2.0) == 640 * 108 * 4, "retina");
+    RZAssert(RZNotificationMemoryBitmapBytes(10.5, 10.0, 3.0) == 32 * 30 * 4, "pixels rounded up");
+    RZAssert(RZNotificationMemoryBitmapBytes(0.0, 54.0, 2.0) == 0, "empty");
+    RZAssert(RZNotificationMemoryBitmapBytes(320.0, 54.0, 0.0) == 0, "no scale yet");
+}
+
+static void testUsage(void)
+{
+    RZNotificationMemoryBudget *budget = RZNotificationMemoryBudgetCreate(0);
+    RZAssert(RZNotificationMemoryBudgetSet(budget, 1, 100, 0), "added");
+    RZAssert(RZNotificationMemoryBudgetSet(budget, 2, 50, 0), "added");
+    RZAssert(RZNotificationMemoryBudgetUsage(budget) == 150 && RZNotificationMemoryBudgetCount(budget) == 2, "sum");
+
+    RZNotificationMemoryBudgetSet(budget, 1, 30, 0);
+    RZAssert(RZNotificationMemoryBudgetUsage(budget) == 80 && RZNotificationMemoryBudgetCount(budget) == 2, "updated");
+    RZAssert(RZNotificationMemoryBudgetBytes(budget, 1) == 30, "item bytes");
+
+    RZAssert(RZNotificationMemoryBudgetRemove(budget, 2), "removed");
+    RZAssert(!RZNotificationMemoryBudgetRemove(budget, 2), "already removed");
+    RZAssert(RZNotificationMemoryBudgetUsage(budget) == 30 && RZNotificationMemoryBudgetBytes(budget, 2) == 0, "gone");
+
+    uint64_t items[4];
+    RZNotificationMemoryBudgetSet(budget, 3, 1000000, 0);
+    RZAssert(RZNotificationMemoryBudgetTakeEvictions(budget, items, 4) == 0, "no limit");
+    RZNotificationMemoryBudgetDestroy(budget);
+}
+
+static void testEvictionOrder(void)
+{
+    RZNotificationMemoryBudget *budget = RZNotificationMemoryBudgetCreate(250);
+    uint64_t items[8];
+    RZNotificationMemoryBudgetSet(budget, 1, 100, 1);
+    RZNotificationMemoryBudgetSet(budget, 2, 100, 0);
+    RZAssert(RZNotificationMemoryBudgetTakeEvictions(budget, items, 8) == 0, "under the limit");
+
+    RZNotificationMemoryBudgetSet(budget, 3, 100, 0);
+    RZNotificationMemoryBudgetSet(budget, 4, 100, 0);
+    // 400 bytes: the two lowest priority and oldest go, the newest is kept
+    size_t count = RZNotificationMemoryBudgetTakeEvictions(budget, items, 8);
+    RZAssert(count == 2 && contains(items, count, 2) && contains(items, count, 3), "lowest priority, oldest first");
+    RZAssert(RZNotificationMemoryBudgetUsage(budget) == 400, "picked items keep their bytes until removed");
+    RZAssert(RZNotificationMemoryBudgetTakeEvictions(budget, items, 8) == 0, "picked once");
+
+    RZNotificationMemoryBudgetRemove(budget, 2);
+    RZNotificationMemoryBudgetRemove(budget, 3);
+    RZNotificationMemoryBudgetSetLimit(budget, 150);
+    count = RZNotificationMemoryBudgetTakeEvictions(budget, items, 8);
+    RZAssert(count == 1 && items[0] == 1, "higher priority but older than the newest");
+    RZNotificationMemoryBudgetDestroy(budget);
+}
+
+static void testNewestIsKept(void)
+{
+    RZNotificationMemoryBudget *budget = RZNotificationMemoryBudgetCreate(10);
+    uint64_t items[8];
+    RZNotificationMemoryBudgetSet(budget, 1, 100, 5);
+    RZAssert(RZNotificationMemoryBudgetTakeEvictions(budget, items, 8) == 0, "alone over the limit");
+
+    RZNotificationMemoryBudgetSet(budget, 2, 100, -5);
+    size_t count = RZNotificationMemoryBudgetTakeEvictions(budget, items, 8);
+    RZAssert(count == 1 && items[0] == 1, "the newest stays whatever its priority");
+
+    // Growing an item keeps its age
+    RZNotificationMemoryBudgetRemove(budget, 1);
+    RZNotificationMemoryBudgetSet(budget, 3, 1, 0);
+    RZNotificationMemoryBudgetSet(budget, 2, 200, -5);
+    count = RZNotificationMemoryBudgetTakeEvictions(budget, items, 8);
+    RZAssert(count == 1 && items[0] == 2, "older");
+    RZNotificationMemoryBudgetDestroy(budget);
+}
+
+static void testEvictionsPastCapacity(void)
+{
+    RZNotificationMemoryBudget *budget = RZNotificationMemoryBudgetCreate(100);
+    for (uint64_t item = 1; item <= 20; item++) {
+        RZNotificationMemoryBudgetSet(budget, item, 100, 0);
+    }
+    uint64_t items[8];
+    size_t taken = 0;
+    RZAssert(RZNotificationMemoryBudgetTakeEvictions(budget, items, 8) == 19, "every item but the newest");
+    taken += 8;
+    while (RZNotificationMemoryBudgetTakeEvictions(budget, items, 8) > 0) {
+        RZAssert(!contains(items, 8, 20), "newest kept");
+        taken += 8;
+    }
+    RZAssert(taken == 24, "remaining items in the next calls");
+    RZNotificationMemoryBudgetDestroy(budget);
+}
+
+int main(void)
+{
+    RZRunTest(testBitmapBytes);
+    RZRunTest(testUsage);
+    RZRunTest(testEvictionOrder);
+    RZRunTest(testNewestIsKept);
+    RZRunTest(testEvictionsPastCapacity);
+    return RZTestFailures == 0 ? 0 : 1;
+}
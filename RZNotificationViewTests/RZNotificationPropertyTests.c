@@ -0,0 +1,677 @@
+//
+//  RZNotificationPropertyTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+/*
+ * Randomized sequences of shows, hides, hide alls, rotations and resizes, played on a headless
+ * model of the manager: the registry, the stacks and the insets, origin and window layout used
+ * by the views. Invariants are checked after each operation. A failing sequence is shrunk to a
+ * minimal repro and printed with its seed.
+ *
+ * RZ_PROPERTY_SEED and RZ_PROPERTY_RUNS override the first seed and the number of sequences.
+ */
+
+#include "RZNotificationLayout.h"
+#include "RZNotificationRegistry.h"
+#include "RZNotificationStack.h"
+#include "RZNotificationTestMacros.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Controllers, then the windows of RZNotificationContextBelowStatusBar and
+// RZNotificationContextAboveStatusBar, top then bottom. The first controller is the top most one
+enum {
+    kControllerCount = 2,
+    kWindowCount = 4,
+    kContainerCount = kControllerCount + kWindowCount,
+    kMaxNotifications = 256,
+    kMaxOperations = 64
+};
+
+static const double kMinHeight = 54.0;
+static const double kContentMarginHeight = 16.0;
+static const double kStatusBarHeight = 20.0;
+static const double kStackSpacing = 8.0;
+static const unsigned kStackMaxVisible = 2;
+// With the stack limit, every visible notification fits in the smallest container
+static const double kMaxContentHeight = 40.0;
+
+typedef enum {
+    RZOperationShow = 0,
+    RZOperationHide,
+    RZOperationHideAll,
+    RZOperationRotate,
+    RZOperationResize,
+    RZOperationCount
+} RZOperationType;
+
+typedef struct {
+    RZOperationType type;
+    unsigned container;
+    int bottom;
+    double contentHeight;
+    unsigned slot;              // Hide and resize, modulo the live notifications
+} RZOperation;
+
+typedef struct {
+    int stack;                  // RZNotificationLayoutModeStack, overlap otherwise
+    size_t maxPerContainer;     // Broken on purpose by the shrinking test, 0 otherwise
+} RZPropertyConfig;
+
+typedef struct {
+    uint64_t key;
+    unsigned container;
+    int bottom;
+    double contentHeight;
+    double height;
+} RZModelNotification;
+
+typedef struct {
+    RZNotificationRegistry *registry;
+    RZNotificationStack *stacks[kContainerCount][2];
+    int windowHidden[kWindowCount];
+    RZModelNotification live[kMaxNotifications];
+    size_t liveCount;
+    uint64_t nextKey;
+    double screenWidth;
+    double screenHeight;
+    double safeTop;
+    double safeBottom;
+    double topGuide;            // Of the first controller, the second one has none
+    double bottomGuide;
+    int portrait;
+} RZModel;
+
+// MARK: - Random
+
+static uint64_t nextRandom(uint64_t *state)
+{
+    // xorshift64*
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static unsigned randomBelow(uint64_t *state, unsigned bound)
+{
+    return (unsigned)(nextRandom(state) % bound);
+}
+
+static double randomDouble(uint64_t *state, double max)
+{
+    return (double)(nextRandom(state) >> 11) / (double)(1ULL << 53) * max;
+}
+
+// MARK: - Model
+
+static uint64_t containerKey(unsigned container)
+{
+    return 1000 + container;
+}
+
+static int isWindow(unsigned container)
+{
+    return container >= kControllerCount;
+}
+
+static int windowIsBelowStatusBar(unsigned container)
+{
+    return container - kControllerCount < 2;
+}
+
+static int windowIsBottom(unsigned container)
+{
+    return (container - kControllerCount) % 2;
+}
+
+static void setOrientation(RZModel *model, int portrait)
+{
+    model->portrait = portrait;
+    model->screenWidth = portrait ? 375.0 : 812.0;
+    model->screenHeight = portrait ? 812.0 : 375.0;
+    model->safeTop = portrait ? 44.0 : 0.0;
+    model->safeBottom = portrait ? 34.0 : 21.0;
+    model->topGuide = portrait ? 88.0 : 32.0;
+    model->bottomGuide = portrait ? 83.0 : 53.0;
+}
+
+static int modelInit(RZModel *model)
+{
+    memset(model, 0, sizeof(RZModel));
+    model->registry = RZNotificationRegistryCreate();
+    if (model->registry == NULL) {
+        return 0;
+    }
+    for (unsigned c = 0; c < kContainerCount; c++) {
+        for (int edge = 0; edge < 2; edge++) {
+            model->stacks[c][edge] = RZNotificationStackCreate(kStackSpacing, kStackMaxVisible);
+            if (model->stacks[c][edge] == NULL) {
+                return 0;
+            }
+        }
+    }
+    for (unsigned w = 0; w < kWindowCount; w++) {
+        model->windowHidden[w] = 1;
+    }
+    model->nextKey = 1;
+    setOrientation(model, 1);
+    return 1;
+}
+
+static void modelDestroy(RZModel *model)
+{
+    RZNotificationRegistryDestroy(model->registry);
+    for (unsigned c = 0; c < kContainerCount; c++) {
+        RZNotificationStackDestroy(model->stacks[c][0]);
+        RZNotificationStackDestroy(model->stacks[c][1]);
+    }
+}
+
+// Like -adjustHeightAndRedraw:, windows use the screen safe area
+static double notificationHeight(const RZModel *model, unsigned container, int bottom, double contentHeight)
+{
+    RZNotificationInsetsInput insets;
+    memset(&insets, 0, sizeof(insets));
+    insets.bottom = bottom;
+    insets.belowStatusBar = isWindow(container) && windowIsBelowStatusBar(container);
+    insets.topMostController = !isWindow(container);
+    insets.statusBarHeight = kStatusBarHeight;
+    insets.containerSafeTopInset = model->safeTop;
+    insets.containerSafeBottomInset = model->safeBottom;
+
+    RZNotificationLayoutInput input;
+    memset(&input, 0, sizeof(input));
+    input.bounds = RZNotificationRectMake(0.0, 0.0, model->screenWidth, kMinHeight);
+    input.contentMarginHeight = kContentMarginHeight;
+    RZNotificationLayoutApplyInsets(&insets, &input);
+    return RZNotificationLayoutHeightForContentHeight(&input, contentHeight, kMinHeight);
+}
+
+static RZNotificationStack *stackOf(const RZModel *model, const RZModelNotification *notification)
+{
+    return model->stacks[notification->container][notification->bottom];
+}
+
+static double stackOffset(const RZModel *model, const RZModelNotification *notification)
+{
+    double offset = 0.0;
+    RZNotificationStackOffset(stackOf(model, notification), notification->key, &offset);
+    return offset;
+}
+
+static int isVisible(const RZModel *model, const RZModelNotification *notification)
+{
+    RZNotificationStack *stack = stackOf(model, notification);
+    size_t index;
+    return !RZNotificationStackIndex(stack, notification->key, &index) || RZNotificationStackIsVisible(stack, notification->key);
+}
+
+// Like +fitNotificationWindow:including:
+static RZNotificationRect windowFrame(const RZModel *model, unsigned container)
+{
+    double extents[kMaxNotifications];
+    size_t count = 0;
+    for (size_t i = 0; i < model->liveCount; i++) {
+        const RZModelNotification *notification = &model->live[i];
+        if (notification->container == container && isVisible(model, notification)) {
+            extents[count++] = stackOffset(model, notification) + notification->height;
+        }
+    }
+    return RZNotificationLayoutWindowFrame(model->screenWidth, model->screenHeight, windowIsBottom(container), extents, count);
+}
+
+// Like -placeToFinalPosition, in the container coordinate space
+static double shownY(const RZModel *model, const RZModelNotification *notification, double containerHeight)
+{
+    RZNotificationOriginInput input;
+    memset(&input, 0, sizeof(input));
+    input.bottom = notification->bottom;
+    input.containerHeight = containerHeight;
+    input.notificationHeight = notification->height;
+    if (!isWindow(notification->container)) {
+        input.safeBottomInset = model->safeBottom;
+        if (notification->container == 0) {
+            input.topGuide = model->topGuide;
+            input.bottomGuide = model->bottomGuide;
+        }
+    }
+    double y = RZNotificationLayoutShownY(&input);
+    double offset = stackOffset(model, notification);
+    return notification->bottom ? y - offset : y + offset;
+}
+
+static void modelShow(RZModel *model, const RZPropertyConfig *config, const RZOperation *operation)
+{
+    if (model->liveCount == kMaxNotifications) {
+        return;
+    }
+    RZModelNotification *notification = &model->live[model->liveCount];
+    notification->key = model->nextKey++;
+    notification->container = operation->container % kContainerCount;
+    notification->bottom = isWindow(notification->container) ? windowIsBottom(notification->container) : operation->bottom;
+    notification->contentHeight = operation->contentHeight;
+    notification->height = notificationHeight(model, notification->container, notification->bottom, notification->contentHeight);
+
+    // Notifications of the windows are also indexed by the top most controller
+    uint64_t controller = isWindow(notification->container) ? containerKey(0) : 0;
+    if (!RZNotificationRegistryInsert(model->registry, notification->key, containerKey(notification->container), controller)) {
+        return;
+    }
+    model->liveCount++;
+    if (config->stack) {
+        RZNotificationStackInsert(stackOf(model, notification), notification->key, 0, notification->height);
+    }
+    if (isWindow(notification->container)) {
+        model->windowHidden[notification->container - kControllerCount] = 0;
+    }
+}
+
+// Like +removeNotifications:
+static void modelRemove(RZModel *model, const uint64_t *keys, size_t count)
+{
+    // The windows to hide are the ones +removeNotifications: hides
+    uint64_t emptied[kMaxNotifications];
+    size_t emptiedCount = 0;
+    RZNotificationRegistryRemoveManyEmptying(model->registry, keys, count, emptied, &emptiedCount);
+
+    for (size_t k = 0; k < count; k++) {
+        for (size_t i = 0; i < model->liveCount; i++) {
+            RZModelNotification *notification = &model->live[i];
+            if (notification->key != keys[k]) {
+                continue;
+            }
+            RZNotificationStackRemove(stackOf(model, notification), notification->key);
+            *notification = model->live[--model->liveCount];
+            break;
+        }
+    }
+    for (size_t e = 0; e < emptiedCount; e++) {
+        for (unsigned w = 0; w < kWindowCount; w++) {
+            if (emptied[e] == containerKey(kControllerCount + w)) {
+                model->windowHidden[w] = 1;
+            }
+        }
+    }
+}
+
+static void modelRelayout(RZModel *model, RZModelNotification *notification)
+{
+    notification->height = notificationHeight(model, notification->container, notification->bottom, notification->contentHeight);
+    RZNotificationStackResize(stackOf(model, notification), notification->key, notification->height);
+}
+
+static void modelApply(RZModel *model, const RZPropertyConfig *config, const RZOperation *operation)
+{
+    switch (operation->type) {
+        case RZOperationShow:
+            modelShow(model, config, operation);
+            break;
+
+        case RZOperationHide:
+            if (model->liveCount > 0) {
+                uint64_t key = model->live[operation->slot % model->liveCount].key;
+                modelRemove(model, &key, 1);
+            }
+            break;
+
+        case RZOperationHideAll:
+        {
+            // Like +hideAllNotificationsForController:, windows of the top most controller included
+            unsigned container = operation->container % kControllerCount;
+            uint64_t keys[kMaxNotifications];
+            size_t count = RZNotificationRegistryCopyForContainer(model->registry, containerKey(container), keys, kMaxNotifications);
+            if (container == 0) {
+                count += RZNotificationRegistryCopyForController(model->registry, containerKey(0), keys + count, kMaxNotifications - count);
+            }
+            modelRemove(model, keys, count);
+            break;
+        }
+
+        case RZOperationRotate:
+            setOrientation(model, !model->portrait);
+            for (size_t i = 0; i < model->liveCount; i++) {
+                modelRelayout(model, &model->live[i]);
+            }
+            break;
+
+        case RZOperationResize:
+            if (model->liveCount > 0) {
+                RZModelNotification *notification = &model->live[operation->slot % model->liveCount];
+                notification->contentHeight = operation->contentHeight;
+                modelRelayout(model, notification);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// MARK: - Invariants
+
+static size_t liveCountForContainer(const RZModel *model, unsigned container)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < model->liveCount; i++) {
+        count += (model->live[i].container == container);
+    }
+    return count;
+}
+
+static const RZModelNotification *liveNotification(const RZModel *model, uint64_t key)
+{
+    for (size_t i = 0; i < model->liveCount; i++) {
+        if (model->live[i].key == key) {
+            return &model->live[i];
+        }
+    }
+    return NULL;
+}
+
+static const char *checkRegistry(const RZModel *model)
+{
+    if (RZNotificationRegistryCount(model->registry) != model->liveCount) {
+        return "registry count differs from the live notifications";
+    }
+    size_t onWindows = 0;
+    for (unsigned c = 0; c < kContainerCount; c++) {
+        uint64_t keys[kMaxNotifications];
+        size_t count = RZNotificationRegistryCopyForContainer(model->registry, containerKey(c), keys, kMaxNotifications);
+        if (count != liveCountForContainer(model, c)) {
+            return "container count differs from its live notifications";
+        }
+        for (size_t i = 0; i < count; i++) {
+            const RZModelNotification *notification = liveNotification(model, keys[i]);
+            if (notification == NULL || notification->container != c) {
+                return "registered notification not live in its container";
+            }
+            for (size_t j = 0; j < i; j++) {
+                if (keys[j] == keys[i]) {
+                    return "duplicate notification in a container";
+                }
+            }
+        }
+        if (isWindow(c)) {
+            onWindows += count;
+        }
+    }
+    if (RZNotificationRegistryCountForController(model->registry, containerKey(0)) != onWindows) {
+        return "top most controller does not index every window notification";
+    }
+    return NULL;
+}
+
+static const char *checkWindows(const RZModel *model)
+{
+    for (unsigned w = 0; w < kWindowCount; w++) {
+        unsigned container = kControllerCount + w;
+        int empty = RZNotificationRegistryCountForContainer(model->registry, containerKey(container)) == 0;
+        if (model->windowHidden[w] != empty) {
+            return "window hidden while showing notifications, or shown without any";
+        }
+        RZNotificationRect frame = windowFrame(model, container);
+        if ((frame.height > 0.0) == empty) {
+            return "window size does not follow its notifications";
+        }
+        if (frame.y < 0.0 || frame.y + frame.height > model->screenHeight + 1e-9) {
+            return "window out of the screen";
+        }
+    }
+    return NULL;
+}
+
+static const char *checkFrames(const RZModel *model, const RZPropertyConfig *config)
+{
+    for (size_t i = 0; i < model->liveCount; i++) {
+        const RZModelNotification *notification = &model->live[i];
+        if (notification->height < kMinHeight) {
+            return "notification lower than the minimum height";
+        }
+        if (!isVisible(model, notification)) {
+            continue;
+        }
+        double containerHeight = isWindow(notification->container) ? windowFrame(model, notification->container).height : model->screenHeight;
+        double y = shownY(model, notification, containerHeight);
+        if (y < -1e-9 || y + notification->height > containerHeight + 1e-9) {
+            return "notification frame out of its container";
+        }
+    }
+    for (unsigned c = 0; config->maxPerContainer > 0 && c < kContainerCount; c++) {
+        if (liveCountForContainer(model, c) > config->maxPerContainer) {
+            return "too many notifications in a container";
+        }
+    }
+    return NULL;
+}
+
+// MARK: - Runs
+
+static const char *runOperations(const RZOperation *operations, size_t count, const RZPropertyConfig *config)
+{
+    RZModel model;
+    if (!modelInit(&model)) {
+        modelDestroy(&model);
+        return "could not allocate the model";
+    }
+    const char *failure = NULL;
+    for (size_t i = 0; i < count && failure == NULL; i++) {
+        modelApply(&model, config, &operations[i]);
+        failure = checkRegistry(&model);
+        if (failure == NULL) {
+            failure = checkWindows(&model);
+        }
+        if (failure == NULL) {
+            failure = checkFrames(&model, config);
+        }
+    }
+    modelDestroy(&model);
+    return failure;
+}
+
+static RZOperation randomOperation(uint64_t *state)
+{
+    RZOperation operation;
+    memset(&operation, 0, sizeof(operation));
+    // Shows are more frequent, so containers fill up
+    unsigned roll = randomBelow(state, 10);
+    operation.type = roll < 4 ? RZOperationShow : (RZOperationType)(1 + roll % (RZOperationCount - 1));
+    operation.container = randomBelow(state, kContainerCount);
+    operation.bottom = (int)randomBelow(state, 2);
+    operation.contentHeight = randomDouble(state, kMaxContentHeight);
+    operation.slot = randomBelow(state, kMaxNotifications);
+    return operation;
+}
+
+static int stillFails(const RZOperation *operations, size_t count, const RZPropertyConfig *config)
+{
+    return runOperations(operations, count, config) != NULL;
+}
+
+// Remove chunks of operations, then single ones, then simplify what is left, until nothing changes
+static size_t shrinkOperations(RZOperation *operations, size_t count, const RZPropertyConfig *config)
+{
+    RZOperation candidate[kMaxOperations];
+    int progress = 1;
+    while (progress) {
+        progress = 0;
+        for (size_t chunk = count / 2; chunk > 0; chunk /= 2) {
+            size_t start = 0;
+            while (start + chunk <= count) {
+                memcpy(candidate, operations, start * sizeof(RZOperation));
+                memcpy(candidate + start, operations + start + chunk, (count - start - chunk) * sizeof(RZOperation));
+                if (stillFails(candidate, count - chunk, config)) {
+                    count -= chunk;
+                    memcpy(operations, candidate, count * sizeof(RZOperation));
+                    progress = 1;
+                }
+                else {
+                    start += chunk;
+                }
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            // Each field only ever moves to 0, so this pass ends
+            for (int field = 0; field < 4; field++) {
+                RZOperation kept = operations[i];
+                RZOperation *operation = &operations[i];
+                switch (field) {
+                    case 0: operation->container = 0; break;
+                    case 1: operation->bottom = 0; break;
+                    case 2: operation->contentHeight = 0.0; break;
+                    default: operation->slot = 0; break;
+                }
+                if (memcmp(&kept, operation, sizeof(RZOperation)) == 0) {
+                    continue;
+                }
+                if (stillFails(operations, count, config)) {
+                    progress = 1;
+                }
+                else {
+                    operations[i] = kept;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+static void printOperations(const RZOperation *operations, size_t count, FILE *file)
+{
+    static const char *names[RZOperationCount] = { "show", "hide", "hideAll", "rotate", "resize" };
+    for (size_t i = 0; i < count; i++) {
+        const RZOperation *operation = &operations[i];
+        fprintf(file, "  %s container=%u bottom=%d content=%g slot=%u\n",
+                names[operation->type], operation->container, operation->bottom, operation->contentHeight, operation->slot);
+    }
+}
+
+/*
+ * Return the number of operations of the shrunk failing sequence, 0 when every run passed
+ */
+static size_t runSequences(uint64_t seed, unsigned runs, const RZPropertyConfig *config, RZOperation *repro, int report)
+{
+    for (unsigned run = 0; run < runs; run++) {
+        uint64_t state = (seed + run) * 0x9E3779B97F4A7C15ULL + 1;
+        size_t count = 1 + randomBelow(&state, kMaxOperations);
+        for (size_t i = 0; i < count; i++) {
+            repro[i] = randomOperation(&state);
+        }
+        const char *failure = runOperations(repro, count, config);
+        if (failure == NULL) {
+            continue;
+        }
+        count = shrinkOperations(repro, count, config);
+        if (report) {
+            fprintf(stderr, "seed %llu: %s, shrunk to %zu operations:\n", (unsigned long long)(seed + run), runOperations(repro, count, config), count);
+            printOperations(repro, count, stderr);
+        }
+        return count;
+    }
+    return 0;
+}
+
+static uint64_t seedFromEnvironment(void)
+{
+    const char *value = getenv("RZ_PROPERTY_SEED");
+    return value ? strtoull(value, NULL, 10) : 20121025;
+}
+
+static unsigned runsFromEnvironment(void)
+{
+    const char *value = getenv("RZ_PROPERTY_RUNS");
+    return value ? (unsigned)strtoul(value, NULL, 10) : 500;
+}
+
+// MARK: - Tests
+
+static void testOverlapInvariants(void)
+{
+    RZPropertyConfig config = { 0, 0 };
+    RZOperation repro[kMaxOperations];
+    RZAssert(runSequences(seedFromEnvironment(), runsFromEnvironment(), &config, repro, 1) == 0, "overlap invariants");
+}
+
+static void testStackInvariants(void)
+{
+    RZPropertyConfig config = { 1, 0 };
+    RZOperation repro[kMaxOperations];
+    RZAssert(runSequences(seedFromEnvironment(), runsFromEnvironment(), &config, repro, 1) == 0, "stack invariants");
+}
+
+static void testShrinking(void)
+{
+    // A property broken on purpose: the minimal repro is three shows in the same container
+    RZPropertyConfig config = { 0, 2 };
+    RZOperation repro[kMaxOperations];
+    size_t count = runSequences(1, 100, &config, repro, 0);
+    RZAssert(count == 3, "shrunk to three operations");
+
+    int shows = 1;
+    for (size_t i = 0; i < count; i++) {
+        shows = shows && repro[i].type == RZOperationShow && repro[i].container == repro[0].container;
+    }
+    RZAssert(shows, "only shows in one container");
+}
+
+static int isHighSurrogate(uint16_t unit)
+{
+    return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+static int isLowSurrogate(uint16_t unit)
+{
+    return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+static void testTruncationFuzz(void)
+{
+    uint64_t state = seedFromEnvironment() | 1;
+    uint16_t units[64];
+    int failures = 0;
+    for (unsigned run = 0; run < 20000 && failures == 0; run++) {
+        size_t length = randomBelow(&state, 64);
+        for (size_t i = 0; i < length; i++) {
+            // ASCII, then surrogate pairs, then lone halves
+            unsigned roll = randomBelow(&state, 8);
+            if (roll < 4 || i + 1 == length) {
+                units[i] = (uint16_t)(0x20 + randomBelow(&state, 0x5F));
+            }
+            else if (roll < 7) {
+                units[i] = (uint16_t)(0xD800 + randomBelow(&state, 0x400));
+                units[++i] = (uint16_t)(0xDC00 + randomBelow(&state, 0x400));
+            }
+            else {
+                units[i] = (uint16_t)(0xD800 + randomBelow(&state, 0x800));
+            }
+        }
+        long maxLength = (long)randomBelow(&state, 70) - 2;
+        size_t kept = RZNotificationLayoutTruncatedLength(units, length, maxLength);
+
+        if (maxLength < 0 || (size_t)maxLength >= length) {
+            failures += (kept != length);
+            continue;
+        }
+        failures += (kept > (size_t)maxLength || kept + 1 < (size_t)maxLength);
+        failures += (kept > 0 && isHighSurrogate(units[kept - 1]) && isLowSurrogate(units[kept]));
+        failures += (kept + 1 == (size_t)maxLength && !(isHighSurrogate(units[kept]) && isLowSurrogate(units[kept + 1])));
+    }
+    RZAssert(failures == 0, "kept length, never a split pair");
+}
+
+int main(void)
+{
+    RZRunTest(testOverlapInvariants);
+    RZRunTest(testStackInvariants);
+    RZRunTest(testShrinking);
+    RZRunTest(testTruncationFuzz);
+    return RZTestFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+//
+//  RZNotificationRegistryTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationRegistry.h"
+#include "RZNotificationTestMacros.h"
+
+enum {
+    kWindow = 1000,
+    kControllerA = 2000,
+    kControllerB = 2001
+};
+
+static void testContainerOrder(void)
+{
+    RZNotificationRegistry *registry = RZNotificationRegistryCreate();
+    uint64_t notifications[8];
+
+    RZAssert(RZNotificationRegistryInsert(registry, 1, kControllerA, 0), "insert");
+    RZAssert(RZNotificationRegistryInsert(registry, 2, kControllerA, 0), "insert");
+    RZAssert(RZNotificationRegistryInsert(registry, 3, kControllerA, 0), "insert");
+    RZAssert(!RZNotificationRegistryInsert(registry, 2, kControllerB, 0), "already registered");
+
+    RZAssert(RZNotificationRegistryLastForContainer(registry, kControllerA) == 3, "last inserted");
+    RZAssert(RZNotificationRegistryCopyForContainer(registry, kControllerA, notifications, 8) == 3, "three notifications");
+    RZAssert(notifications[0] == 1 && notifications[1] == 2 && notifications[2] == 3, "insertion order");
+
+    RZAssert(RZNotificationRegistryRemove(registry, 3), "remove last");
+    RZAssert(RZNotificationRegistryLastForContainer(registry, kControllerA) == 2, "previous becomes last");
+    RZAssert(RZNotificationRegistryRemove(registry, 1), "remove first");
+    RZAssert(RZNotificationRegistryCopyForContainer(registry, kControllerA, notifications, 8) == 1 && notifications[0] == 2, "middle left");
+    RZAssert(!RZNotificationRegistryRemove(registry, 1), "remove once");
+
+    RZAssert(RZNotificationRegistryRemove(registry, 2), "remove");
+    RZAssert(RZNotificationRegistryLastForContainer(registry, kControllerA) == 0, "empty container");
+    RZAssert(RZNotificationRegistryCountForContainer(registry, kControllerA) == 0, "no count");
+    RZAssert(RZNotificationRegistryCount(registry) == 0, "empty registry");
+
+    RZNotificationRegistryDestroy(registry);
+}
+
+static void testControllers(void)
+{
+    RZNotificationRegistry *registry = RZNotificationRegistryCreate();
+    uint64_t notifications[2];
+
+    // Window notifications shown over controller A and B
+    RZNotificationRegistryInsert(registry, 10, kWindow, kControllerA);
+    RZNotificationRegistryInsert(registry, 11, kWindow, kControllerB);
+    RZNotificationRegistryInsert(registry, 12, kWindow, kControllerA);
+    RZNotificationRegistryInsert(registry, 13, kControllerA, 0);
+
+    RZAssert(RZNotificationRegistryCountForContainer(registry, kWindow) == 3, "window holds three");
+    RZAssert(RZNotificationRegistryCountForController(registry, kControllerA) == 2, "two over A");
+    RZAssert(RZNotificationRegistryLastForController(registry, kControllerA) == 12, "last over A");
+    RZAssert(RZNotificationRegistryLastForController(registry, kControllerB) == 11, "last over B");
+    RZAssert(RZNotificationRegistryLastForContainer(registry, kControllerA) == 13, "controller container is separate");
+
+    RZNotificationRegistryRemove(registry, 12);
+    RZAssert(RZNotificationRegistryLastForController(registry, kControllerA) == 10, "controller list updated");
+    RZAssert(RZNotificationRegistryLastForContainer(registry, kWindow) == 11, "window list updated");
+
+    // Copy is bounded by capacity but reports the full count
+    RZNotificationRegistryInsert(registry, 14, kWindow, kControllerA);
+    RZNotificationRegistryInsert(registry, 15, kWindow, kControllerA);
+    RZAssert(RZNotificationRegistryCopyForController(registry, kControllerA, notifications, 2) == 3, "full count");
+    RZAssert(notifications[0] == 10 && notifications[1] == 14, "oldest first");
+
+    RZNotificationRegistryDestroy(registry);
+}
+
+static void testRemoveMany(void)
+{
+    RZNotificationRegistry *registry = RZNotificationRegistryCreate();
+    uint64_t batch[] = { 21, 99, 23, 21 };
+
+    RZNotificationRegistryInsert(registry, 20, kWindow, kControllerA);
+    RZNotificationRegistryInsert(registry, 21, kWindow, kControllerA);
+    RZNotificationRegistryInsert(registry, 22, kWindow, kControllerB);
+    RZNotificationRegistryInsert(registry, 23, kControllerA, 0);
+
+    RZAssert(RZNotificationRegistryRemoveMany(registry, batch, 4) == 2, "unknown and duplicate skipped");
+    RZAssert(RZNotificationRegistryLastForController(registry, kControllerA) == 20, "controller list updated");
+    RZAssert(RZNotificationRegistryCountForContainer(registry, kControllerA) == 0, "container emptied");
+    RZAssert(RZNotificationRegistryCount(registry) == 2, "two left");
+
+    RZNotificationRegistryDestroy(registry);
+}
+
+static void testRemoveManyEmptying(void)
+{
+    RZNotificationRegistry *registry = RZNotificationRegistryCreate();
+    uint64_t batch[] = { 32, 30, 99, 31, 30 };
+    uint64_t emptied[5];
+    size_t emptiedCount = 0;
+
+    RZNotificationRegistryInsert(registry, 30, kWindow, kControllerA);
+    RZNotificationRegistryInsert(registry, 31, kWindow, kControllerA);
+    RZNotificationRegistryInsert(registry, 32, kControllerA, 0);
+    RZNotificationRegistryInsert(registry, 33, kControllerB, 0);
+
+    RZAssert(RZNotificationRegistryRemoveManyEmptying(registry, batch, 5, emptied, &emptiedCount) == 3, "unknown and duplicate skipped");
+    RZAssert(emptiedCount == 2 && emptied[0] == kControllerA && emptied[1] == kWindow, "each emptied container once");
+
+    RZNotificationRegistryInsert(registry, 34, kControllerB, 0);
+    RZAssert(RZNotificationRegistryRemoveManyEmptying(registry, &batch[4], 1, emptied, &emptiedCount) == 0, "nothing removed");
+    RZAssert(emptiedCount == 0, "nothing emptied");
+    RZAssert(RZNotificationRegistryRemoveManyEmptying(registry, (uint64_t[]){ 33 }, 1, emptied, &emptiedCount) == 1, "removed");
+    RZAssert(emptiedCount == 0, "container still holds a notification");
+
+    RZNotificationRegistryDestroy(registry);
+}
+
+static void testInvalidKeys(void)
+{
+    RZNotificationRegistry *registry = RZNotificationRegistryCreate();
+
+    RZAssert(!RZNotificationRegistryInsert(registry, 0, kWindow, 0), "0 is not a notification");
+    RZAssert(!RZNotificationRegistryInsert(registry, 1, 0, 0), "a container is required");
+    RZAssert(RZNotificationRegistryLastForContainer(registry, 0) == 0, "unknown container");
+    RZAssert(RZNotificationRegistryCopyForController(registry, kControllerA, NULL, 0) == 0, "unknown controller");
+    RZAssert(!RZNotificationRegistryContains(registry, 1), "nothing registered");
+
+    RZNotificationRegistryDestroy(registry);
+}
+
+static void testManyNotifications(void)
+{
+    RZNotificationRegistry *registry = RZNotificationRegistryCreate();
+
+    for (uint64_t i = 1; i <= 5000; i++) {
+        RZNotificationRegistryInsert(registry, i, kWindow + i % 7, i % 3 ? kControllerA + i % 5 : 0);
+    }
+    for (uint64_t i = 1; i <= 5000; i += 2) {
+        RZNotificationRegistryRemove(registry, i);
+    }
+    RZAssert(RZNotificationRegistryCount(registry) == 2500, "half removed");
+
+    size_t total = 0;
+    for (uint64_t container = kWindow; container < kWindow + 7; container++) {
+        total += RZNotificationRegistryCountForContainer(registry, container);
+    }
+    RZAssert(total == 2500, "containers add up");
+    RZAssert(RZNotificationRegistryLastForContainer(registry, kWindow + 5000 % 7) == 5000, "last even one");
+
+    RZNotificationRegistryDestroy(registry);
+}
+
+int main(void)
+{
+    RZRunTest(testContainerOrder);
+    RZRunTest(testControllers);
+    RZRunTest(testRemoveMany);
+    RZRunTest(testRemoveManyEmptying);
+    RZRunTest(testInvalidKeys);
+    RZRunTest(testManyNotifications);
+    return RZTestFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+//
+//  RZNotificationReplayTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationReplay.h"
+#include "RZNotificationTestMacros.h"
+
+#include <string.h>
+
+static void append(RZNotificationEventLog *log, RZNotificationEventType type, double timestamp, uint64_t notification, double duration)
+{
+    RZNotificationEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.timestamp = timestamp;
+    event.notification = notification;
+    event.container = 1;
+    event.duration = duration;
+    event.width = 320.0;
+    event.height = 54.0;
+    RZNotificationEventLogAppend(log, &event);
+}
+
+static void testTimersExpireNotifications(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    append(log, RZNotificationEventShow, 0.0, 1, 1.0);
+    append(log, RZNotificationEventShow, 0.0, 2, 1.0);
+    append(log, RZNotificationEventShow, 0.5, 3, 1.0);
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    RZNotificationReplayReport report;
+    RZAssert(RZNotificationReplayRun(log, &config, &report), "replayed");
+    RZAssert(report.shown == 3 && report.expired == 3, "every notification expired");
+    RZAssert(report.peakLiveCount == 3 && report.peakPendingCount == 0, "shown at once");
+    RZAssert(report.allocations == 3 && report.reuses == 0, "no reuse pool");
+    RZAssert(report.latencies[RZNotificationEventShow].count == 3, "show latencies");
+    RZAssert(report.latencies[RZNotificationReplayTimerLatency].count == 3, "expire latencies");
+    RZAssert(report.latencies[RZNotificationEventHide].count == 0, "no recorded hide");
+    RZAssert(report.replayedDuration >= 1.5 && report.replayedDuration < 1.6, "last hide deadline");
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testMaxVisibleQueuesShows(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    append(log, RZNotificationEventShow, 0.0, 1, 1.0);
+    append(log, RZNotificationEventShow, 0.0, 2, 1.0);
+    append(log, RZNotificationEventShow, 0.0, 3, 1.0);
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    config.maxVisible = 1;
+    RZNotificationReplayReport report;
+    RZAssert(RZNotificationReplayRun(log, &config, &report), "replayed");
+    RZAssert(report.shown == 3 && report.expired == 3, "shown one after the other");
+    RZAssert(report.peakLiveCount == 1 && report.peakPendingCount == 2, "queued");
+    RZAssert(report.replayedDuration >= 3.0 && report.replayedDuration < 3.2, "three durations");
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testReusePool(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    append(log, RZNotificationEventShow, 0.0, 1, 0.0);
+    append(log, RZNotificationEventHide, 1.0, 1, 0.0);
+    append(log, RZNotificationEventShow, 2.0, 2, 0.0);
+    append(log, RZNotificationEventHide, 3.0, 2, 0.0);
+    // Shown again by the app
+    append(log, RZNotificationEventShow, 4.0, 2, 0.0);
+    append(log, RZNotificationEventShow, 5.0, 2, 0.0);
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    config.reusePoolSize = 1;
+    RZNotificationReplayReport report;
+    RZAssert(RZNotificationReplayRun(log, &config, &report), "replayed");
+    RZAssert(report.shown == 4 && report.expired == 0, "hidden by the app");
+    RZAssert(report.allocations == 1 && report.reuses == 3, "reused");
+    RZAssert(report.peakLiveCount == 1, "one at a time");
+    RZAssertEqualDouble(report.replayedDuration, 5.0, "last event");
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testRecordedExpiredHidesAreSkipped(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    append(log, RZNotificationEventShow, 0.0, 1, 1.0);
+    // Recorded late, the replay timer hides it at its own deadline
+    append(log, RZNotificationEventHide, 0.5, 1, 0.0);
+    RZNotificationEventLog *expired = RZNotificationEventLogCreate(NULL);
+    append(expired, RZNotificationEventShow, 0.0, 1, 1.0);
+    RZNotificationEvent event = RZNotificationEventLogEvents(log)[1];
+    event.flags = RZNotificationEventFlagExpired;
+    RZNotificationEventLogAppend(expired, &event);
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    RZNotificationReplayReport report;
+    RZNotificationReplayRun(log, &config, &report);
+    RZAssert(report.expired == 0, "hidden by the app");
+    RZNotificationReplayRun(expired, &config, &report);
+    RZAssert(report.expired == 1, "hidden by the timer");
+    RZAssert(report.latencies[RZNotificationEventHide].count == 1, "hide still measured");
+    RZNotificationEventLogDestroy(expired);
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testTouchPausesTimer(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    append(log, RZNotificationEventShow, 0.0, 1, 1.0);
+    append(log, RZNotificationEventTouch, 0.5, 1, 0.0);
+    append(log, RZNotificationEventHide, 5.0, 1, 0.0);
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    RZNotificationReplayReport report;
+    RZAssert(RZNotificationReplayRun(log, &config, &report), "replayed");
+    RZAssert(report.expired == 0, "kept under the finger");
+    RZAssertEqualDouble(report.replayedDuration, 5.0, "hidden by the app");
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testCoalescing(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    RZNotificationEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = RZNotificationEventShow;
+    event.container = 1;
+    event.coalescingKey = 42;
+    event.duration = 1.0;
+    event.width = 320.0;
+    for (int i = 0; i < 4; i++) {
+        event.timestamp = 0.5 * i;
+        event.notification = (uint64_t)(i + 1);
+        RZNotificationEventLogAppend(log, &event);
+    }
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    RZNotificationReplayReport report;
+    RZNotificationReplayRun(log, &config, &report);
+    RZAssert(report.shown == 4 && report.coalesced == 0, "not coalesced by default");
+
+    config.coalesce = 1;
+    RZAssert(RZNotificationReplayRun(log, &config, &report), "replayed");
+    RZAssert(report.shown == 1 && report.coalesced == 3 && report.expired == 1, "merged");
+    // Each merge keeps the visible notification for a full duration
+    RZAssert(report.replayedDuration >= 2.5 && report.replayedDuration < 2.6, "deadline pushed back");
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testRotationRelayouts(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    append(log, RZNotificationEventShow, 0.0, 1, 0.0);
+    append(log, RZNotificationEventShow, 0.0, 2, 0.0);
+    RZNotificationEvent rotate;
+    memset(&rotate, 0, sizeof(rotate));
+    rotate.type = RZNotificationEventRotate;
+    rotate.timestamp = 1.0;
+    rotate.container = 1;
+    rotate.width = 480.0;
+    rotate.height = 320.0;
+    RZNotificationEventLogAppend(log, &rotate);
+    // Unknown container
+    rotate.container = 2;
+    RZNotificationEventLogAppend(log, &rotate);
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    config.stack = 1;
+    RZNotificationReplayReport report;
+    RZAssert(RZNotificationReplayRun(log, &config, &report), "replayed");
+    RZAssert(report.layouts == 4, "shows and the rotation of the first container");
+    RZAssert(report.stackMoves >= 1, "second notification pushed down");
+    RZAssert(report.latencies[RZNotificationEventRotate].count == 2, "rotations measured");
+    RZNotificationEventLogDestroy(log);
+}
+
+static void testRealTime(void)
+{
+    RZNotificationEventLog *log = RZNotificationEventLogCreate(NULL);
+    append(log, RZNotificationEventShow, 0.0, 1, 0.05);
+    append(log, RZNotificationEventShow, 0.02, 2, 0.0);
+
+    RZNotificationReplayConfig config = RZNotificationReplayDefaultConfig();
+    config.realTime = 1;
+    RZNotificationReplayReport report;
+    RZAssert(RZNotificationReplayRun(log, &config, &report), "replayed");
+    RZAssert(report.expired == 1 && report.shown == 2, "same result as full speed");
+    RZAssert(report.wallDuration >= 0.05, "recorded pace");
+    RZNotificationEventLogDestroy(log);
+}
+
+int main(void)
+{
+    RZRunTest(testTimersExpireNotifications);
+    RZRunTest(testMaxVisibleQueuesShows);
+    RZRunTest(testReusePool);
+    RZRunTest(testRecordedExpiredHidesAreSkipped);
+    RZRunTest(testTouchPausesTimer);
+    RZRunTest(testCoalescing);
+    RZRunTest(testRotationRelayouts);
+    RZRunTest(testRealTime);
+    return RZTestFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+//
+//  RZNotificationRequestQueueTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationRequestQueue.h"
+#include "RZNotificationClock.h"
+#include "RZNotificationTestMacros.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define kProducerCount 4
+#define kRequestsPerProducer 100000
+#define kStressCapacity 64
+#define kStressTimeout 10.0
+
+#define RZRequest(value) ((void *)(uintptr_t)(value))
+
+typedef struct {
+    uintptr_t requests[16];
+    size_t count;
+} RZReceived;
+
+static void receive(void *request, void *context)
+{
+    RZReceived *received = context;
+    if (received->count < 16) {
+        received->requests[received->count] = (uintptr_t)request;
+    }
+    received->count++;
+}
+
+static void testPushAndDrainInOrder(void)
+{
+    RZNotificationRequestQueue *queue = RZNotificationRequestQueueCreate(8);
+    RZReceived received = { { 0 }, 0 };
+
+    RZAssert(RZNotificationRequestQueueIsEmpty(queue), "empty");
+    RZAssert(RZNotificationRequestQueuePush(queue, RZRequest(1)) == RZNotificationRequestQueuePushedWake, "first push wakes");
+    RZAssert(RZNotificationRequestQueuePush(queue, RZRequest(2)) == RZNotificationRequestQueuePushed, "already woken");
+    RZAssert(RZNotificationRequestQueuePush(queue, RZRequest(3)) == RZNotificationRequestQueuePushed, "already woken");
+    RZAssert(!RZNotificationRequestQueueIsEmpty(queue), "requests ready");
+
+    RZAssert(RZNotificationRequestQueueDrain(queue, 0, receive, &received) == 3, "all drained");
+    RZAssert(received.requests[0] == 1 && received.requests[1] == 2 && received.requests[2] == 3, "push order");
+    RZAssert(RZNotificationRequestQueueIsEmpty(queue), "empty again");
+
+    RZAssert(RZNotificationRequestQueuePush(queue, RZRequest(4)) == RZNotificationRequestQueuePushedWake, "wakes after a drain");
+    RZNotificationRequestQueueDestroy(queue);
+}
+
+static void testFullAndWrapAround(void)
+{
+    RZNotificationRequestQueue *queue = RZNotificationRequestQueueCreate(3);
+    RZReceived received = { { 0 }, 0 };
+
+    RZAssert(RZNotificationRequestQueueCapacity(queue) == 4, "rounded up to a power of 2");
+    for (uintptr_t i = 1; i <= 4; i++) {
+        RZAssert(RZNotificationRequestQueuePush(queue, RZRequest(i)) != RZNotificationRequestQueueFull, "room left");
+    }
+    RZAssert(RZNotificationRequestQueuePush(queue, RZRequest(5)) == RZNotificationRequestQueueFull, "full");
+
+    // Drain in two batches, then fill the slots a second time
+    RZAssert(RZNotificationRequestQueueDrain(queue, 3, receive, &received) == 3, "limited batch");
+    RZAssert(RZNotificationRequestQueuePush(queue, RZRequest(5)) == RZNotificationRequestQueuePushedWake, "room again");
+    RZAssert(RZNotificationRequestQueueDrain(queue, 0, receive, &received) == 2, "rest of the requests");
+    RZAssert(received.requests[3] == 4 && received.requests[4] == 5, "order kept across laps");
+
+    for (uintptr_t i = 6; i <= 9; i++) {
+        RZNotificationRequestQueuePush(queue, RZRequest(i));
+    }
+    RZAssert(RZNotificationRequestQueueDrain(queue, 0, receive, &received) == 4, "second lap");
+    RZAssert(received.count == 9 && received.requests[8] == 9, "everything received once");
+    RZNotificationRequestQueueDestroy(queue);
+}
+
+// MARK: - Stress
+
+typedef struct {
+    RZNotificationRequestQueue *queue;
+    uintptr_t producer;
+    _Atomic long *wakes;
+} RZProducer;
+
+typedef struct {
+    size_t next[kProducerCount];
+    size_t count;
+    int ordered;
+} RZStressReceived;
+
+static void *produce(void *argument)
+{
+    RZProducer *producer = argument;
+    for (uintptr_t sequence = 0; sequence < kRequestsPerProducer; sequence++) {
+        void *request = RZRequest(producer->producer * kRequestsPerProducer + sequence + 1);
+        RZNotificationRequestQueuePushResult result;
+        while ((result = RZNotificationRequestQueuePush(producer->queue, request)) == RZNotificationRequestQueueFull) {
+            sched_yield();
+        }
+        if (result == RZNotificationRequestQueuePushedWake) {
+            atomic_fetch_add(producer->wakes, 1);
+        }
+    }
+    return NULL;
+}
+
+static void receiveStress(void *request, void *context)
+{
+    RZStressReceived *received = context;
+    uintptr_t value = (uintptr_t)request - 1;
+    uintptr_t producer = value / kRequestsPerProducer;
+    if (producer >= kProducerCount || value % kRequestsPerProducer != received->next[producer]) {
+        received->ordered = 0;
+    }
+    else {
+        received->next[producer]++;
+    }
+    received->count++;
+}
+
+static void testConcurrentProducers(void)
+{
+    RZNotificationRequestQueue *queue = RZNotificationRequestQueueCreate(kStressCapacity);
+    _Atomic long wakes = 0;
+    RZProducer producers[kProducerCount];
+    pthread_t threads[kProducerCount];
+    RZStressReceived received = { { 0 }, 0, 1 };
+
+    for (uintptr_t i = 0; i < kProducerCount; i++) {
+        producers[i].queue = queue;
+        producers[i].producer = i;
+        producers[i].wakes = &wakes;
+        pthread_create(&threads[i], NULL, produce, &producers[i]);
+    }
+
+    // Like the main thread, only drain when a producer asked for it: a lost wake up stalls
+    long handledWakes = 0;
+    double lastProgress = RZNotificationMonotonicTime(NULL);
+    int stalled = 0;
+    while (received.count < kProducerCount * kRequestsPerProducer) {
+        long pendingWakes = atomic_load(&wakes);
+        if (pendingWakes == handledWakes) {
+            if (RZNotificationMonotonicTime(NULL) - lastProgress > kStressTimeout) {
+                stalled = 1;
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        handledWakes = pendingWakes;
+        if (RZNotificationRequestQueueDrain(queue, 0, receiveStress, &received) > 0) {
+            lastProgress = RZNotificationMonotonicTime(NULL);
+        }
+    }
+    RZAssert(!stalled, "no lost wake up");
+
+    for (int i = 0; i < kProducerCount; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    if (stalled) {
+        // Let the remaining requests go so that the counts below are meaningful
+        RZNotificationRequestQueueDrain(queue, 0, receiveStress, &received);
+    }
+
+    RZAssert(received.count == kProducerCount * kRequestsPerProducer, "every request received once");
+    RZAssert(received.ordered, "per producer order");
+    RZAssert(RZNotificationRequestQueueIsEmpty(queue), "nothing left");
+    RZAssert(atomic_load(&wakes) < kProducerCount * kRequestsPerProducer, "wake ups coalesced");
+    RZNotificationRequestQueueDestroy(queue);
+}
+
+int main(void)
+{
+    RZRunTest(testPushAndDrainInOrder);
+    RZRunTest(testFullAndWrapAround);
+    RZRunTest(testConcurrentProducers);
+    return RZTestFailures == 0 ? 0 : 1;
+}
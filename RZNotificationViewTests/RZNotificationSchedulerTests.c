@@ -0,0 +1,160 @@
+//
+//  RZNotificationSchedulerTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationScheduler.h"
+#include "RZNotificationTestMacros.h"
+
+static double fakeNow(void *context)
+{
+    return *(double *)context;
+}
+
+static RZNotificationSchedulerConfig configWithClock(double *now)
+{
+    RZNotificationSchedulerConfig config = RZNotificationSchedulerDefaultConfig();
+    config.clock.now = fakeNow;
+    config.clock.context = now;
+    return config;
+}
+
+static void testPriorityThenFifo(void)
+{
+    double now = 0.0;
+    RZNotificationSchedulerConfig config = configWithClock(&now);
+    RZNotificationScheduler *scheduler = RZNotificationSchedulerCreate(&config);
+    uint64_t low1, low2, high;
+    RZNotificationScheduledRequest request;
+
+    RZNotificationSchedulerSubmit(scheduler, 0, 0, &low1);
+    RZNotificationSchedulerSubmit(scheduler, 0, 0, &low2);
+    RZNotificationSchedulerSubmit(scheduler, 0, 5, &high);
+
+    RZAssert(RZNotificationSchedulerNext(scheduler, &request) && request.identifier == high, "highest priority first");
+    RZAssert(RZNotificationSchedulerNext(scheduler, &request) && request.identifier == low1, "then FIFO");
+    RZAssert(RZNotificationSchedulerNext(scheduler, &request) && request.identifier == low2, "then FIFO");
+    RZAssert(!RZNotificationSchedulerNext(scheduler, &request), "drained");
+    RZAssert(RZNotificationSchedulerVisibleCount(scheduler) == 3, "all visible");
+
+    RZNotificationSchedulerDestroy(scheduler);
+}
+
+static void testMaxVisible(void)
+{
+    double now = 0.0;
+    RZNotificationSchedulerConfig config = configWithClock(&now);
+    config.maxVisible = 2;
+    RZNotificationScheduler *scheduler = RZNotificationSchedulerCreate(&config);
+    RZNotificationScheduledRequest first, request;
+
+    for (int i = 0; i < 5; i++) {
+        RZNotificationSchedulerSubmit(scheduler, 0, 0, NULL);
+    }
+    RZAssert(RZNotificationSchedulerNext(scheduler, &first), "first slot");
+    RZAssert(RZNotificationSchedulerNext(scheduler, &request), "second slot");
+    RZAssert(!RZNotificationSchedulerNext(scheduler, &request), "no third slot");
+    RZAssert(RZNotificationSchedulerNextReadyDelay(scheduler) < 0.0, "waiting for a slot");
+
+    RZAssert(RZNotificationSchedulerDidHide(scheduler, first.identifier), "hide frees a slot");
+    RZAssert(!RZNotificationSchedulerDidHide(scheduler, first.identifier), "hide only once");
+    RZAssert(RZNotificationSchedulerNext(scheduler, &request), "slot reused");
+    RZAssert(RZNotificationSchedulerPendingCount(scheduler) == 2, "two left");
+
+    RZNotificationSchedulerDestroy(scheduler);
+}
+
+static void testCoalescing(void)
+{
+    double now = 0.0;
+    RZNotificationSchedulerConfig config = configWithClock(&now);
+    config.coalesce = 1;
+    config.maxVisible = 1;
+    RZNotificationScheduler *scheduler = RZNotificationSchedulerCreate(&config);
+    uint64_t a, b, c, other;
+    RZNotificationScheduledRequest request;
+
+    RZAssert(RZNotificationSchedulerSubmit(scheduler, 7, 0, &a) == RZNotificationScheduleQueued, "first queued");
+    RZAssert(RZNotificationSchedulerSubmit(scheduler, 7, 0, &b) == RZNotificationScheduleCoalescedPending && b == a, "merged while pending");
+    RZAssert(RZNotificationSchedulerSubmit(scheduler, 9, 0, &other) == RZNotificationScheduleQueued && other != a, "other key queued");
+    RZAssert(RZNotificationSchedulerPendingCount(scheduler) == 2, "two pending");
+
+    RZAssert(RZNotificationSchedulerNext(scheduler, &request) && request.identifier == a && request.repeatCount == 2, "shown with repeat count");
+    RZAssert(RZNotificationSchedulerSubmit(scheduler, 7, 0, &c) == RZNotificationScheduleCoalescedVisible && c == a, "merged while visible");
+    RZAssert(RZNotificationSchedulerRepeatCount(scheduler, a) == 3, "repeat count grows");
+
+    RZNotificationSchedulerDidHide(scheduler, a);
+    RZAssert(RZNotificationSchedulerSubmit(scheduler, 7, 0, &c) == RZNotificationScheduleQueued && c != a, "new request once hidden");
+    RZAssert(RZNotificationSchedulerSubmit(scheduler, 0, 0, NULL) == RZNotificationScheduleQueued
+             && RZNotificationSchedulerSubmit(scheduler, 0, 0, NULL) == RZNotificationScheduleQueued, "key 0 never merged");
+
+    RZNotificationSchedulerDestroy(scheduler);
+}
+
+static void testTokenBucket(void)
+{
+    double now = 100.0;
+    RZNotificationSchedulerConfig config = configWithClock(&now);
+    config.ratePerSecond = 2.0;
+    config.burst = 3.0;
+    RZNotificationScheduler *scheduler = RZNotificationSchedulerCreate(&config);
+    int shown = 0;
+
+    for (int i = 0; i < 30; i++) {
+        RZNotificationSchedulerSubmit(scheduler, 0, 0, NULL);
+    }
+    while (RZNotificationSchedulerNext(scheduler, NULL)) {
+        shown++;
+    }
+    RZAssert(shown == 3, "burst");
+    RZAssertEqualDouble(RZNotificationSchedulerNextReadyDelay(scheduler), 0.5, "one token every half second");
+
+    now += 0.25;
+    RZAssert(!RZNotificationSchedulerNext(scheduler, NULL), "not yet");
+    now += 0.25;
+    RZAssert(RZNotificationSchedulerNext(scheduler, NULL), "token refilled");
+
+    now += 60.0;
+    shown = 0;
+    while (RZNotificationSchedulerNext(scheduler, NULL)) {
+        shown++;
+    }
+    RZAssert(shown == 3, "bucket capped at burst");
+
+    RZNotificationSchedulerDestroy(scheduler);
+}
+
+static void testCancel(void)
+{
+    double now = 0.0;
+    RZNotificationSchedulerConfig config = configWithClock(&now);
+    config.coalesce = 1;
+    RZNotificationScheduler *scheduler = RZNotificationSchedulerCreate(&config);
+    uint64_t a, b, c;
+    RZNotificationScheduledRequest request;
+
+    RZNotificationSchedulerSubmit(scheduler, 1, 0, &a);
+    RZNotificationSchedulerSubmit(scheduler, 2, 3, &b);
+    RZNotificationSchedulerSubmit(scheduler, 3, 1, &c);
+
+    RZAssert(RZNotificationSchedulerCancel(scheduler, b), "cancel pending");
+    RZAssert(!RZNotificationSchedulerCancel(scheduler, b), "cancel once");
+    RZAssert(RZNotificationSchedulerNext(scheduler, &request) && request.identifier == c, "heap order kept");
+    RZAssert(!RZNotificationSchedulerCancel(scheduler, c), "visible can not be cancelled");
+    RZAssert(RZNotificationSchedulerSubmit(scheduler, 2, 0, NULL) == RZNotificationScheduleQueued, "cancelled key is free");
+
+    RZNotificationSchedulerDestroy(scheduler);
+}
+
+int main(void)
+{
+    RZRunTest(testPriorityThenFifo);
+    RZRunTest(testMaxVisible);
+    RZRunTest(testCoalescing);
+    RZRunTest(testTokenBucket);
+    RZRunTest(testCancel);
+    return RZTestFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+//
+//  RZNotificationStackTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationStack.h"
+#include "RZNotificationTestMacros.h"
+
+#define kSpacing 4.0
+
+static double offsetOf(const RZNotificationStack *stack, uint64_t item)
+{
+    double offset = -1.0;
+    RZNotificationStackOffset(stack, item, &offset);
+    return offset;
+}
+
+static void testInsertAtArbitraryIndices(void)
+{
+    RZNotificationStack *stack = RZNotificationStackCreate(kSpacing, 0);
+    RZNotificationStackChange changes[8];
+
+    RZAssert(RZNotificationStackInsert(stack, 1, 0, 50.0), "insert first");
+    RZAssert(RZNotificationStackInsert(stack, 2, 1, 60.0), "append");
+    RZAssert(RZNotificationStackInsert(stack, 3, 99, 70.0), "index clamped");
+    RZAssert(!RZNotificationStackInsert(stack, 2, 0, 10.0), "already stacked");
+    RZAssert(!RZNotificationStackInsert(stack, 0, 0, 10.0), "0 is not an item");
+
+    // 1 | 2 | 3
+    RZAssertEqualDouble(offsetOf(stack, 1), 0.0, "first against the edge");
+    RZAssertEqualDouble(offsetOf(stack, 2), 54.0, "after first and spacing");
+    RZAssertEqualDouble(offsetOf(stack, 3), 118.0, "after second and spacing");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 3, "all new");
+    RZAssert(changes[0].inserted && changes[1].inserted && changes[2].inserted, "reported as inserted");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 0, "nothing left");
+
+    // 1 | 4 | 2 | 3: only the items after the insertion move
+    RZAssert(RZNotificationStackInsert(stack, 4, 1, 20.0), "insert in the middle");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 3, "inserted and two moved");
+    RZAssert(changes[0].item == 4 && changes[0].inserted, "new item");
+    RZAssert(changes[1].item == 2 && !changes[1].inserted, "moved item");
+    RZAssertEqualDouble(changes[1].offset, 78.0, "pushed by the new item");
+    RZAssert(changes[2].item == 3, "last moved");
+    RZAssertEqualDouble(changes[2].offset, 142.0, "pushed by the new item");
+
+    // 5 | 1 | 4 | 2 | 3
+    RZAssert(RZNotificationStackInsert(stack, 5, 0, 10.0), "insert at the edge");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 5, "everything moved");
+    RZAssertEqualDouble(offsetOf(stack, 1), 14.0, "pushed");
+    RZAssertEqualDouble(offsetOf(stack, 3), 156.0, "pushed");
+
+    size_t index = 0;
+    RZAssert(RZNotificationStackIndex(stack, 2, &index) && index == 3, "stack order");
+    RZAssert(RZNotificationStackCount(stack) == 5, "five items");
+    RZNotificationStackDestroy(stack);
+}
+
+static void testRemoveAtArbitraryIndices(void)
+{
+    RZNotificationStack *stack = RZNotificationStackCreate(kSpacing, 0);
+    RZNotificationStackChange changes[8];
+
+    for (uint64_t item = 1; item <= 5; item++) {
+        RZNotificationStackInsert(stack, item, item, 10.0 * (double)item);
+    }
+    RZNotificationStackTakeChanges(stack, changes, 8);
+
+    // 1 | 2 | 4 | 5
+    RZAssert(RZNotificationStackRemove(stack, 3), "remove in the middle");
+    RZAssert(!RZNotificationStackRemove(stack, 3), "remove once");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 2, "only later items move");
+    RZAssert(changes[0].item == 4 && changes[1].item == 5, "later items");
+    RZAssertEqualDouble(changes[0].offset, 38.0, "pulled toward the edge");
+    RZAssertEqualDouble(changes[1].offset, 82.0, "pulled toward the edge");
+
+    // 1 | 2 | 4
+    RZAssert(RZNotificationStackRemove(stack, 5), "remove last");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 0, "nothing moves");
+
+    // 2 | 4
+    RZAssert(RZNotificationStackRemove(stack, 1), "remove first");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 2, "everything moves");
+    RZAssertEqualDouble(offsetOf(stack, 2), 0.0, "new edge item");
+    RZAssertEqualDouble(offsetOf(stack, 4), 24.0, "after it");
+    RZAssertEqualDouble(RZNotificationStackVisibleHeight(stack), 64.0, "stack height");
+
+    RZNotificationStackRemove(stack, 2);
+    RZNotificationStackRemove(stack, 4);
+    RZAssert(RZNotificationStackCount(stack) == 0, "empty");
+    RZAssertEqualDouble(RZNotificationStackVisibleHeight(stack), 0.0, "no height");
+    RZNotificationStackDestroy(stack);
+}
+
+static void testResize(void)
+{
+    RZNotificationStack *stack = RZNotificationStackCreate(kSpacing, 0);
+    RZNotificationStackChange changes[8];
+
+    RZNotificationStackInsert(stack, 1, 0, 50.0);
+    RZNotificationStackInsert(stack, 2, 1, 50.0);
+    RZNotificationStackInsert(stack, 3, 2, 50.0);
+    RZNotificationStackTakeChanges(stack, changes, 8);
+
+    RZAssert(RZNotificationStackResize(stack, 2, 80.0), "resize");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 1, "resized item does not move");
+    RZAssert(changes[0].item == 3, "next item moves");
+    RZAssertEqualDouble(changes[0].offset, 138.0, "pushed by the growth");
+
+    RZAssert(RZNotificationStackResize(stack, 2, 80.0), "same height");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 0, "nothing moves");
+    RZAssert(!RZNotificationStackResize(stack, 9, 10.0), "unknown item");
+
+    RZNotificationStackSetSpacing(stack, 0.0);
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 2, "spacing moves all but the first");
+    RZAssertEqualDouble(offsetOf(stack, 3), 130.0, "no spacing");
+    RZNotificationStackDestroy(stack);
+}
+
+static void testMaxVisible(void)
+{
+    RZNotificationStack *stack = RZNotificationStackCreate(kSpacing, 2);
+    RZNotificationStackChange changes[8];
+
+    RZNotificationStackInsert(stack, 1, 0, 10.0);
+    RZNotificationStackInsert(stack, 2, 0, 10.0);
+    RZNotificationStackInsert(stack, 3, 0, 10.0);
+
+    // 3 | 2 | 1
+    RZAssert(RZNotificationStackIsVisible(stack, 3) && RZNotificationStackIsVisible(stack, 2), "two visible");
+    RZAssert(!RZNotificationStackIsVisible(stack, 1), "pushed out");
+    RZAssertEqualDouble(RZNotificationStackVisibleHeight(stack), 24.0, "visible height");
+    RZNotificationStackTakeChanges(stack, changes, 8);
+
+    // 2 | 1
+    RZNotificationStackRemove(stack, 3);
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 2, "both move");
+    RZAssert(changes[1].item == 1 && changes[1].visible, "shown again");
+
+    RZNotificationStackSetMaxVisible(stack, 1);
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 8) == 1 && !changes[0].visible, "hidden by the new limit");
+    RZNotificationStackDestroy(stack);
+}
+
+static void testPartialTake(void)
+{
+    RZNotificationStack *stack = RZNotificationStackCreate(kSpacing, 0);
+    RZNotificationStackChange changes[2];
+
+    for (uint64_t item = 1; item <= 5; item++) {
+        RZNotificationStackInsert(stack, item, 0, 10.0);
+    }
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 2) == 5, "total count");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 2) == 3, "first two reported");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 2) == 1, "next two reported");
+    RZAssert(RZNotificationStackTakeChanges(stack, changes, 2) == 0, "all reported");
+    RZNotificationStackDestroy(stack);
+}
+
+int main(void)
+{
+    RZRunTest(testInsertAtArbitraryIndices);
+    RZRunTest(testRemoveAtArbitraryIndices);
+    RZRunTest(testResize);
+    RZRunTest(testMaxVisible);
+    RZRunTest(testPartialTake);
+    return RZTestFailures == 0 ? 0 : 1;
+}
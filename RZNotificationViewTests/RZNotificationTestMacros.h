@@ -0,0 +1,42 @@
+//
+//  RZNotificationTestMacros.h
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#ifndef RZNotificationViewTests_RZNotificationTestMacros_h
+#define RZNotificationViewTests_RZNotificationTestMacros_h
+
+/*
+ * Minimal assertions for the plain C tests run by ctest
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+static int RZTestFailures = 0;
+
+#define RZAssert(condition, message) do {                                             \
+    if (!(condition)) {                                                               \
+        fprintf(stderr, "%s:%d: %s (%s)\n", __FILE__, __LINE__, message, #condition); \
+        RZTestFailures++;                                                             \
+    }                                                                                 \
+} while (0)
+
+#define RZAssertEqualDouble(a, b, message) do {                                                    \
+    double rz_a = (a), rz_b = (b);                                                                 \
+    if (fabs(rz_a - rz_b) > 1e-9) {                                                                \
+        fprintf(stderr, "%s:%d: %s (%s = %g, %s = %g)\n", __FILE__, __LINE__, message, #a, rz_a, #b, rz_b); \
+        RZTestFailures++;                                                                          \
+    }                                                                                              \
+} while (0)
+
+#define RZRunTest(test) do {     \
+    int rz_before = RZTestFailures; \
+    test();                      \
+    printf("%s %s\n", rz_before == RZTestFailures ? "PASS" : "FAIL", #test); \
+} while (0)
+
+#endif
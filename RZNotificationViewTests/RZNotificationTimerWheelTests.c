@@ -0,0 +1,231 @@
+//
+//  RZNotificationTimerWheelTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationTimerWheel.h"
+#include "RZNotificationTestMacros.h"
+
+#define kResolution 0.125
+
+typedef struct {
+    uint64_t fired[64];
+    size_t count;
+    RZNotificationTimerWheel *wheel;
+    uint64_t cancelOnFire;
+} RZFiredTimers;
+
+static double fakeNow(void *context)
+{
+    return *(double *)context;
+}
+
+static RZNotificationTimerWheel *wheelWithClock(double *now, unsigned slotCount)
+{
+    RZNotificationClock clock = { fakeNow, now };
+    return RZNotificationTimerWheelCreate(&clock, kResolution, slotCount);
+}
+
+static void recordTimer(uint64_t identifier, void *context)
+{
+    RZFiredTimers *timers = context;
+    timers->fired[timers->count++] = identifier;
+    if (timers->cancelOnFire) {
+        RZNotificationTimerWheelCancel(timers->wheel, timers->cancelOnFire);
+    }
+}
+
+static void testFiresInDeadlineOrder(void)
+{
+    double now = 10.0;
+    RZNotificationTimerWheel *wheel = wheelWithClock(&now, 16);
+    RZFiredTimers timers = { .count = 0 };
+
+    uint64_t late = RZNotificationTimerWheelSchedule(wheel, 2.0);
+    uint64_t early = RZNotificationTimerWheelSchedule(wheel, 0.5);
+    uint64_t middle = RZNotificationTimerWheelSchedule(wheel, 1.0);
+    RZAssert(early && late && middle, "scheduled");
+    RZAssert(RZNotificationTimerWheelCount(wheel) == 3, "three timers");
+    RZAssertEqualDouble(RZNotificationTimerWheelNextDeadline(wheel), 10.5, "next deadline is the earliest");
+
+    now = 10.4;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 0, "never early");
+
+    now = 11.0;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 2, "two expired");
+    RZAssert(timers.fired[0] == early && timers.fired[1] == middle, "deadline order");
+    RZAssertEqualDouble(RZNotificationTimerWheelNextDeadline(wheel), 12.0, "late one left");
+
+    now = 20.0;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 1, "last one");
+    RZAssert(timers.fired[2] == late, "late fired");
+    RZAssert(RZNotificationTimerWheelCount(wheel) == 0, "empty");
+    RZAssert(RZNotificationTimerWheelNextDeadline(wheel) < 0.0, "no deadline");
+
+    RZNotificationTimerWheelDestroy(wheel);
+}
+
+static void testLongDelaysWrapAround(void)
+{
+    double now = 0.0;
+    // 8 slots of 1/8 s, one turn is a second
+    RZNotificationTimerWheel *wheel = wheelWithClock(&now, 8);
+    RZFiredTimers timers = { .count = 0 };
+
+    uint64_t far = RZNotificationTimerWheelSchedule(wheel, 5.0);
+    uint64_t near = RZNotificationTimerWheelSchedule(wheel, 0.25);
+    RZAssertEqualDouble(RZNotificationTimerWheelNextDeadline(wheel), 0.25, "near first");
+
+    now = 1.0;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 1 && timers.fired[0] == near, "only near");
+    RZAssertEqualDouble(RZNotificationTimerWheelNextDeadline(wheel), 5.0, "far deadline found beyond a turn");
+
+    now = 4.9;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 0, "far stays for later turns");
+    now = 5.0;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 1 && timers.fired[1] == far, "far fired");
+
+    RZNotificationTimerWheelDestroy(wheel);
+}
+
+static void testCancel(void)
+{
+    double now = 0.0;
+    RZNotificationTimerWheel *wheel = wheelWithClock(&now, 16);
+    RZFiredTimers timers = { .count = 0 };
+
+    uint64_t a = RZNotificationTimerWheelSchedule(wheel, 1.0);
+    uint64_t b = RZNotificationTimerWheelSchedule(wheel, 1.0);
+    RZAssert(RZNotificationTimerWheelCancel(wheel, a), "cancel");
+    RZAssert(!RZNotificationTimerWheelCancel(wheel, a), "cancel once");
+    RZAssert(RZNotificationTimerWheelRemaining(wheel, a) < 0.0, "unknown after cancel");
+
+    // The entry is recycled with a new identifier
+    uint64_t c = RZNotificationTimerWheelSchedule(wheel, 1.0);
+    RZAssert(c != a, "stale identifier not reused");
+    RZAssert(!RZNotificationTimerWheelCancel(wheel, a), "stale identifier rejected");
+
+    // Timers expiring in the same advance are collected first, cancelling one from a callback is too late
+    timers.wheel = wheel;
+    timers.cancelOnFire = c;
+    now = 2.0;
+    RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers);
+    RZAssert(timers.count == 2 && timers.fired[0] == b && timers.fired[1] == c, "both fired, in order");
+    RZAssert(RZNotificationTimerWheelCount(wheel) == 0, "empty");
+
+    RZNotificationTimerWheelDestroy(wheel);
+}
+
+static void testPauseTimer(void)
+{
+    double now = 0.0;
+    RZNotificationTimerWheel *wheel = wheelWithClock(&now, 16);
+    RZFiredTimers timers = { .count = 0 };
+
+    uint64_t touched = RZNotificationTimerWheelSchedule(wheel, 1.0);
+    now = 0.5;
+    RZAssert(RZNotificationTimerWheelPauseTimer(wheel, touched), "pause");
+    RZAssert(!RZNotificationTimerWheelPauseTimer(wheel, touched), "pause once");
+    RZAssertEqualDouble(RZNotificationTimerWheelRemaining(wheel, touched), 0.5, "remaining frozen");
+    RZAssert(RZNotificationTimerWheelNextDeadline(wheel) < 0.0, "paused timers have no deadline");
+
+    now = 3.0;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 0, "paused timer does not fire");
+    RZAssertEqualDouble(RZNotificationTimerWheelRemaining(wheel, touched), 0.5, "still frozen");
+
+    RZAssert(RZNotificationTimerWheelResumeTimer(wheel, touched), "resume");
+    RZAssertEqualDouble(RZNotificationTimerWheelNextDeadline(wheel), 3.5, "countdown restarted");
+    now = 3.5;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 1, "fired after the remaining time");
+
+    RZNotificationTimerWheelDestroy(wheel);
+}
+
+static void testPauseWheel(void)
+{
+    double now = 100.0;
+    RZNotificationTimerWheel *wheel = wheelWithClock(&now, 16);
+    RZFiredTimers timers = { .count = 0 };
+
+    uint64_t timer = RZNotificationTimerWheelSchedule(wheel, 2.0);
+    now = 101.0;
+    RZNotificationTimerWheelPause(wheel);
+    RZAssert(RZNotificationTimerWheelIsPaused(wheel), "paused");
+    RZAssert(RZNotificationTimerWheelNextDeadline(wheel) < 0.0, "no deadline while paused");
+
+    now = 160.0;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 0, "background time does not count");
+    RZAssertEqualDouble(RZNotificationTimerWheelRemaining(wheel, timer), 1.0, "remaining frozen");
+
+    RZNotificationTimerWheelResume(wheel);
+    RZAssertEqualDouble(RZNotificationTimerWheelNextDeadline(wheel), 161.0, "deadline shifted by the pause");
+    now = 160.9;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 0, "not yet");
+    now = 161.0;
+    RZAssert(RZNotificationTimerWheelAdvance(wheel, recordTimer, &timers) == 1, "fired");
+
+    RZNotificationTimerWheelDestroy(wheel);
+}
+
+static void testManyTimers(void)
+{
+    double now = 0.0;
+    RZNotificationTimerWheel *wheel = wheelWithClock(&now, 32);
+    uint64_t identifiers[1000];
+    size_t fired = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        identifiers[i] = RZNotificationTimerWheelSchedule(wheel, (i % 97) * 0.1);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        RZNotificationTimerWheelCancel(wheel, identifiers[i]);
+    }
+    RZAssert(RZNotificationTimerWheelCount(wheel) == 500, "half cancelled");
+
+    while (RZNotificationTimerWheelCount(wheel) > 0 && now < 20.0) {
+        now += 0.05;
+        fired += RZNotificationTimerWheelAdvance(wheel, NULL, NULL);
+    }
+    RZAssert(fired == 500, "every remaining timer fired once");
+
+    RZNotificationTimerWheelDestroy(wheel);
+}
+
+// A clock set to the next deadline fires its timers, whatever the rounding of the resolution
+static void testAdvanceToNextDeadline(void)
+{
+    double now = 0.0;
+    RZNotificationClock clock = { fakeNow, &now };
+    RZNotificationTimerWheel *wheel = RZNotificationTimerWheelCreate(&clock, 0.05, 64);
+    size_t fired = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        if (i == 500) {
+            // Paused time with no exact binary representation
+            RZNotificationTimerWheelPause(wheel);
+            now += 0.1;
+            RZNotificationTimerWheelResume(wheel);
+        }
+        RZAssert(RZNotificationTimerWheelSchedule(wheel, 0.01 * (i % 300)) != 0, "scheduled");
+        now = RZNotificationTimerWheelNextDeadline(wheel);
+        fired += RZNotificationTimerWheelAdvance(wheel, NULL, NULL);
+    }
+    RZAssert(fired == 1000, "fired at its deadline");
+
+    RZNotificationTimerWheelDestroy(wheel);
+}
+
+int main(void)
+{
+    RZRunTest(testFiresInDeadlineOrder);
+    RZRunTest(testLongDelaysWrapAround);
+    RZRunTest(testCancel);
+    RZRunTest(testPauseTimer);
+    RZRunTest(testPauseWheel);
+    RZRunTest(testManyTimers);
+    RZRunTest(testAdvanceToNextDeadline);
+    return RZTestFailures == 0 ? 0 : 1;
+}
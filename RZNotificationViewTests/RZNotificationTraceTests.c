@@ -0,0 +1,184 @@
+//
+//  RZNotificationTraceTests.c
+//  RZNotificationViewTests
+//
+//  Created by Rezzza on 17/10/26.
+//  Copyright (c) 2012 Rezzza. All rights reserved.
+//
+
+#include "RZNotificationTrace.h"
+#include "RZNotificationTestMacros.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kWriterCount 4
+#define kEventsPerWriter 20000
+
+static double fakeNow(void *context)
+{
+    return *(double *)context;
+}
+
+static void testDisabledRecordsNothing(void)
+{
+    double now = 1.0;
+    RZNotificationClock clock = { fakeNow, &now };
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceBufferCreate(16, &clock);
+    RZNotificationTraceRecord records[16];
+
+    RZAssert(RZNotificationTraceInstalledBuffer() == NULL, "nothing installed by default");
+    RZAssert(RZNotificationTraceBegin() < 0.0, "no start time");
+    RZNotificationTraceInstant(RZNotificationTraceEventCreated, 1);
+    RZNotificationTraceEnd(RZNotificationTraceEventDraw, 1, RZNotificationTraceBegin());
+
+    long draws = RZNotificationTraceCounterValue(RZNotificationTraceCounterDraws);
+    RZAssert(RZNotificationTraceCounterAdd(RZNotificationTraceCounterDraws, 1) == draws + 1, "counters still counted");
+    RZAssert(RZNotificationTraceBufferCopy(buffer, records, 16) == 0, "nothing recorded");
+
+    RZNotificationTraceResetCounters();
+    RZNotificationTraceBufferDestroy(buffer);
+}
+
+static void testRecordsLifecycle(void)
+{
+    double now = 2.0;
+    RZNotificationClock clock = { fakeNow, &now };
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceBufferCreate(16, &clock);
+    RZNotificationTraceRecord records[16];
+
+    RZAssert(RZNotificationTraceInstallBuffer(buffer) == NULL, "installed");
+    RZNotificationTraceInstant(RZNotificationTraceEventCreated, 42);
+    double begin = RZNotificationTraceBegin();
+    now = 2.25;
+    RZNotificationTraceEnd(RZNotificationTraceEventDraw, 42, begin);
+    RZNotificationTraceCounterAdd(RZNotificationTraceCounterLiveViews, 1);
+    RZNotificationTraceCounterAdd(RZNotificationTraceCounterLiveViews, -1);
+    RZAssert(RZNotificationTraceInstallBuffer(NULL) == buffer, "uninstalled");
+    RZNotificationTraceInstant(RZNotificationTraceEventRemoved, 42);
+
+    RZAssert(RZNotificationTraceBufferCopy(buffer, records, 16) == 4, "four events");
+    RZAssert(records[0].phase == RZNotificationTracePhaseInstant && records[0].event == RZNotificationTraceEventCreated, "instant");
+    RZAssert(records[0].notification == 42, "notification kept");
+    RZAssertEqualDouble(records[0].timestamp, 2.0, "instant time");
+    RZAssert(records[1].phase == RZNotificationTracePhaseInterval && records[1].event == RZNotificationTraceEventDraw, "interval");
+    RZAssertEqualDouble(records[1].timestamp, 2.0, "interval start");
+    RZAssertEqualDouble(records[1].duration, 0.25, "interval duration");
+    RZAssert(records[2].phase == RZNotificationTracePhaseCounter && records[2].value == 1, "counter up");
+    RZAssert(records[3].phase == RZNotificationTracePhaseCounter && records[3].value == 0, "counter down");
+
+    RZNotificationTraceBufferClear(buffer);
+    RZAssert(RZNotificationTraceBufferCopy(buffer, records, 16) == 0, "cleared");
+    RZNotificationTraceBufferDestroy(buffer);
+}
+
+static void testOverwritesOldest(void)
+{
+    double now = 0.0;
+    RZNotificationClock clock = { fakeNow, &now };
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceBufferCreate(16, &clock);
+    RZNotificationTraceRecord records[32];
+
+    for (uint64_t i = 1; i <= 40; i++) {
+        RZNotificationTraceRecord record = { RZNotificationTracePhaseInstant, RZNotificationTraceEventMeasured, (double)i, 0.0, i, 0 };
+        RZNotificationTraceBufferRecord(buffer, &record);
+    }
+
+    RZAssert(RZNotificationTraceBufferCopy(buffer, records, 32) == 16, "ring capacity");
+    RZAssert(records[0].notification == 25 && records[15].notification == 40, "newest kept, oldest first");
+    RZAssert(RZNotificationTraceBufferCopy(buffer, records, 4) == 4, "copy capacity respected");
+    RZNotificationTraceBufferDestroy(buffer);
+}
+
+static void testChromeJSON(void)
+{
+    double now = 0.5;
+    RZNotificationClock clock = { fakeNow, &now };
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceBufferCreate(16, &clock);
+    RZNotificationTraceRecord instant = { RZNotificationTracePhaseInstant, RZNotificationTraceEventHideRequested, 0.5, 0.0, 0xabc, 0 };
+    RZNotificationTraceRecord interval = { RZNotificationTracePhaseInterval, RZNotificationTraceEventIconRender, 0.5, 0.002, 0xabc, 0 };
+    RZNotificationTraceRecord counter = { RZNotificationTracePhaseCounter, RZNotificationTraceCounterLiveViews, 0.75, 0.0, 0, 3 };
+    RZNotificationTraceBufferRecord(buffer, &instant);
+    RZNotificationTraceBufferRecord(buffer, &interval);
+    RZNotificationTraceBufferRecord(buffer, &counter);
+
+    FILE *file = tmpfile();
+    RZAssert(file != NULL, "temporary file");
+    if (file == NULL) {
+        RZNotificationTraceBufferDestroy(buffer);
+        return;
+    }
+    RZAssert(RZNotificationTraceBufferWriteChromeJSON(buffer, file), "written");
+
+    char json[2048];
+    rewind(file);
+    size_t length = fread(json, 1, sizeof(json) - 1, file);
+    json[length] = '\0';
+    fclose(file);
+
+    RZAssert(strncmp(json, "{\"traceEvents\":[", 16) == 0, "trace object");
+    RZAssert(strstr(json, "\"name\":\"HideRequested\",\"cat\":\"lifecycle\",\"ph\":\"i\"") != NULL, "instant event");
+    RZAssert(strstr(json, "\"ts\":500000.000") != NULL, "microseconds");
+    RZAssert(strstr(json, "\"notification\":\"0xabc\"") != NULL, "notification id");
+    RZAssert(strstr(json, "\"name\":\"IconRender\",\"cat\":\"render\",\"ph\":\"X\",\"ts\":500000.000,\"dur\":2000.000") != NULL, "complete event");
+    RZAssert(strstr(json, "\"ph\":\"C\",\"ts\":750000.000,\"pid\":1,\"args\":{\"LiveViews\":3}") != NULL, "counter event");
+    RZAssert(strstr(json, "],\"displayTimeUnit\":\"ms\"}") != NULL, "closed");
+    RZNotificationTraceBufferDestroy(buffer);
+}
+
+static void *recordEvents(void *context)
+{
+    uint64_t writer = (uint64_t)(uintptr_t)context;
+    for (uint64_t i = 0; i < kEventsPerWriter; i++) {
+        // Writer in the high bits, sequence in the low bits
+        RZNotificationTraceInstant(RZNotificationTraceEventMeasured, writer << 32 | i);
+    }
+    return NULL;
+}
+
+static void testConcurrentWriters(void)
+{
+    RZNotificationTraceBuffer *buffer = RZNotificationTraceBufferCreate(kWriterCount * kEventsPerWriter, NULL);
+    pthread_t threads[kWriterCount];
+
+    RZNotificationTraceInstallBuffer(buffer);
+    for (uintptr_t writer = 0; writer < kWriterCount; writer++) {
+        pthread_create(&threads[writer], NULL, recordEvents, (void *)writer);
+    }
+    for (int writer = 0; writer < kWriterCount; writer++) {
+        pthread_join(threads[writer], NULL);
+    }
+    RZNotificationTraceInstallBuffer(NULL);
+
+    size_t capacity = kWriterCount * kEventsPerWriter;
+    RZNotificationTraceRecord *records = malloc(capacity * sizeof(RZNotificationTraceRecord));
+    RZAssert(RZNotificationTraceBufferCopy(buffer, records, capacity) == capacity, "no event lost");
+
+    // Each writer's events are all there, in its own order
+    uint64_t next[kWriterCount] = { 0 };
+    int ordered = 1;
+    for (size_t i = 0; i < capacity; i++) {
+        uint64_t writer = records[i].notification >> 32;
+        uint64_t sequence = records[i].notification & 0xFFFFFFFF;
+        if (writer >= kWriterCount || sequence != next[writer]) {
+            ordered = 0;
+            break;
+        }
+        next[writer]++;
+    }
+    RZAssert(ordered, "per writer order");
+
+    free(records);
+    RZNotificationTraceBufferDestroy(buffer);
+}
+
+int main(void)
+{
+    RZRunTest(testDisabledRecordsNothing);
+    RZRunTest(testRecordsLifecycle);
+    RZRunTest(testOverwritesOldest);
+    RZRunTest(testChromeJSON);
+    RZRunTest(testConcurrentWriters);
+    return RZTestFailures == 0 ? 0 : 1;
+}
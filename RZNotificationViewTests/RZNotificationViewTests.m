@@ -7,6 +7,7 @@
 //
 
 #import "RZNotificationViewTests.h"
+#import "RZNotificationView.h"
 
 @implementation RZNotificationViewTests
 
@@ -24,9 +25,40 @@
     [super tearDown];
 }
 
-- (void)testExample
+// Window contexts show each position in its own window, RZNotificationWindow is private
+- (void)assertNotification:(RZNotificationView*)notification inWindowAtPosition:(RZNotificationPosition)position
 {
-    STFail(@"Unit tests are not implemented yet in RZNotificationViewTests");
+    id container = [notification valueForKey:@"container"];
+    STAssertTrue([container isKindOfClass:NSClassFromString(@"RZNotificationWindow")], @"Shown in a notification window");
+    STAssertEquals([[container valueForKey:@"position"] integerValue], (NSInteger)position, @"Window of its position");
+    [notification hide];
+}
+
+- (void)testBottomNotificationLandsInBottomWindow
+{
+    RZNotificationView *notification = [RZNotificationView showNotificationOn:RZNotificationContextBelowStatusBar
+                                                                      message:@"Bottom"
+                                                                         icon:RZNotificationIconInfo
+                                                                       anchor:RZNotificationAnchorNone
+                                                                     position:RZNotificationPositionBottom
+                                                                        color:RZNotificationColorYellow
+                                                                   assetColor:RZNotificationContentColorDark
+                                                                    textColor:RZNotificationContentColorDark
+                                                               withCompletion:nil];
+    [self assertNotification:notification inWindowAtPosition:RZNotificationPositionBottom];
+}
+
+- (void)testStyledBottomNotificationLandsInBottomWindow
+{
+    RZNotificationStyle *style = [[RZNotificationStyle alloc] init];
+    style.position = RZNotificationPositionBottom;
+    [RZNotificationView registerStyle:style forIdentifier:@"bottom"];
+    
+    RZNotificationView *notification = [RZNotificationView showNotificationOn:RZNotificationContextAboveStatusBar
+                                                                      message:@"Bottom"
+                                                                        style:@"bottom"
+                                                               withCompletion:nil];
+    [self assertNotification:notification inWindowAtPosition:RZNotificationPositionBottom];
 }
 
 @end